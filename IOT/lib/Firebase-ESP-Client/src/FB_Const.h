@@ -118,7 +118,25 @@
 
 #define STREAM_TASK_STACK_SIZE 8192
 #define QUEUE_TASK_STACK_SIZE 8192
+#define TOKEN_RENEW_TASK_STACK_SIZE 8192
 #define MAX_BLOB_PAYLOAD_SIZE 1024
+// Error queue file, "FBQ2" magic, the records appended after the header before the file is compacted
+#define FIREBASE_ERROR_QUEUE_FILE_MAGIC 0x32514246
+#define FIREBASE_ERROR_QUEUE_HEADER_SIZE 12
+#define FIREBASE_ERROR_QUEUE_MAX_APPENDED 32
+#define FIREBASE_ERROR_QUEUE_RECORD_ITEM 'I'
+#define FIREBASE_ERROR_QUEUE_RECORD_TOMBSTONE 'T'
+// RTDB write batch, the number of writes and the time window (ms) before the batch is flushed
+#define FIREBASE_RTDB_BATCH_DEFAULT_SIZE 10
+#define FIREBASE_RTDB_BATCH_DEFAULT_WINDOW 1000
+// the base64 encoded chunk size (multiple of 4) that is written to the output at once
+#define FIREBASE_BASE64_CHUNK_SIZE 256
+// the default total size of the payloads in RTDB response cache
+#define FIREBASE_RTDB_CACHE_DEFAULT_BYTES 4096
+// the maximum queued requests and kept results of RTDB async pool
+#define FIREBASE_RTDB_ASYNC_DEFAULT_QUEUE 10
+// the maximum requests of RTDB async pool that are sent back to back through a connection
+#define FIREBASE_RTDB_ASYNC_MAX_PIPELINE 8
 #define FIREBASE_DEFAULT_TS 1618971013
 #define FIREBASE_NON_TS -1000
 #define ESP_REPORT_PROGRESS_INTERVAL 2
@@ -281,6 +299,30 @@ enum firebase_auth_token_type
     token_type_refresh_token
 };
 
+// the BearSSL RSA implementation used for signing the JWT token
+enum firebase_rsa_engine
+{
+    firebase_rsa_engine_auto,
+    firebase_rsa_engine_i15,
+    firebase_rsa_engine_i31,
+    firebase_rsa_engine_i32,
+    firebase_rsa_engine_i62,
+    firebase_rsa_engine_max
+};
+
+// The fixed implementation per architecture, the benchmark of firebase_rsa_engine_auto signs
+// with every implementation and blocks for seconds at the first signing on the 32-bit devices
+#if !defined(FIREBASE_DEFAULT_RSA_ENGINE)
+#if defined(ESP8266) || defined(MB_ARDUINO_PICO)
+// no 32x32 to 64 bits multiplication instruction
+#define FIREBASE_DEFAULT_RSA_ENGINE firebase_rsa_engine_i15
+#elif defined(__SIZEOF_INT128__)
+#define FIREBASE_DEFAULT_RSA_ENGINE firebase_rsa_engine_i62
+#else
+#define FIREBASE_DEFAULT_RSA_ENGINE firebase_rsa_engine_i31
+#endif
+#endif
+
 enum firebase_jwt_generation_step
 {
     firebase_jwt_generation_step_begin,
@@ -713,6 +755,30 @@ private:
     }
 };
 
+// the incomplete quantum of the base64 stream that is kept between the input pieces
+struct firebase_base64_stream_t
+{
+    // for encoder, the input bytes, for decoder, the 6-bit values
+    uint8_t pending[4];
+    uint8_t pendingLen = 0;
+    // the number of '=' in the last quantum, the decoder stops after the padding
+    uint8_t pad = 0;
+    bool error = false;
+};
+
+// the state of JSON array that is decoded element by element from the incoming pieces
+struct firebase_json_array_decoder_t
+{
+    // 0 for outside the array, 1 for the array level, 2 or more for inside the element
+    uint16_t depth = 0;
+    bool inString = false;
+    bool escape = false;
+    // the index of the current element
+    size_t index = 0;
+    // the text of the current element
+    MB_String element;
+};
+
 template <typename T>
 struct firebase_base64_io_t
 {
@@ -752,7 +818,12 @@ struct server_response_data_t
     // the available data to read in event-stream
     // and content length specific read in http response
     int contentLen = 0;
-    int chunkRange = 0;
+    // The last byte of range in Range header, -1 if no Range header
+    int chunkRange = -1;
+    // The complete object size in Content-Range header, -1 if no Content-Range header
+    int rangeTotal = -1;
+    // The base64 encoded CRC32C of the object in x-goog-hash header
+    MB_String crc32c;
     firebase_data_type dataType = firebase_data_type::d_any;
     int payloadOfs = 0;
     bool boolData = false;
@@ -780,10 +851,28 @@ struct server_response_data_t
     MB_String transferEnc;
 };
 
+enum firebase_chunk_state
+{
+    // reading the chunk size (hex digits)
+    firebase_chunk_state_size,
+    // skipping the chunk extension up to the end of size line
+    firebase_chunk_state_ext,
+    // reading the chunk data
+    firebase_chunk_state_data,
+    // skipping the CRLF after the chunk data
+    firebase_chunk_state_data_end,
+    // skipping the trailer fields after the last chunk
+    firebase_chunk_state_trailer,
+    // the last chunk and trailer were read
+    firebase_chunk_state_done
+};
+
 struct firebase_chunk_state_info
 {
-    int state = 0;
+    int state = firebase_chunk_state_size;
+    // the size of current chunk
     int chunkedSize = 0;
+    // the data read of current chunk or the length of trailer line
     int dataLen = 0;
 };
 
@@ -814,6 +903,8 @@ struct firebase_tcp_response_handler_t
     struct firebase_auth_token_error_t error;
     // keep the http header or the first line of stream event data
     MB_String header;
+    // the header line that was partially read
+    MB_String headerLine;
     // time out checking for execution
     unsigned long dataTime = 0;
     // pointer to payload
@@ -886,8 +977,41 @@ typedef struct firebase_rtdb_download_status_info_t
 
 } RTDB_DownloadStatusInfo;
 
+typedef struct firebase_rtdb_batch_result_info_t
+{
+    MB_String path;
+    bool success = false;
+    int httpCode = 0;
+    MB_String errorMsg;
+
+} RTDB_BatchResultInfo;
+
+enum firebase_rtdb_async_status
+{
+    firebase_rtdb_async_status_unknown,
+    firebase_rtdb_async_status_queued,
+    firebase_rtdb_async_status_sent,
+    firebase_rtdb_async_status_complete,
+    firebase_rtdb_async_status_error
+};
+
+typedef struct firebase_rtdb_async_result_info_t
+{
+    uint32_t id = 0;
+    firebase_rtdb_async_status status = firebase_rtdb_async_status_unknown;
+    MB_String path;
+    int httpCode = 0;
+    firebase_data_type dataType = d_any;
+    // the response data in JSON, for push, the push key (name)
+    MB_String data;
+    MB_String errorMsg;
+
+} RTDB_AsyncResultInfo;
+
 typedef void (*RTDB_UploadProgressCallback)(RTDB_UploadStatusInfo);
 typedef void (*RTDB_DownloadProgressCallback)(RTDB_DownloadStatusInfo);
+typedef void (*RTDB_BatchResultCallback)(RTDB_BatchResultInfo);
+typedef void (*RTDB_AsyncResultCallback)(RTDB_AsyncResultInfo);
 
 struct firebase_rtdb_request_info_t
 {
@@ -901,6 +1025,12 @@ struct firebase_rtdb_request_info_t
     firebase_rtdb_task_type task_type = firebase_rtdb_task_undefined;
     bool queue = false;
     bool async = false;
+    // send the request without waiting, the response is read later by the async pool
+    bool deferred = false;
+    // the ETag of cache entry that was sent with If-None-Match
+    MB_String revalidate_etag;
+    // the deferred request whose cached payload could not be read on 304, the pool sends it again
+    bool resend = false;
     size_t fileSize = 0;
 #if defined(FIREBASE_ESP_CLIENT)
     firebase_mem_storage_type storageType = mem_storage_type_undefined;
@@ -914,6 +1044,18 @@ struct firebase_rtdb_request_info_t
     RTDB_DownloadProgressCallback downloadCallback = NULL;
 };
 
+struct firebase_rtdb_async_request_t
+{
+    uint32_t id = 0;
+    // the index of connection that the request was sent or -1 for queued request
+    int8_t conn = -1;
+    unsigned long sentMillis = 0;
+    // the send order used for matching the pipelined responses
+    uint32_t seq = 0;
+    RTDB_AsyncResultCallback callback = NULL;
+    struct firebase_rtdb_request_info_t req;
+};
+
 #endif
 
 typedef struct firebase_spi_ethernet_module_t
@@ -944,6 +1086,8 @@ struct firebase_auth_token_info_t
     unsigned long expires = 0;
     /* milliseconds count when last expiry time was set */
     unsigned long last_millis = 0;
+    /* the token lifetime in seconds */
+    unsigned long lifetime = 0;
     firebase_auth_token_type token_type = token_type_undefined;
     firebase_auth_token_status status = token_status_uninitialized;
     struct firebase_auth_token_error_t error;
@@ -970,10 +1114,17 @@ struct firebase_auth_signin_user_t
     MB_String password;
 };
 
+namespace bssl
+{
+    class CertStoreBase;
+};
+
 struct firebase_auth_cert_t
 {
     const char *data = NULL;
     MB_String file;
+    // the issuer lookup store e.g. bssl::TrustAnchorStore (ESP32), takes precedence over data and file
+    bssl::CertStoreBase *store = nullptr;
 #if defined(FIREBASE_ESP_CLIENT)
     firebase_mem_storage_type file_storage = mem_storage_type_flash;
 #else
@@ -1016,6 +1167,12 @@ struct firebase_token_signer_resources_t
     /* last token request milliseconds count */
     unsigned long lastReqMillis = 0;
     unsigned long preRefreshSeconds = DEFAULT_AUTH_TOKEN_PRE_REFRESH_SECONDS;
+    /* the fraction of the token lifetime (0.0 - 1.0) after which the token is renewed in the background,
+    0 to refresh the token when preRefreshSeconds before expiry */
+    float refreshRatio = 0;
+    /* the Max Fragment Length (512, 1024, 2048 or 4096) to negotiate with the token server, 0 to disable,
+    see FirebaseData::setAutoMFLN */
+    uint16_t mflnSize = 0;
     unsigned long expiredSeconds = DEFAULT_AUTH_TOKEN_EXPIRED_SECONDS;
     /* request time out period (interval) */
     unsigned long reqTO = DEFAULT_REQUEST_TIMEOUT;
@@ -1023,6 +1180,9 @@ struct firebase_token_signer_resources_t
     MB_String pk;
     size_t hashSize = 32; // SHA256 size (256 bits or 32 bytes)
     size_t signatureSize = 256;
+    /* the RSA implementation for JWT signing, firebase_rsa_engine_auto to benchmark all of them at the first signing
+    and use the fastest one */
+    firebase_rsa_engine rsaEngine = FIREBASE_DEFAULT_RSA_ENGINE;
     char *hash = nullptr;
     unsigned char *signature = nullptr;
     MB_String encHeader;
@@ -1060,6 +1220,78 @@ struct firebase_stream_info_t
     size_t max_payload_length = 0;
     int httpCode = 0;
 };
+
+// The node of multiple paths stream subscription trie, one node per path segment
+struct firebase_stream_path_node_t
+{
+    MB_String name;
+    // the subscribed child path, when sub is not -1
+    MB_String path;
+    // index of the first child and the next sibling node, -1 if none
+    int child = -1;
+    int next = -1;
+    // index of the subscriber callback, -1 if no subscriber at this node
+    int sub = -1;
+};
+
+enum firebase_stream_coalesce_mode
+{
+    // queue every event
+    firebase_stream_coalesce_none,
+    // the put event replaces the queued put and patch events of the same path, the patch events are all kept
+    firebase_stream_coalesce_keep_latest,
+    // as keep latest, and the JSON of patch event is applied to the queued put or patch event of the same path
+    firebase_stream_coalesce_merge_patch
+};
+
+struct firebase_stream_event_t
+{
+    firebase_data_type data_type = firebase_data_type::d_any;
+    MB_String event_type;
+    MB_String path;
+    MB_String data;
+    MB_VECTOR<uint8_t> blob;
+};
+
+struct firebase_stream_queue_info_t
+{
+    // 0 for no queue, the callback will be called while reading the stream
+    uint8_t max_size = 0;
+    // the maximum events sent to callback per stream loop
+    uint8_t dispatch_count = 1;
+    firebase_stream_coalesce_mode mode = firebase_stream_coalesce_none;
+    uint32_t dropped = 0;
+    uint32_t coalesced = 0;
+    MB_VECTOR<firebase_stream_event_t> events;
+};
+
+struct firebase_rtdb_cache_entry_t
+{
+    MB_String path;
+    MB_String etag;
+    // the response payload, it is kept in file instead when the cache storage is flash or SD
+    MB_String payload;
+    firebase_data_type data_type = d_any;
+    size_t size = 0;
+    uint16_t file_id = 0;
+};
+
+struct firebase_rtdb_cache_info_t
+{
+    // 0 for no response cache
+    uint8_t max_entries = 0;
+    size_t max_bytes = 0;
+    size_t bytes = 0;
+    firebase_mem_storage_type storage_type = mem_storage_type_undefined;
+    uint16_t next_file_id = 0;
+    // the index of entry that the current request is revalidated, -1 for none
+    int revalidate = -1;
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t saved_bytes = 0;
+    // the least recently used entry is the first
+    MB_VECTOR<firebase_rtdb_cache_entry_t> entries;
+};
 #endif
 
 struct firebase_session_info
@@ -1068,6 +1300,32 @@ struct firebase_session_info
     bool status = false;
 };
 
+// The lock of the data that is shared by the loop and the FreeRTOS tasks,
+// it is created statically, it can be taken before any task was started
+struct firebase_mutex_t
+{
+#if defined(ESP32)
+    StaticSemaphore_t buf;
+    SemaphoreHandle_t handle = NULL;
+    firebase_mutex_t() { handle = xSemaphoreCreateMutexStatic(&buf); }
+    void lock() { xSemaphoreTake(handle, portMAX_DELAY); }
+    void unlock() { xSemaphoreGive(handle); }
+#else
+    void lock() {}
+    void unlock() {}
+#endif
+};
+
+// The result of the Max Fragment Length probe of the host
+struct firebase_mfln_host_t
+{
+    MB_String host;
+    uint16_t port = 0;
+    // the fragment length that was probed
+    uint16_t probed = 0;
+    bool supported = false;
+};
+
 struct firebase_cfg_int_t
 {
     enum base_time_type_t
@@ -1100,6 +1358,10 @@ struct firebase_cfg_int_t
     bool fb_auth_uri = false;
     MB_VECTOR<firebase_session_info> sessions;
     MB_VECTOR<firebase_session_info> queueSessions;
+    // the MFLN support of the hosts that were probed
+    MB_VECTOR<firebase_mfln_host_t> mfln_hosts;
+    // taken by the clients of the sessions, stream and token tasks to access mfln_hosts
+    firebase_mutex_t mfln_hosts_mutex;
 
     MB_String auth_token;
     MB_String refresh_token;
@@ -1108,6 +1370,23 @@ struct firebase_cfg_int_t
     uint16_t rtok_len = 0;
     uint16_t atok_len = 0;
     uint16_t ltok_len = 0;
+
+    // the token that was renewed in the background and waits for the swap,
+    // the replaced token is kept here until the next renewal for the requests that are still sending it
+    MB_String renewed_auth_token;
+    MB_String renewed_refresh_token;
+    unsigned long renewed_lifetime = 0;
+    unsigned long renewed_millis = 0;
+    volatile bool fb_token_renewed = false;
+    volatile bool fb_token_renewing = false;
+    unsigned long fb_last_token_renew_millis = 0;
+    // the number of requests that were stalled by the token refresh
+    uint32_t fb_token_refresh_stalls = 0;
+
+    // the RSA implementation that was selected for JWT signing
+    firebase_rsa_engine rsa_engine = firebase_rsa_engine_auto;
+    // the JWT signing time in microseconds of each RSA implementation, 0 for unmeasured or unavailable
+    uint32_t rsa_sign_us[firebase_rsa_engine_max] = {0};
     uint16_t email_crc = 0, password_crc = 0, client_email_crc = 0, project_id_crc = 0, priv_key_crc = 0, uid_crc = 0;
 
     bool stream_loop_task_enable = true;
@@ -1122,6 +1401,13 @@ struct firebase_cfg_int_t
 
     TaskHandle_t stream_task_handle = NULL;
     TaskHandle_t queue_task_handle = NULL;
+    TaskHandle_t token_renew_task_handle = NULL;
+    // the task that runs Firebase.ready(), the only task that swaps the renewed token
+    TaskHandle_t token_owner_task_handle = NULL;
+#endif
+#if defined(ESP32)
+    // taken by the token renewal task and the token swap
+    SemaphoreHandle_t token_renew_mutex = NULL;
 #endif
     size_t stream_task_stack_size = STREAM_TASK_STACK_SIZE;
     uint8_t stream_task_priority = 3;
@@ -1151,6 +1437,22 @@ struct firebase_rtdb_config_t
     // size_t download_buffer_size = 256;
 };
 
+// The progress of the download that was requested in ranges
+struct firebase_download_range_t
+{
+    // the bytes that were written and the object size, 0 for unknown
+    size_t offset = 0;
+    size_t total = 0;
+    // the CRC32C of the written bytes and the base64 encoded CRC32C of the object
+    uint32_t crc = 0;
+    MB_String crc32c;
+    MB_String etag;
+    // the firmware update was started
+    bool started = false;
+    // the object was changed since the previous range
+    bool changed = false;
+};
+
 struct firebase_url_info_t
 {
     MB_String host;
@@ -1170,7 +1472,17 @@ typedef struct firebase_cfs_upload_status_info_t
 
 } CFS_UploadStatusInfo;
 
+typedef struct firebase_cfs_result_info_t
+{
+    // the index of the result in the response array
+    size_t index = 0;
+    // the JSON text of the result e.g. {"found":{...},"readTime":"..."} or {"document":{...},"readTime":"..."}
+    const char *data = "";
+
+} CFS_ResultInfo;
+
 typedef void (*CFS_UploadProgressCallback)(CFS_UploadStatusInfo);
+typedef void (*CFS_ResultCallback)(CFS_ResultInfo);
 
 struct firebase_cfs_config_t
 {
@@ -1198,6 +1510,17 @@ struct firebase_gcs_config_t
 {
     size_t upload_buffer_size = 2048;
     size_t download_buffer_size = 2048;
+    // the size of each download range request, 0 for the rest of the object in one request
+    size_t download_range_size = 0;
+    // the number of times that the interrupted download continues from the received offset
+    uint8_t download_max_resume = 5;
+    // the upper limit of the adaptive resumable upload chunk, rounded down to a multiple of 256 KiB
+    size_t resumable_max_chunk_size = 8 * 1024 * 1024;
+    // the number of resumable uploads (on different FirebaseData objects) that send their chunks at once, 1 or 2
+    uint8_t resumable_upload_connections = 1;
+    // the file that keeps the session URI and offset of the unfinished resumable uploads, empty to disable
+    MB_String resumable_state_file;
+    firebase_mem_storage_type resumable_state_storage_type = mem_storage_type_flash;
 };
 
 typedef struct firebase_gcs_upload_status_info_t
@@ -1244,6 +1567,10 @@ struct firebase_fcs_config_t
 {
     size_t upload_buffer_size = 2048;
     size_t download_buffer_size = 2048;
+    // the size of each download range request, 0 for the rest of the object in one request
+    size_t download_range_size = 0;
+    // the number of times that the interrupted download continues from the received offset
+    uint8_t download_max_resume = 5;
 };
 
 typedef struct firebase_fcs_upload_status_info_t
@@ -1428,6 +1755,8 @@ struct firebase_rtdb_info_t
     size_t file_size = 0;
 
     struct firebase_stream_info_t stream;
+    struct firebase_stream_queue_info_t stream_queue;
+    struct firebase_rtdb_cache_info_t cache;
 
 #if defined(ESP32) || defined(MB_ARDUINO_PICO)
     bool stream_loop_task_enable = false;
@@ -1626,7 +1955,19 @@ struct firebase_gcs_req_t
     int chunkRange = -1;
     int chunkPos = 0;
     int chunkLen = 0;
+    // the adaptive resumable upload chunk size and the link measures it was derived from
+    uint32_t chunkSize = 0;
+    uint32_t rate = 0; // bytes per second
+    uint32_t rtt = 0;  // ms from the last chunk byte sent to the server response
+    unsigned long sendMs = 0;
+    bool queryStatus = false;
+    bool deferResponse = false;
+    bool chunkPending = false;
+    // the upload session URI was not found or expired (404 or 410)
+    bool sessionExpired = false;
     size_t fileSize = 0;
+    // the CRC32C of the local file that is saved with the resume state
+    uint32_t fileCrc = 0;
     int progress = -1;
     ListOptions *listOptions = nullptr;
     StorageGetOptions *getOptions = nullptr;
@@ -1639,13 +1980,24 @@ struct firebase_gcs_req_t
     DownloadStatusInfo *downloadStatusInfo = nullptr;
     UploadProgressCallback uploadCallback = NULL;
     DownloadProgressCallback downloadCallback = NULL;
+    struct firebase_download_range_t range;
 };
 
 struct fb_gcs_upload_resumable_task_info_t
 {
     FirebaseData *fbdo = nullptr;
     struct firebase_gcs_req_t req;
-    bool done = false;
+};
+
+struct fb_gcs_upload_resume_state_t
+{
+    MB_String localFileName;
+    MB_String remoteFileName;
+    MB_String location;
+    size_t fileSize = 0;
+    // the CRC32C of the local file, the changed file is not continued
+    uint32_t crc32c = 0;
+    size_t offset = 0;
 };
 
 #endif
@@ -1815,6 +2167,16 @@ struct firebase_fcm_http_v1_message_info_t
     struct firebase_fcm_http_v1_webpush_config_t webpush;
 };
 
+struct firebase_fcm_http_v1_result_t
+{
+    // the HTTP status code or the negative TCP error code, 0 for not sent
+    int code = 0;
+    // the message ID e.g. projects/{project_id}/messages/{message_id}
+    MB_String name;
+    // the FCM error code e.g. UNREGISTERED, or the error status e.g. INVALID_ARGUMENT
+    MB_String error;
+};
+
 struct firebase_fcm_info_t
 {
     MB_String payload;
@@ -1857,6 +2219,7 @@ struct firebase_fcs_req_t
     FCS_DownloadStatusInfo *downloadStatusInfo = nullptr;
     FCS_UploadProgressCallback uploadCallback = NULL;
     FCS_DownloadProgressCallback downloadCallback = NULL;
+    struct firebase_download_range_t range;
 };
 
 #endif
@@ -1887,6 +2250,14 @@ typedef struct firebase_firestore_transaction_options_t
     firebase_firestore_transaction_read_write_option_t readWrite;
 } TransactionOptions;
 
+// the page of documents that was decoded from the list documents response
+struct firebase_firestore_page_t
+{
+    MB_VECTOR<MB_String> documents;
+    // the text outside the documents array which contains the nextPageToken
+    MB_String outer;
+};
+
 struct firebase_firestore_req_t
 {
     MB_String projectId;
@@ -1897,6 +2268,8 @@ struct firebase_firestore_req_t
     MB_String mask;
     MB_String updateMask;
     MB_String payload;
+    // JSON payload that is serialized directly to the socket instead of payload string
+    FirebaseJson *json = nullptr;
     MB_String exists;
     MB_String updateTime;
     MB_String readTime;
@@ -1911,6 +2284,11 @@ struct firebase_firestore_req_t
     CFS_UploadStatusInfo *uploadStatusInfo = nullptr;
     CFS_UploadProgressCallback uploadCallback = NULL;
     FB_ResponseCallback responseCallback = NULL;
+    CFS_ResultCallback resultCallback = NULL;
+    // the decoded documents are kept in the page instead of the payload
+    struct firebase_firestore_page_t *page = nullptr;
+    // the response will be read later
+    bool deferred = false;
     int progress = -1;
     unsigned long requestTime = 0;
 };
@@ -1999,11 +2377,16 @@ struct firebase_session_info_t
 
     uint16_t bssl_rx_size = 2048;
     uint16_t bssl_tx_size = 512;
+    // esp_ssl_cipher_profile
+    uint8_t cipher_profile = 0;
+    // the fragment length to negotiate, 0 for disabled
+    uint16_t mfln_size = 0;
 };
 
 #if defined(ENABLE_FCM) || defined(FIREBASE_ENABLE_FCM)
 typedef struct firebase_fcm_legacy_http_message_info_t FCM_Legacy_HTTP_Message;
 typedef struct firebase_fcm_http_v1_message_info_t FCM_HTTPv1_JSON_Message;
+typedef struct firebase_fcm_http_v1_result_t FCM_HTTPv1_Result;
 #endif
 
 #if defined(ENABLE_FB_STORAGE) || defined(FIREBASE_ENABLE_FB_STORAGE)
@@ -2095,6 +2478,12 @@ static const char firebase_pgm_str_67[] PROGMEM = "data";
 static const char firebase_pgm_str_68[] PROGMEM = "update";
 static const char firebase_pgm_str_69[] PROGMEM = "delete";
 static const char firebase_pgm_str_70[] PROGMEM = "updateMask";
+static const char firebase_pgm_str_71[] PROGMEM = "Range: ";
+static const char firebase_pgm_str_72[] PROGMEM = "Content-Range: ";
+static const char firebase_pgm_str_73[] PROGMEM = "x-goog-hash: ";
+static const char firebase_pgm_str_74[] PROGMEM = "crc32c=";
+static const char firebase_pgm_str_75[] PROGMEM = "bytes=";
+static const char firebase_pgm_str_76[] PROGMEM = ".dlstate";
 
 // Legacy FCM string
 #if defined(FIREBASE_ESP32_CLIENT) || defined(FIREBASE_ESP8266_CLIENT)
@@ -2224,6 +2613,11 @@ static const char firebase_rtdb_pgm_str_37[] PROGMEM = "Keep-Alive: timeout=30,
 static const char firebase_rtdb_pgm_str_38[] PROGMEM = "Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n";
 static const char firebase_rtdb_pgm_str_39[] PROGMEM = "{\".sv\": \"timestamp\"}";
 static const char firebase_rtdb_pgm_str_40[] PROGMEM = "object";
+static const char firebase_rtdb_pgm_str_41[] PROGMEM = ".sv";
+static const char firebase_rtdb_pgm_str_42[] PROGMEM = "If-None-Match: ";
+static const char firebase_rtdb_pgm_str_43[] PROGMEM = "/fb_rc_";
+static const char firebase_rtdb_pgm_str_44[] PROGMEM = ".tmp";
+static const char firebase_rtdb_pgm_str_45[] PROGMEM = "close";
 #endif
 
 // FCM class string
@@ -2301,6 +2695,9 @@ static const char firebase_fcm_pgm_str_68[] PROGMEM = "message";
 static const char firebase_fcm_pgm_str_69[] PROGMEM = "android";
 static const char firebase_fcm_pgm_str_70[] PROGMEM = "webpush";
 static const char firebase_fcm_pgm_str_71[] PROGMEM = "apns";
+static const char firebase_fcm_pgm_str_72[] PROGMEM = "error/status";
+static const char firebase_fcm_pgm_str_73[] PROGMEM = "error/details/[0]/errorCode";
+static const char firebase_fcm_pgm_str_74[] PROGMEM = "close";
 #endif
 
 // Firestore class string
@@ -2360,6 +2757,7 @@ static const char firebase_cfs_pgm_str_52[] PROGMEM = "/collectionGroups/";
 static const char firebase_cfs_pgm_str_53[] PROGMEM = "/indexes";
 static const char firebase_cfs_pgm_str_54[] PROGMEM = "filter";
 static const char firebase_cfs_pgm_str_55[] PROGMEM = "firestore.";
+static const char firebase_cfs_pgm_str_56[] PROGMEM = "\"nextPageToken\"";
 #endif
 
 // Firebase Storage class string
@@ -2417,6 +2815,7 @@ static const char firebase_gcs_pgm_str_45[] PROGMEM = "startOffset=";
 static const char firebase_gcs_pgm_str_46[] PROGMEM = "versions=";
 static const char firebase_gcs_pgm_str_47[] PROGMEM = "resumableUploadTask";
 static const char firebase_gcs_pgm_str_48[] PROGMEM = "Range: bytes=0-";
+static const char firebase_gcs_pgm_str_49[] PROGMEM = "*/";
 #endif
 
 // Firebase Functions class string
@@ -2625,6 +3024,7 @@ static const char firebase_storage_err_pgm_str_3[] PROGMEM = "SD Storage is not
 static const char firebase_storage_err_pgm_str_4[] PROGMEM = "file is still opened.";
 static const char firebase_storage_err_pgm_str_5[] PROGMEM = "file not found.";
 #endif
+static const char firebase_storage_err_pgm_str_6[] PROGMEM = "downloaded data does not match the object checksum";
 
 // Mem error string
 static const char firebase_mem_err_pgm_str_1[] PROGMEM = "data buffer overflow";
@@ -2661,5 +3061,8 @@ static const char firebase_functions_err_pgm_str_1[] PROGMEM = "missing autozip
 
 static const char firebase_boundary_table[] PROGMEM = "=_abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 static const unsigned char firebase_base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+// CRC32C (Castagnoli, reflected) of each 4-bit value
+static const uint32_t firebase_crc32c_table[16] = {0x00000000, 0x105ec76f, 0x20bd8ede, 0x30e349b1, 0x417b1dbc, 0x5125dad3, 0x61c69362, 0x7198540d,
+                                                   0x82f63b78, 0x92a8fc17, 0xa24bb5a6, 0xb21572c9, 0xc38d26c4, 0xd3d3e1ab, 0xe330a81a, 0xf36e6f75};
 
 #endif
\ No newline at end of file
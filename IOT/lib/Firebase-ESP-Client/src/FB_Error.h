@@ -35,8 +35,10 @@
 #define FIREBASE_ERROR_HTTP_CODE_OK 200
 #define FIREBASE_ERROR_HTTP_CODE_NON_AUTHORITATIVE_INFORMATION 203
 #define FIREBASE_ERROR_HTTP_CODE_NO_CONTENT 204
+#define FIREBASE_ERROR_HTTP_CODE_PARTIAL_CONTENT 206
 #define FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY 301
 #define FIREBASE_ERROR_HTTP_CODE_FOUND 302
+#define FIREBASE_ERROR_HTTP_CODE_NOT_MODIFIED 304
 #define FIREBASE_ERROR_HTTP_CODE_USE_PROXY 305
 #define FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT 307
 #define FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT 308
@@ -48,6 +50,7 @@
 #define FIREBASE_ERROR_HTTP_CODE_NOT_ACCEPTABLE 406
 #define FIREBASE_ERROR_HTTP_CODE_PROXY_AUTHENTICATION_REQUIRED 407
 #define FIREBASE_ERROR_HTTP_CODE_REQUEST_TIMEOUT 408
+#define FIREBASE_ERROR_HTTP_CODE_GONE 410
 #define FIREBASE_ERROR_HTTP_CODE_LENGTH_REQUIRED 411
 #define FIREBASE_ERROR_HTTP_CODE_PRECONDITION_FAILED 412
 #define FIREBASE_ERROR_HTTP_CODE_PAYLOAD_TOO_LARGE 413
@@ -106,5 +109,6 @@
 #define FIREBASE_ERROR_USER_TIME_SETTING_REQUIRED /*          */ (FB_ERROR_RANGE - 38)
 #define FIREBASE_ERROR_SYS_TIME_IS_NOT_READY /*          */ (FB_ERROR_RANGE - 39)
 #define FIREBASE_ERROR_USER_PAUSE /*          */ (FB_ERROR_RANGE - 40)
+#define FIREBASE_ERROR_DOWNLOAD_CHECKSUM_MISMATCH /*          */ (FB_ERROR_RANGE - 41)
 
 #endif
\ No newline at end of file
@@ -618,6 +618,97 @@ public:
         if (arr)
             arr->clear();
     }
+
+    /* Append the C string as JSON string (quoted and escaped) */
+    void appendQuoted(MB_String &out, const char *s)
+    {
+        MB_JSON *str = MB_JSON_CreateString(s);
+        if (!str)
+            return;
+
+        char *quoted = MB_JSON_PrintUnformatted(str);
+        if (quoted)
+        {
+            out += quoted;
+            MB_JSON_free(quoted);
+        }
+
+        MB_JSON_Delete(str);
+    }
+
+    /* Read the JSON array text from pos until the element is complete, the element text is in decoder.element,
+    the text outside the array is appended to outer if assigned */
+    bool readArrayElement(firebase_json_array_decoder_t &decoder, const char *buf, size_t len, size_t &pos,
+                          MB_String *outer = nullptr)
+    {
+        while (pos < len)
+        {
+            char c = buf[pos++];
+
+            // skip until the beginning of array
+            if (decoder.depth == 0)
+            {
+                if (c == '[')
+                    decoder.depth = 1;
+                else if (outer)
+                    *outer += c;
+                continue;
+            }
+
+            if (decoder.inString)
+            {
+                decoder.element += c;
+                if (decoder.escape)
+                    decoder.escape = false;
+                else if (c == '\\')
+                    decoder.escape = true;
+                else if (c == '"')
+                {
+                    decoder.inString = false;
+                    // the string element
+                    if (decoder.depth == 1)
+                        return true;
+                }
+                continue;
+            }
+
+            bool space = c == ' ' || c == '\r' || c == '\n' || c == '\t';
+
+            if (decoder.depth == 1)
+            {
+                // the number, boolean or null element is ended
+                if (decoder.element.length() > 0 && (space || c == ',' || c == ']'))
+                {
+                    if (c == ']')
+                        decoder.depth = 0;
+                    return true;
+                }
+
+                if (c == ']')
+                    decoder.depth = 0;
+                else if (!space && c != ',')
+                {
+                    decoder.element += c;
+                    if (c == '{' || c == '[')
+                        decoder.depth++;
+                    else if (c == '"')
+                        decoder.inString = true;
+                }
+                continue;
+            }
+
+            decoder.element += c;
+
+            if (c == '"')
+                decoder.inString = true;
+            else if (c == '{' || c == '[')
+                decoder.depth++;
+            else if ((c == '}' || c == ']') && --decoder.depth == 1)
+                return true;
+        }
+
+        return false;
+    }
 };
 
 class HttpHelper
@@ -675,6 +766,18 @@ public:
                             : firebase_pgm_str_37 /* "Connection: close\r\n" */;
     }
 
+    /* Append the Range header from the offset, len 0 for the rest of the content */
+    void addRangeHeader(MB_String &header, size_t offset, size_t len)
+    {
+        header += firebase_pgm_str_71; // "Range: "
+        header += firebase_pgm_str_75; // "bytes="
+        header += offset;
+        header += firebase_pgm_str_14; // "-"
+        if (len > 0)
+            header += offset + len - 1;
+        addNewLine(header);
+    }
+
     /* Append the string with first request line (HTTP method) */
     bool addRequestHeaderFirst(MB_String &header, firebase_request_method method)
     {
@@ -732,53 +835,149 @@ public:
 
     void parseRespHeader(StringHelper *sh, const MB_String &src, struct server_response_data_t &response)
     {
-        int beginPos = 0;
+        const char *p = src.c_str();
+        while (*p)
+        {
+            const char *e = strchr(p, '\n');
+            int len = e ? e - p + 1 : strlen(p);
+            parseRespHeaderLine(p, len, response);
+            p += len;
+        }
+        parseRespHeaderEnd(response);
+    }
 
-        MB_String out;
+    /* Parse a single response header line and fill the known header fields */
+    void parseRespHeaderLine(const char *line, int len, struct server_response_data_t &response)
+    {
+        if (response.httpCode == -1)
+            return;
+
+        while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == '\n'))
+            len--;
+
+        const char *colon = reinterpret_cast<const char *>(memchr(line, ':', len));
+        if (!colon)
+            return;
 
-        if (response.httpCode != -1)
+        int nameLen = colon - line;
+        const char *value = colon + 1;
+        int valueLen = len - nameLen - 1;
+
+        while (valueLen > 0 && (*value == ' ' || *value == '\t'))
+        {
+            value++;
+            valueLen--;
+        }
+
+        // the known header names are classified by their length
+        switch (nameLen)
         {
+        case 4:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_49 /* "ETag: " */))
+                setHeaderValue(response.etag, value, valueLen);
+            break;
+
+        case 5:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_71 /* "Range: " */))
+            {
+                const char *dash = reinterpret_cast<const char *>(memchr(value, '-', valueLen));
+                if (dash)
+                    response.chunkRange = atoi(dash + 1);
+            }
+            break;
+
+        case 11:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_73 /* "x-goog-hash: " */))
+            {
+                // crc32c=<base64>,md5=<base64> or one hash per header line
+                MB_String hash;
+                setHeaderValue(hash, value, valueLen);
+                int p1 = hash.find(pgm2Str(firebase_pgm_str_74 /* "crc32c=" */));
+                if (p1 != (int)MB_String::npos)
+                {
+                    p1 += strlen_P(firebase_pgm_str_74);
+                    int p2 = hash.find(',', p1);
+                    response.crc32c = hash.substr(p1, p2 != (int)MB_String::npos ? p2 - p1 : MB_String::npos);
+                    response.crc32c.trim();
+                }
+            }
+            break;
 
-            sh->tokenSubString(src, response.connection,
-                               firebase_pgm_str_48 /* "Connection: " */,
-                               firebase_pgm_str_30 /* "\r\n" */, beginPos, 0, false);
-            sh->tokenSubString(src, response.contentType,
-                               firebase_pgm_str_33 /* "Content-Type: " */,
-                               firebase_pgm_str_30 /* "\r\n" */, beginPos, 0, false);
-            sh->tokenSubStringInt(src, response.contentLen,
-                                  firebase_pgm_str_34 /* "Content-Length: " */,
-                                  firebase_pgm_str_30 /* "\r\n" */, beginPos, 0, false);
-            sh->tokenSubString(src, response.etag,
-                               firebase_pgm_str_49 /* "ETag: " */,
-                               firebase_pgm_str_30 /* "\r\n" */, beginPos, 0, false);
-            response.payloadLen = response.contentLen;
+        case 13:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_72 /* "Content-Range: " */))
+            {
+                // bytes <first>-<last>/<total or *>
+                const char *slash = reinterpret_cast<const char *>(memchr(value, '/', valueLen));
+                if (slash && slash[1] != '*')
+                    response.rangeTotal = atoi(slash + 1);
+            }
+            break;
 
-            if (sh->tokenSubString(src, response.transferEnc,
-                                   firebase_pgm_str_50 /* "Transfer-Encoding: " */,
-                                   firebase_pgm_str_30 /* "\r\n" */, beginPos, 0, false) &&
-                sh->compare(response.transferEnc, 0, firebase_pgm_str_51 /* "chunked" */))
-                response.isChunkedEnc = true;
+        case 8:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_52 /* "Location: " */) &&
+                (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK ||
+                 response.httpCode == FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT ||
+                 response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT ||
+                 response.httpCode == FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY ||
+                 response.httpCode == FIREBASE_ERROR_HTTP_CODE_FOUND))
+                setHeaderValue(response.location, value, valueLen);
+            break;
 
-            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK ||
-                response.httpCode == FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT ||
-                response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT ||
-                response.httpCode == FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY ||
-                response.httpCode == FIREBASE_ERROR_HTTP_CODE_FOUND)
-                sh->tokenSubString(src, response.location,
-                                   firebase_pgm_str_52 /* "Location: " */,
-                                   firebase_pgm_str_30 /* "\r\n" */, beginPos, 0, false);
+        case 10:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_48 /* "Connection: " */))
+                setHeaderValue(response.connection, value, valueLen);
+            break;
 
-            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
-                response.noContent = true;
+        case 12:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_33 /* "Content-Type: " */))
+                setHeaderValue(response.contentType, value, valueLen);
+            break;
+
+        case 14:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_34 /* "Content-Length: " */))
+                response.contentLen = atoi(value);
+            break;
+
+        case 17:
+            if (isHeaderName(line, nameLen, firebase_pgm_str_50 /* "Transfer-Encoding: " */))
+            {
+                setHeaderValue(response.transferEnc, value, valueLen);
+                response.isChunkedEnc = valueLen >= 7 && isHeaderName(value, 7, firebase_pgm_str_51 /* "chunked" */);
+            }
+            break;
+
+        default:
+            break;
         }
     }
 
-    int getStatusCode(StringHelper *sh, const MB_String &header, int &pos)
+    /* Complete the response header fields after the last header line was parsed */
+    void parseRespHeaderEnd(struct server_response_data_t &response)
     {
+        if (response.httpCode == -1)
+            return;
+
+        response.payloadLen = response.contentLen;
+
+        if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
+            response.noContent = true;
+    }
+
+    /* Get the status code from HTTP response status line or 0 if it is not the status line */
+    int getStatusCode(const char *line, int len)
+    {
+        // HTTP/1.x NNN
+        int plen = strlen_P(firebase_pgm_str_53 /* "HTTP/1.1 " */);
+        if (len < plen + 3 || !isHeaderName(line, plen - 2, firebase_pgm_str_53 /* "HTTP/1.1 " */) || line[plen - 1] != ' ')
+            return 0;
+
         int code = 0;
-        sh->tokenSubStringInt(header, code,
-                              firebase_pgm_str_53 /* "HTTP/1.1 " */,
-                              firebase_pgm_str_9 /* " " */, pos, 0, false);
+        for (int i = plen; i < plen + 3; i++)
+        {
+            if (line[i] < '0' || line[i] > '9')
+                return 0;
+            code = code * 10 + line[i] - '0';
+        }
         return code;
     }
 
@@ -793,8 +992,20 @@ public:
             return;
 
         if (response.payloadLen > 0 && response.payloadLen <= len && ofs < len && ofs + response.payloadLen <= len)
+            setNumDataType(buf.c_str() + ofs, response.payloadLen, response, dec);
+    }
+
+    void setNumDataType(const char *num, int len, struct server_response_data_t &response, bool dec)
+    {
+        if (len > 0)
         {
-            double d = atof(buf.substr(ofs, response.payloadLen).c_str());
+            // numbers are short, parse from a stack copy instead of a substring
+            char tmp[32];
+            if (len > (int)sizeof(tmp) - 1)
+                len = sizeof(tmp) - 1;
+            memcpy(tmp, num, len);
+            tmp[len] = 0;
+            double d = atof(tmp);
 
             if (dec)
             {
@@ -943,6 +1154,84 @@ public:
         }
     }
 
+    /* Parse one event-stream record in place, the event type and the {"path":"...","data":...} envelope
+     * of its data line, without copying the record. The payloadOfs is relative to data. */
+    void parseStreamEvent(const char *type, int typeLen, const char *data, int dataLen,
+                          struct server_response_data_t &response)
+    {
+        response.isEvent = true;
+        setHeaderValue(response.eventType, type, typeLen);
+
+        if (!data)
+            return;
+
+        response.hasEventData = true;
+
+        int pos = findSpan(data, dataLen, 0, firebase_pgm_str_54 /* "\"path\":\"" */);
+        if (pos < 0)
+            return;
+
+        pos += strlen_P(firebase_pgm_str_54 /* "\"path\":\"" */);
+        int end = pos;
+        while (end < dataLen && data[end] != '"')
+            end++;
+
+        setHeaderValue(response.eventPath, data + pos, end - pos);
+
+        pos = findSpan(data, dataLen, end, firebase_pgm_str_55 /* "\"data\":" */);
+        if (pos < 0)
+            return;
+
+        pos += strlen_P(firebase_pgm_str_55 /* "\"data\":" */);
+        while (pos < dataLen && data[pos] == ' ')
+            pos++;
+
+        // the value ends before the closing brace of the envelope
+        end = dataLen;
+        while (end > pos && data[end - 1] != '}')
+            end--;
+        if (end > pos)
+            end--;
+
+        const char *value = data + pos;
+        int len = end - pos;
+
+        setHeaderValue(response.eventData, value, len);
+        response.payloadOfs = pos;
+        response.payloadLen = len;
+
+        if (len == 0)
+            return;
+
+        int plen = strlen_P(firebase_rtdb_pgm_str_7 /* "\"blob,base64," */);
+
+        if (findSpan(value, len, 0, firebase_rtdb_pgm_str_7 /* "\"blob,base64," */) == 0 ||
+            findSpan(value, len, 0, firebase_rtdb_pgm_str_8 /* "\"file,base64," */) == 0)
+        {
+            response.dataType = value[1] == 'b' ? firebase_data_type::d_blob : firebase_data_type::d_file;
+            // skip the prefix and the closing quote
+            response.payloadOfs += plen;
+            response.payloadLen = len - plen - 1 > 0 ? len - plen - 1 : 0;
+            response.eventData.clear();
+        }
+        else if (value[0] == '"')
+            response.dataType = firebase_data_type::d_string;
+        else if (value[0] == '{')
+            response.dataType = firebase_data_type::d_json;
+        else if (value[0] == '[')
+            response.dataType = firebase_data_type::d_array;
+        else if (findSpan(value, len, 0, firebase_pgm_str_20 /* "true" */) == 0 ||
+                 findSpan(value, len, 0, firebase_pgm_str_19 /* "false" */) == 0)
+        {
+            response.dataType = firebase_data_type::d_boolean;
+            response.boolData = value[0] == 't';
+        }
+        else if (findSpan(value, len, 0, firebase_pgm_str_59 /* "null" */) == 0)
+            response.dataType = firebase_data_type::d_null;
+        else
+            setNumDataType(value, len, response, memchr(value, '.', len) != NULL);
+    }
+
     void getCustomHeaders(StringHelper *sh, MB_String &header, const MB_String &tokens)
     {
         if (tokens.length() > 0)
@@ -1019,11 +1308,44 @@ public:
         tcpHandler.defaultChunkSize = defaultChunkSize;
         tcpHandler.bufferAvailable = 0;
         tcpHandler.header.clear();
+        tcpHandler.headerLine.clear();
         tcpHandler.dataTime = millis();
         tcpHandler.downloadOTA = isOTA;
         tcpHandler.payload = payload;
     }
 
+    /* Find the PROGMEM string key in the non null-terminated span, return its position or -1 */
+    int findSpan(const char *s, int len, int ofs, PGM_P key)
+    {
+        int klen = strlen_P(key);
+        for (int i = ofs; i + klen <= len; i++)
+        {
+            int j = 0;
+            while (j < klen && s[i + j] == (char)pgm_read_byte(key + j))
+                j++;
+            if (j == klen)
+                return i;
+        }
+        return -1;
+    }
+
+    /* Case insensitive compare of header name with the name part of PROGMEM "Name: " string */
+    bool isHeaderName(const char *name, int len, PGM_P key)
+    {
+        for (int i = 0; i < len; i++)
+        {
+            if (tolower(name[i]) != tolower(pgm_read_byte(key + i)))
+                return false;
+        }
+        return true;
+    }
+
+    void setHeaderValue(MB_String &out, const char *value, int len)
+    {
+        out.clear();
+        out.append(value, len);
+    }
+
     int readLine(Client *client, char *buf, int bufLen)
     {
         if (!client)
@@ -1083,26 +1405,6 @@ public:
         return idx;
     }
 
-    uint32_t hex2int(const char *hex)
-    {
-        uint32_t val = 0;
-        while (*hex)
-        {
-            // get current character then increment
-            uint8_t byte = *hex++;
-            // transform hex character to the 4bit equivalent number, using the ascii table indexes
-            if (byte >= '0' && byte <= '9')
-                byte = byte - '0';
-            else if (byte >= 'a' && byte <= 'f')
-                byte = byte - 'a' + 10;
-            else if (byte >= 'A' && byte <= 'F')
-                byte = byte - 'A' + 10;
-            // shift 4 to make space for new digit, and add the 4 bits of the new digit
-            val = (val << 4) | (byte & 0xF);
-        }
-        return val;
-    }
-
     // Returns -1 when complete
     int readChunkedData(StringHelper *sh, MB_FS *mbfs, Client *client, char *out1, MB_String *out2,
                         struct firebase_tcp_response_handler_t &tcpHandler)
@@ -1110,113 +1412,106 @@ public:
         if (!client)
             return 0;
 
-        int bufLen = tcpHandler.chunkBufSize;
-        char *buf = nullptr;
-        int p1 = 0;
-        int olen = 0;
-
-        if (tcpHandler.chunkState.state == 0)
-        {
-            tcpHandler.chunkState.state = 1;
-            tcpHandler.chunkState.chunkedSize = -1;
-            tcpHandler.chunkState.dataLen = 0;
+        if (out1)
+            return readChunkedBody(client, reinterpret_cast<uint8_t *>(out1), tcpHandler.chunkBufSize, tcpHandler.chunkState);
 
-            MB_String s;
-            int readLen = 0;
+        if (!out2)
+            return 0;
 
-            if (out2)
-                readLen = readLine(client, s);
-            else if (out1)
-            {
-                buf = reinterpret_cast<char *>(mbfs->newP(bufLen));
-                readLen = readLine(client, buf, bufLen);
-            }
+        uint8_t *buf = reinterpret_cast<uint8_t *>(mbfs->newP(tcpHandler.chunkBufSize));
+        int olen = readChunkedBody(client, buf, tcpHandler.chunkBufSize, tcpHandler.chunkState);
+        if (olen > 0)
+            out2->append(reinterpret_cast<const char *>(buf), olen);
+        mbfs->delP(&buf);
+        return olen;
+    }
 
-            if (readLen)
-            {
-                if (out1)
-                    s = buf;
+    /* Read the chunked transfer encoded body into buf.
+     * Only the chunk data is written to buf, the chunk framing is consumed by the state machine.
+     * The read never goes past the end of chunked body.
+     * Returns the number of data bytes, 0 if no data available or -1 when the last chunk was read.
+     */
+    int readChunkedBody(Client *client, uint8_t *buf, int bufLen, struct firebase_chunk_state_info &state)
+    {
+        int olen = 0;
 
-                p1 = sh->strpos(s.c_str(), (const char *)MBSTRING_FLASH_MCR(";"), 0);
-                if (p1 == -1)
-                    p1 = sh->strpos(s.c_str(), (const char *)MBSTRING_FLASH_MCR("\r\n"), 0);
+        while (olen < bufLen && state.state != firebase_chunk_state_done)
+        {
+            int available = client->available();
+            if (available <= 0)
+                break;
 
-                if (p1 != -1)
-                {
-                    if (out2)
-                        tcpHandler.chunkState.chunkedSize = hex2int(s.substr(0, p1).c_str());
-                    else if (out1)
-                    {
-                        char *temp = reinterpret_cast<char *>(mbfs->newP(p1 + 1));
-                        memcpy(temp, buf, p1);
-                        tcpHandler.chunkState.chunkedSize = hex2int(temp);
-                        mbfs->delP(&temp);
-                    }
-                }
+            if (state.state == firebase_chunk_state_data)
+            {
+                // the chunk data goes straight to the output
+                int len = state.chunkedSize - state.dataLen;
+                if (len > bufLen - olen)
+                    len = bufLen - olen;
+                if (len > available)
+                    len = available;
+
+                len = client->read(buf + olen, len);
+                if (len <= 0)
+                    break;
 
-                // last chunk
-                if (tcpHandler.chunkState.chunkedSize < 1)
-                    olen = -1;
+                olen += len;
+                state.dataLen += len;
+                if (state.dataLen == state.chunkedSize)
+                    state.state = firebase_chunk_state_data_end;
             }
             else
-                tcpHandler.chunkState.state = 0;
-
-            if (out1)
-                mbfs->delP(&buf);
-        }
-        else
-        {
-            if (tcpHandler.chunkState.chunkedSize > -1)
             {
-                MB_String s;
-                int readLen = 0;
-
-                if (out2)
-                    readLen = readLine(client, s);
-                else if (out1)
-                {
-                    buf = reinterpret_cast<char *>(mbfs->newP(bufLen));
-                    readLen = readLine(client, buf, bufLen);
-                }
+                int c = client->read();
+                if (c < 0)
+                    break;
+                parseChunkFraming(state, (char)c);
+            }
+        }
 
-                if (readLen > 0)
-                {
-                    // chunk may contain trailing
-                    if (tcpHandler.chunkState.dataLen + readLen - 2 < tcpHandler.chunkState.chunkedSize)
-                    {
-                        tcpHandler.chunkState.dataLen += readLen;
-                        if (out2)
-                            *out2 += s;
-                        else if (out1)
-                            memcpy(out1, buf, readLen);
+        return olen == 0 && state.state == firebase_chunk_state_done ? -1 : olen;
+    }
 
-                        olen = readLen;
-                    }
-                    else
-                    {
-                        if (tcpHandler.chunkState.chunkedSize - tcpHandler.chunkState.dataLen > 0)
-                        {
-                            if (out2)
-                                *out2 += s;
-                            else if (out1)
-                                memcpy(out1, buf, tcpHandler.chunkState.chunkedSize - tcpHandler.chunkState.dataLen);
-                        }
+    /* Advance the chunk framing state with the next non data byte */
+    void parseChunkFraming(struct firebase_chunk_state_info &state, char c)
+    {
+        switch (state.state)
+        {
+        case firebase_chunk_state_size:
+        case firebase_chunk_state_ext:
+            if (c == '\n')
+            {
+                state.dataLen = 0;
+                state.state = state.chunkedSize > 0 ? firebase_chunk_state_data : firebase_chunk_state_trailer;
+            }
+            else if (state.state == firebase_chunk_state_size && isxdigit(c) && state.chunkedSize < 0x7ffffff)
+                state.chunkedSize = state.chunkedSize * 16 + (isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
+            else if (c != '\r')
+                state.state = firebase_chunk_state_ext;
+            break;
 
-                        tcpHandler.chunkState.dataLen = tcpHandler.chunkState.chunkedSize;
-                        tcpHandler.chunkState.state = 0;
-                        olen = readLen;
-                    }
-                }
-                // if all chunks read, returns -1
-                else if (tcpHandler.chunkState.dataLen == tcpHandler.chunkState.chunkedSize)
-                    olen = -1;
+        case firebase_chunk_state_data_end:
+            if (c == '\n')
+            {
+                state.chunkedSize = 0;
+                state.state = firebase_chunk_state_size;
+            }
+            break;
 
-                if (out1)
-                    mbfs->delP(&buf);
+        case firebase_chunk_state_trailer:
+            // the empty line ends the trailer
+            if (c == '\n')
+            {
+                if (state.dataLen == 0)
+                    state.state = firebase_chunk_state_done;
+                state.dataLen = 0;
             }
-        }
+            else if (c != '\r')
+                state.dataLen++;
+            break;
 
-        return olen;
+        default:
+            break;
+        }
     }
 
     bool readStatusLine(StringHelper *sh, MB_FS *mbfs, Client *client, struct firebase_tcp_response_handler_t &tcpHandler,
@@ -1236,8 +1531,7 @@ public:
         if (readLen > 0)
             tcpHandler.header += hChunk;
 
-        int pos = 0;
-        int status = getStatusCode(sh, hChunk, pos);
+        int status = getStatusCode(hChunk, readLen);
         if (status > 0)
         {
             // http response status
@@ -1257,20 +1551,38 @@ public:
         char *hChunk = reinterpret_cast<char *>(mbfs->newP(tcpHandler.chunkBufSize));
         int readLen = readLine(client, hChunk, tcpHandler.chunkBufSize);
 
+        // the line was cut by the chunk buffer size or no more data available,
+        // keep it until the rest of line arrives
+        if (readLen <= 0 || hChunk[readLen - 1] != '\n')
+        {
+            if (readLen > 0)
+                tcpHandler.headerLine.append(hChunk, readLen);
+            mbfs->delP(&hChunk);
+            return false;
+        }
+
+        const char *line = hChunk;
+        if (tcpHandler.headerLine.length() > 0)
+        {
+            tcpHandler.headerLine.append(hChunk, readLen);
+            line = tcpHandler.headerLine.c_str();
+            readLen = tcpHandler.headerLine.length();
+        }
+
         // check is it the end of http header (\n or \r\n)?
-        if ((readLen == 1 && hChunk[0] == '\r') || (readLen == 2 && hChunk[0] == '\r' && hChunk[1] == '\n'))
+        if ((readLen == 1 && line[0] == '\n') || (readLen == 2 && line[0] == '\r' && line[1] == '\n'))
             tcpHandler.headerEnded = true;
 
         if (tcpHandler.headerEnded)
         {
-            // parse header string to get the header field
             tcpHandler.isHeader = false;
-            parseRespHeader(sh, tcpHandler.header, response);
+            parseRespHeaderEnd(response);
         }
-        // accumulate the remaining header field
+        // parse the header field as it arrives
         else if (readLen > 0)
-            tcpHandler.header += hChunk;
+            parseRespHeaderLine(line, readLen, response);
 
+        tcpHandler.headerLine.clear();
         mbfs->delP(&hChunk);
         return tcpHandler.headerEnded;
     }
@@ -1333,14 +1645,151 @@ public:
 
     unsigned char *creatBase64DecBuffer(MB_FS *mbfs)
     {
+        // 0x80 for the characters that are not in base64 alphabet, 0x40 for the pad character
         unsigned char *base64DecBuf = reinterpret_cast<unsigned char *>(mbfs->newP(256, false));
         memset(base64DecBuf, 0x80, 256);
         for (size_t i = 0; i < sizeof(firebase_base64_table) - 1; i++)
             base64DecBuf[firebase_base64_table[i]] = (unsigned char)i;
-        base64DecBuf['='] = 0;
+        base64DecBuf['='] = 0x40;
         return base64DecBuf;
     }
 
+    /* Encode the input piece to the output, the bytes of the incomplete 3-byte group are kept in the stream.
+     * The output should have space for ((st.pendingLen + len) / 3) * 4 characters.
+     * Return the number of characters written.
+     */
+    size_t encodeUpdate(const unsigned char *base64EncBuf, firebase_base64_stream_t &st, const uint8_t *in, size_t len,
+                        uint8_t *out)
+    {
+        uint8_t *p = out;
+
+        // complete the group from the previous piece
+        while (st.pendingLen > 0 && len > 0)
+        {
+            st.pending[st.pendingLen++] = *in++;
+            len--;
+            if (st.pendingLen == 3)
+            {
+                p = encodeWord(base64EncBuf, (uint32_t)st.pending[0] << 16 | (uint32_t)st.pending[1] << 8 | st.pending[2], p);
+                st.pendingLen = 0;
+            }
+        }
+
+        const uint8_t *end = in + (len - len % 3);
+        while (in < end)
+        {
+            p = encodeWord(base64EncBuf, (uint32_t)in[0] << 16 | (uint32_t)in[1] << 8 | in[2], p);
+            in += 3;
+        }
+
+        for (size_t i = 0; i < len % 3; i++)
+            st.pending[st.pendingLen++] = in[i];
+
+        return p - out;
+    }
+
+    /* Encode the remaining bytes with padding, return the number of characters written (0 or 4) */
+    size_t encodeFinal(const unsigned char *base64EncBuf, firebase_base64_stream_t &st, uint8_t *out)
+    {
+        if (st.pendingLen == 0)
+            return 0;
+
+        uint32_t w = (uint32_t)st.pending[0] << 16;
+        if (st.pendingLen > 1)
+            w |= (uint32_t)st.pending[1] << 8;
+
+        encodeWord(base64EncBuf, w, out);
+        out[3] = '=';
+        if (st.pendingLen == 1)
+            out[2] = '=';
+
+        st.pendingLen = 0;
+        return 4;
+    }
+
+    /* Decode the input piece to the output, the characters that are not in base64 alphabet are skipped and
+     * the 6-bit values of the incomplete quantum are kept in the stream.
+     * The output should have space for ((st.pendingLen + len) / 4) * 3 bytes.
+     * Return the number of bytes written or -1 for invalid padding.
+     */
+    int decodeUpdate(const unsigned char *base64DecBuf, firebase_base64_stream_t &st, const char *in, size_t len,
+                     uint8_t *out)
+    {
+        if (st.error)
+            return -1;
+
+        uint8_t *p = out;
+        const uint8_t *s = reinterpret_cast<const uint8_t *>(in), *end = s + len;
+
+        while (s < end && st.pad == 0)
+        {
+            // the whole quanta without line breaks or padding are decoded as one 24-bit word
+            if (st.pendingLen == 0)
+            {
+                while (end - s >= 4)
+                {
+                    uint8_t a = base64DecBuf[s[0]], b = base64DecBuf[s[1]], c = base64DecBuf[s[2]], d = base64DecBuf[s[3]];
+                    if ((a | b | c | d) & 0xc0)
+                        break;
+                    p = decodeWord((uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | d, 3, p);
+                    s += 4;
+                }
+
+                if (s == end)
+                    break;
+            }
+
+            uint8_t v = base64DecBuf[*s++];
+
+            if (v & 0x80)
+                continue;
+
+            if (v == 0x40)
+            {
+                // the data quantum can't be started with the pad character
+                if (st.pendingLen < 2)
+                {
+                    st.error = true;
+                    return -1;
+                }
+                st.pad = 4 - st.pendingLen;
+                while (st.pendingLen < 4)
+                    st.pending[st.pendingLen++] = 0;
+            }
+            else
+                st.pending[st.pendingLen++] = v;
+
+            if (st.pendingLen == 4)
+            {
+                p = decodeWord((uint32_t)st.pending[0] << 18 | (uint32_t)st.pending[1] << 12 |
+                                   (uint32_t)st.pending[2] << 6 | st.pending[3],
+                               3 - st.pad, p);
+                st.pendingLen = 0;
+            }
+        }
+
+        return p - out;
+    }
+
+    /* Decode the remaining 6-bit values of the unpadded input, return the number of bytes written or -1 */
+    int decodeFinal(firebase_base64_stream_t &st, uint8_t *out)
+    {
+        if (st.error || st.pendingLen == 1)
+            return -1;
+
+        if (st.pendingLen == 0)
+            return 0;
+
+        uint32_t w = (uint32_t)st.pending[0] << 18 | (uint32_t)st.pending[1] << 12;
+        if (st.pendingLen == 3)
+            w |= (uint32_t)st.pending[2] << 6;
+
+        decodeWord(w, st.pendingLen - 1, out);
+        int n = st.pendingLen - 1;
+        st.pendingLen = 0;
+        return n;
+    }
+
     template <typename T = uint8_t>
     bool writeOutput(MB_FS *mbfs, firebase_base64_io_t<T> &out)
     {
@@ -1363,21 +1812,41 @@ public:
     }
 
     template <typename T = uint8_t>
-    bool setOutput(MB_FS *mbfs, uint8_t val, firebase_base64_io_t<T> &out, T **pos)
+    bool setOutput(MB_FS *mbfs, const uint8_t *buf, size_t len, firebase_base64_io_t<T> &out, T **pos)
     {
         if (out.outT)
         {
             if (out.ota || out.outC || out.filetype != mb_fs_mem_storage_type_undefined)
             {
-                out.outT[out.bufWrite++] = val;
-                if (out.bufWrite == (int)out.bufLen && !writeOutput(mbfs, out))
-                    return false;
+                while (len > 0)
+                {
+                    size_t n = out.bufLen - out.bufWrite;
+                    if (n > len)
+                        n = len;
+
+                    T *dst = out.outT + out.bufWrite;
+                    for (size_t i = 0; i < n; i++)
+                        dst[i] = (T)buf[i];
+
+                    out.bufWrite += n;
+                    buf += n;
+                    len -= n;
+
+                    if (out.bufWrite == (int)out.bufLen && !writeOutput(mbfs, out))
+                        return false;
+                }
             }
             else
-                *(*pos)++ = (T)(val);
+            {
+                for (size_t i = 0; i < len; i++)
+                    *(*pos)++ = (T)(buf[i]);
+            }
         }
         else if (out.outL)
-            out.outL->push_back(val);
+        {
+            for (size_t i = 0; i < len; i++)
+                out.outL->push_back(buf[i]);
+        }
 
         return true;
     }
@@ -1386,108 +1855,30 @@ public:
     bool decode(MB_FS *mbfs, unsigned char *base64DecBuf, const char *src, size_t len, firebase_base64_io_t<T> &out)
     {
         // the maximum chunk size that writes to output is limited by out.bufLen, the minimum is depending on the source length
-        bool ret = false;
-        unsigned char *block = reinterpret_cast<unsigned char *>(mbfs->newP(4, false));
-        unsigned char temp;
-        size_t i, count;
-        int pad = 0;
-        size_t extra_pad;
+        firebase_base64_stream_t st;
+        uint8_t buf[FIREBASE_BASE64_CHUNK_SIZE / 4 * 3];
         T *pos = out.outT ? (T *)&out.outT[0] : nullptr;
+        int n = 0;
+
         if (len == 0)
             len = strlen(src);
 
-        count = 0;
-
-        for (i = 0; i < len; i++)
+        while (len > 0 && st.pad == 0)
         {
-            if ((uint8_t)base64DecBuf[(uint8_t)src[i]] != 0x80)
-                count++;
+            size_t chunk = len > FIREBASE_BASE64_CHUNK_SIZE - st.pendingLen ? FIREBASE_BASE64_CHUNK_SIZE - st.pendingLen : len;
+            n = decodeUpdate(base64DecBuf, st, src, chunk, buf);
+            if (n < 0 || !setOutput(mbfs, buf, n, out, &pos))
+                return false;
+            src += chunk;
+            len -= chunk;
         }
 
-        if (count == 0)
-            goto skip;
-
-        extra_pad = (4 - count % 4) % 4;
-        count = 0;
-        for (i = 0; i < len + extra_pad; i++)
-        {
-            unsigned char val;
-
-            if (i >= len)
-                val = '=';
-            else
-                val = src[i];
-
-            temp = base64DecBuf[val];
-
-            if (temp == 0x80)
-                continue;
-
-            if (val == '=')
-                pad++;
-
-            block[count] = temp;
-            count++;
-            if (count == 4)
-            {
-
-                setOutput(mbfs, (block[0] << 2) | (block[1] >> 4), out, &pos);
-
-                count = 0;
-                if (pad)
-                {
-                    if (pad == 1)
-                        setOutput(mbfs, (block[1] << 4) | (block[2] >> 2), out, &pos);
-                    else if (pad > 2)
-                        goto skip;
-
-                    break;
-                }
-                else
-                {
-                    setOutput(mbfs, (block[1] << 4) | (block[2] >> 2), out, &pos);
-                    setOutput(mbfs, (block[2] << 6) | block[3], out, &pos);
-                }
-            }
-        }
+        n = decodeFinal(st, buf);
+        if (n < 0 || !setOutput(mbfs, buf, n, out, &pos))
+            return false;
 
         // write remaining
         if (out.bufWrite > 0 && !writeOutput(mbfs, out))
-            goto skip;
-
-        ret = true;
-
-    skip:
-        mbfs->delP(&block);
-        return ret;
-    }
-
-    template <typename T>
-    bool encodeLast(MB_FS *mbfs, unsigned char *base64EncBuf, const unsigned char *in, size_t len,
-                    firebase_base64_io_t<T> &out, T **pos)
-    {
-        if (len > 2)
-            return false;
-
-        if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, pos))
-            return false;
-
-        if (len == 1)
-        {
-            if (!setOutput(mbfs, base64EncBuf[(in[0] & 0x03) << 4], out, pos))
-                return false;
-            if (!setOutput(mbfs, '=', out, pos))
-                return false;
-        }
-        else
-        {
-            if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[(in[1] & 0x0f) << 2], out, pos))
-                return false;
-        }
-
-        if (!setOutput(mbfs, '=', out, pos))
             return false;
 
         return true;
@@ -1497,26 +1888,20 @@ public:
     bool encode(MB_FS *mbfs, unsigned char *base64EncBuf, uint8_t *src, size_t len,
                 firebase_base64_io_t<T> &out, bool writeAllRemaining = true)
     {
-        const unsigned char *end, *in;
-
+        firebase_base64_stream_t st;
+        uint8_t buf[FIREBASE_BASE64_CHUNK_SIZE];
         T *pos = out.outT ? (T *)&out.outT[0] : nullptr;
-        in = src;
-        end = src + len;
 
-        while (end - in >= 3)
+        while (len > 0)
         {
-            if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, &pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, &pos))
+            size_t chunk = len > FIREBASE_BASE64_CHUNK_SIZE / 4 * 3 ? FIREBASE_BASE64_CHUNK_SIZE / 4 * 3 : len;
+            if (!setOutput(mbfs, buf, encodeUpdate(base64EncBuf, st, src, chunk, buf), out, &pos))
                 return false;
-            if (!setOutput(mbfs, base64EncBuf[((in[1] & 0x0f) << 2) | (in[2] >> 6)], out, &pos))
-                return false;
-            if (!setOutput(mbfs, base64EncBuf[in[2] & 0x3f], out, &pos))
-                return false;
-            in += 3;
+            src += chunk;
+            len -= chunk;
         }
 
-        if (end - in && !encodeLast(mbfs, base64EncBuf, in, end - in, out, &pos))
+        if (!setOutput(mbfs, buf, encodeFinal(base64EncBuf, st, buf), out, &pos))
             return false;
 
         if (writeAllRemaining && out.bufWrite > 0 && !writeOutput(mbfs, out))
@@ -1524,13 +1909,20 @@ public:
 
         return true;
     }
+
     template <typename T>
     bool decodeToArray(MB_FS *mbfs, const MB_String &src, MB_VECTOR<T> &val)
+    {
+        return decodeToArray<T>(mbfs, src.c_str(), src.length(), val);
+    }
+
+    template <typename T>
+    bool decodeToArray(MB_FS *mbfs, const char *src, size_t len, MB_VECTOR<T> &val)
     {
         firebase_base64_io_t<T> out;
         out.outL = &val;
         unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<T>(mbfs, base64DecBuf, src.c_str(), src.length(), out);
+        bool ret = decode<T>(mbfs, base64DecBuf, src, len, out);
         mbfs->delP(&base64DecBuf);
         return ret;
     }
@@ -1550,31 +1942,18 @@ public:
 
     void encodeUrl(MB_FS *mbfs, char *encoded, unsigned char *string, size_t len)
     {
-        size_t i;
-        char *p = encoded;
+        firebase_base64_stream_t st;
+        uint8_t *p = reinterpret_cast<uint8_t *>(encoded);
         unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, true);
 
-        for (i = 0; i < len - 2; i += 3)
-        {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-            *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2) | ((int)(string[i + 2] & 0xC0) >> 6)];
-            *p++ = base64EncBuf[string[i + 2] & 0x3F];
-        }
+        p += encodeUpdate(base64EncBuf, st, string, len, p);
+        p += encodeFinal(base64EncBuf, st, p);
 
-        if (i < len)
-        {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            if (i == (len - 1))
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4)];
-            else
-            {
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-                *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2)];
-            }
-        }
+        // base64url without padding
+        while (p > reinterpret_cast<uint8_t *>(encoded) && *(p - 1) == '=')
+            p--;
 
-        *p++ = '\0';
+        *p = '\0';
 
         mbfs->delP(&base64EncBuf);
     }
@@ -1605,6 +1984,26 @@ public:
         mbfs->delP(&base64EncBuf);
         return ret;
     }
+
+private:
+    inline uint8_t *encodeWord(const unsigned char *base64EncBuf, uint32_t w, uint8_t *out)
+    {
+        out[0] = base64EncBuf[w >> 18];
+        out[1] = base64EncBuf[(w >> 12) & 0x3f];
+        out[2] = base64EncBuf[(w >> 6) & 0x3f];
+        out[3] = base64EncBuf[w & 0x3f];
+        return out + 4;
+    }
+
+    inline uint8_t *decodeWord(uint32_t w, int len, uint8_t *out)
+    {
+        out[0] = w >> 16;
+        if (len > 1)
+            out[1] = w >> 8;
+        if (len > 2)
+            out[2] = w;
+        return out + len;
+    }
 };
 
 class OtaHelper
@@ -1736,9 +2135,14 @@ public:
     }
 
     bool validJS(const char *c)
+    {
+        return validJS(c, strlen(c));
+    }
+
+    bool validJS(const char *c, size_t len)
     {
         size_t ob = 0, cb = 0, os = 0, cs = 0;
-        for (size_t i = 0; i < strlen(c); i++)
+        for (size_t i = 0; i < len; i++)
         {
             if (c[i] == '{')
                 ob++;
@@ -1907,6 +2311,174 @@ public:
         }
         return false;
     }
+
+    // Update the CRC32C (initial value 0) with data
+    uint32_t crc32c(uint32_t crc, const uint8_t *data, size_t len)
+    {
+        crc = ~crc;
+        while (len--)
+        {
+            crc ^= *data++;
+            crc = (crc >> 4) ^ firebase_crc32c_table[crc & 0x0f];
+            crc = (crc >> 4) ^ firebase_crc32c_table[crc & 0x0f];
+        }
+        return ~crc;
+    }
+
+    // Set the download range from the response headers.
+    // Return 1 when the response continues from the offset, 0 when it is the whole object
+    // and -1 when the object was changed since the previous range.
+    int setDownloadRange(struct firebase_download_range_t &range, struct server_response_data_t &response)
+    {
+        bool partial = response.httpCode == FIREBASE_ERROR_HTTP_CODE_PARTIAL_CONTENT;
+        size_t total = partial && response.rangeTotal > 0 ? response.rangeTotal : response.contentLen;
+        int ret = 1;
+
+        if (range.offset > 0 && partial &&
+            (total != range.total || (range.etag.length() > 0 && strcmp(range.etag.c_str(), response.etag.c_str()) != 0)))
+            ret = -1;
+        else if (!partial)
+            ret = 0;
+
+        if (ret < 1)
+        {
+            range.offset = 0;
+            range.crc = 0;
+            range.crc32c.clear();
+        }
+
+        range.total = total;
+        range.etag = response.etag;
+        if (response.crc32c.length() > 0)
+            range.crc32c = response.crc32c;
+
+        return ret;
+    }
+
+    // Compare the CRC32C of the downloaded data with the object's CRC32C,
+    // the object without CRC32C passes unless required.
+    bool checkDownloadRange(Base64Helper *bh, MB_FS *mbfs, struct firebase_download_range_t &range, bool required)
+    {
+        if (range.crc32c.length() == 0)
+            return !required;
+
+        // base64 of the big-endian CRC32C
+        MB_VECTOR<uint8_t> crc;
+        if (!bh->decodeToArray(mbfs, range.crc32c, crc) || crc.size() != 4)
+            return false;
+
+        uint32_t expected = (uint32_t)crc[0] << 24 | (uint32_t)crc[1] << 16 | (uint32_t)crc[2] << 8 | crc[3];
+        return expected == range.crc;
+    }
+
+    // Load the progress of the interrupted file download and rebuild the CRC32C from the written file.
+    void loadDownloadRange(MB_FS *mbfs, const MB_String &filename, firebase_mem_storage_type type,
+                           struct firebase_download_range_t &range)
+    {
+        MB_String stateFile = filename;
+        stateFile += firebase_pgm_str_76; // ".dlstate"
+
+        int len = mbfs->open(stateFile, mbfs_type type, mb_fs_open_mode_read);
+        if (len <= 0)
+        {
+            if (len == 0)
+                mbfs->close(mbfs_type type);
+            return;
+        }
+
+        char *buf = reinterpret_cast<char *>(mbfs->newP(len + 1));
+        int read = mbfs->read(mbfs_type type, (uint8_t *)buf, len);
+        mbfs->close(mbfs_type type);
+
+        // total, offset, etag and crc32c
+        MB_VECTOR<MB_String> tk;
+        if (read > 0)
+        {
+            buf[read] = '\0';
+            StringHelper sh;
+            sh.splitTk(buf, tk, "\t");
+        }
+        mbfs->delP(&buf);
+
+        if (tk.size() < 3)
+            return;
+
+        // the file may have more bytes than the saved offset when it was interrupted before saving
+        int size = mbfs->open(filename, mbfs_type type, mb_fs_open_mode_read);
+        if (size <= 0)
+        {
+            if (size == 0)
+                mbfs->close(mbfs_type type);
+            return;
+        }
+
+        range.total = strtoul(tk[0].c_str(), NULL, 10);
+        if (strcmp(tk[2].c_str(), "-") != 0)
+            range.etag = tk[2];
+        if (tk.size() > 3)
+            range.crc32c = tk[3];
+
+        if ((size_t)size > range.total)
+        {
+            mbfs->close(mbfs_type type);
+            range.total = 0;
+            return;
+        }
+
+        uint8_t *data = reinterpret_cast<uint8_t *>(mbfs->newP(512, false));
+        range.crc = 0;
+        range.offset = 0;
+        while (range.offset < (size_t)size)
+        {
+            int n = mbfs->read(mbfs_type type, data, 512);
+            if (n <= 0)
+                break;
+            range.crc = crc32c(range.crc, data, n);
+            range.offset += n;
+            FBUtils::idle();
+        }
+        mbfs->delP(&data);
+        mbfs->close(mbfs_type type);
+    }
+
+    // Save the progress of the file download to continue after reboot.
+    void saveDownloadRange(MB_FS *mbfs, const MB_String &filename, firebase_mem_storage_type type,
+                           struct firebase_download_range_t &range)
+    {
+        MB_String stateFile = filename;
+        stateFile += firebase_pgm_str_76; // ".dlstate"
+
+        MB_String state;
+        state += range.total;
+        state += '\t';
+        state += range.offset;
+        state += '\t';
+        state += range.etag.length() > 0 ? range.etag.c_str() : "-";
+        state += '\t';
+        state += range.crc32c;
+        state += '\n';
+
+        if (mbfs->open(stateFile, mbfs_type type, mb_fs_open_mode_write) < 0)
+            return;
+
+        mbfs->write(mbfs_type type, (uint8_t *)state.c_str(), state.length());
+        mbfs->close(mbfs_type type);
+    }
+
+    void removeDownloadRange(MB_FS *mbfs, const MB_String &filename, firebase_mem_storage_type type)
+    {
+        MB_String stateFile = filename;
+        stateFile += firebase_pgm_str_76; // ".dlstate"
+
+        if (mbfs->existed(stateFile, mbfs_type type))
+            mbfs->remove(stateFile, mbfs_type type);
+    }
+
+    // The TCP errors that the download continues from the received offset
+    bool isDownloadResumable(int code)
+    {
+        return code <= FIREBASE_ERROR_TCP_ERROR_CONNECTION_REFUSED && code >= FIREBASE_ERROR_TCP_RESPONSE_READ_FAILED;
+    }
 };
 
 #endif
\ No newline at end of file
@@ -124,6 +124,9 @@ struct token_info_t FIREBASE_CLASS::authTokenInfo()
 
 bool FIREBASE_CLASS::ready()
 {
+    Core.runTokenRenewTask();
+    Core.swapRenewedToken();
+
     if (Core.isExpired())
     {
         for (size_t id = 0; id < Core.internal.sessions.size(); id++)
@@ -133,7 +136,24 @@ bool FIREBASE_CLASS::ready()
                 fbdo->closeSession();
         }
     }
-    return Core.tokenReady();
+    return Core.tokenReady(false);
+}
+
+uint32_t FIREBASE_CLASS::tokenRefreshStalls()
+{
+    return Core.internal.fb_token_refresh_stalls;
+}
+
+firebase_rsa_engine FIREBASE_CLASS::rsaEngine()
+{
+    if (Core.config && Core.config->signer.rsaEngine != firebase_rsa_engine_auto)
+        return Core.config->signer.rsaEngine;
+    return Core.internal.rsa_engine;
+}
+
+uint32_t FIREBASE_CLASS::rsaSignTime(firebase_rsa_engine engine)
+{
+    return engine > firebase_rsa_engine_auto && engine < firebase_rsa_engine_max ? Core.internal.rsa_sign_us[engine] : 0;
 }
 
 bool FIREBASE_CLASS::authenticated()
@@ -222,6 +242,9 @@ void FIREBASE_CLASS::mSetAuthToken(FirebaseConfig *config, MB_StringPtr authToke
     else
         config->signer.tokens.expires = 0;
 
+    config->signer.tokens.last_millis = millis();
+    config->signer.tokens.lifetime = expire;
+
     config->signer.tokens.status = token_status_ready;
     config->signer.step = firebase_jwt_generation_step_begin;
     config->signer.tokens.token_type = type;
@@ -275,6 +298,9 @@ void FIREBASE_CLASS::reset(FirebaseConfig *config)
         Core.internal.atok_len = 0;
         Core.internal.rtok_len = 0;
         Core.internal.ltok_len = 0;
+        Core.internal.fb_token_renewed = false;
+        Core.internal.fb_last_token_renew_millis = 0;
+        config->signer.tokens.lifetime = 0;
         config->signer.lastReqMillis = 0;
         Core.internal.fb_last_jwt_generation_error_cb_millis = 0;
         config->signer.tokens.expires = 0;
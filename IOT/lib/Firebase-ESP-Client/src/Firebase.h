@@ -236,6 +236,35 @@ public:
    */
   bool ready();
 
+  /** Get the number of requests that were stalled by the token refresh.
+   *
+   * @return The number of requests that found the token was expired or being refreshed.
+   *
+   * @note Set config.signer.refreshRatio (e.g. 0.75) to renew the ID token in the background
+   * at that fraction of its lifetime, the current token is used by the requests until the renewed
+   * token was swapped. The renewal runs in its own task on ESP32 and in Firebase.ready() on other devices.
+   */
+  uint32_t tokenRefreshStalls();
+
+  /** Get the RSA implementation that signs the JWT token.
+   *
+   * @return The firebase_rsa_engine enum value, firebase_rsa_engine_auto when no token was signed yet.
+   *
+   * @note Set config.signer.rsaEngine to select the implementation, the default is the fixed one per
+   * architecture (FIREBASE_DEFAULT_RSA_ENGINE). firebase_rsa_engine_auto benchmarks the available
+   * implementations at the first signing and uses the fastest one, the extra signings block for seconds
+   * on ESP8266 and ESP32.
+   */
+  firebase_rsa_engine rsaEngine();
+
+  /** Get the time of the JWT token signing that was measured by the benchmark.
+   *
+   * @param engine The firebase_rsa_engine enum value of the RSA implementation.
+   *
+   * @return The signing time in microseconds, 0 when the implementation was not benchmarked or not supported.
+   */
+  uint32_t rsaSignTime(firebase_rsa_engine engine);
+
   /** Provide the grant access status for Firebase Services.
    *
    * @return Boolean type status indicates the device can access to the services
@@ -200,6 +200,12 @@
  * 🏷️ For debug port assignment.
  * #define FIREBASE_DEFAULT_DEBUG_PORT Serial
  *
+ * 🏷️ For the RSA implementation used for the service account JWT signing
+ * (firebase_rsa_engine_i15, firebase_rsa_engine_i31, firebase_rsa_engine_i32 or firebase_rsa_engine_i62),
+ * i15 on ESP8266 and RP2040, i62 on the 64-bit hosts and i31 on the others by default.
+ * firebase_rsa_engine_auto benchmarks all of them at the first signing, it takes seconds on the 32-bit devices.
+ * #define FIREBASE_DEFAULT_RSA_ENGINE firebase_rsa_engine_i31
+ *
  */
 #define ENABLE_ESP8266_ENC28J60_ETH
 
@@ -302,7 +302,9 @@ public:
      *
      * CONDITION1 + && or || LOGICAL OPERATOR + CONDITION2 + LOGICAL OPERATOR + CONDITION3 +...
      *
-     * The condition checking and expression evaluation are from left to right
+     * The conditions are checked from left to right with && binding tighter than ||,
+     * e.g. a || b && c is a || (b && c), the checking stops once the result is known.
+     * The expressions are evaluated from left to right.
      *
      *
      * The valid left, right operands and syntaxes are
@@ -511,6 +513,55 @@ private:
         stm_operand_type_expression
     };
 
+    // compiled condition and expression opcode
+    enum program_opcode_t
+    {
+        program_opcode_push_const,      // push consts[arg]
+        program_opcode_push_channel,    // push the current value of channel slot arg
+        program_opcode_push_last,       // push the last value of channel slot arg
+        program_opcode_push_millis,     // push millis()
+        program_opcode_push_micros,     // push micros()
+        program_opcode_push_time_field, // push the current time field, sub is the cond_operand_type_t
+        program_opcode_test_date,       // push the result of date/time test dates[arg], sub is the comparison operator
+        program_opcode_not,             // logical not of the top value
+        program_opcode_truth,           // replace the top value with (top > 0)
+        program_opcode_arith,           // pop rvalue and apply the assignment operator sub to the top value
+        program_opcode_compare,         // pop rvalue and compare with the top value using the comparison operator sub
+        program_opcode_changed,         // pop the last value and test whether it differs from the top value
+        program_opcode_or_else,         // jump to arg if the top value is true, otherwise pop it
+        program_opcode_and_then         // jump to arg if the top value is false, otherwise pop it
+    };
+
+    struct program_instruction_t
+    {
+        uint8_t op = program_opcode_push_const;
+        int8_t sub = 0;
+        uint16_t arg = 0;
+    };
+
+    struct program_date_t
+    {
+        struct tm time;
+        bool not_op = false;
+    };
+
+    // condition or expression compiled to stack-based bytecode
+    struct program_info_t
+    {
+        MB_VECTOR<struct program_instruction_t> code;
+        MB_VECTOR<struct data_value_info_t> consts;
+        MB_VECTOR<struct program_date_t> dates;
+        uint16_t stack_size = 0;
+    };
+
+    struct program_builder_t
+    {
+        struct program_info_t *prog = nullptr;
+        int depth = 0;
+        // first instruction that can be reached by a jump, constants before it are not folded
+        size_t label = 0;
+    };
+
     // expression item data
     struct expr_item_data_t
     {
@@ -585,6 +636,7 @@ private:
     struct stm_right_operand_item_t
     {
         struct expressions_info_t exprs;
+        struct program_info_t program;
         stm_operand_type_t type = stm_operand_type_undefined;
         struct channel_info_t *channel = nullptr;
     };
@@ -608,12 +660,6 @@ private:
         MB_VECTOR<struct condition_item_info_t> list;
     };
 
-    struct expression_group_item_t
-    {
-        struct data_value_info_t result;
-        assignment_operator_type_t next_ass_opr = assignment_operator_type_undefined;
-    };
-
     struct statement_item_info_t
     {
         struct stm_item_t data;
@@ -625,6 +671,7 @@ private:
         MB_VECTOR<struct condition_item_info_t> conditions = MB_VECTOR<struct condition_item_info_t>();
         MB_VECTOR<struct statement_item_info_t> thenStatements = MB_VECTOR<struct statement_item_info_t>();
         MB_VECTOR<struct statement_item_info_t> elseStatements = MB_VECTOR<struct statement_item_info_t>();
+        struct program_info_t program;
         bool result = false;
     };
 
@@ -632,6 +679,7 @@ private:
     MB_VECTOR<struct data_value_pointer_info_t> userValueList = MB_VECTOR<struct data_value_pointer_info_t>();
     MB_VECTOR<FireSense_Function> functionList = MB_VECTOR<FireSense_Function>();
     MB_VECTOR<struct conditions_info_t> conditionsList = MB_VECTOR<struct conditions_info_t>();
+    MB_VECTOR<struct data_value_info_t> programStack = MB_VECTOR<struct data_value_info_t>();
 
     struct firesense_config_t *config;
 
@@ -660,6 +708,8 @@ private:
     unsigned long logMillis = 0;
     unsigned long conditionMillis = 0;
     unsigned long authen_check_millis = 0;
+    time_t tickTs = 0;
+    struct tm tickTime;
     time_t minTs = FIREBASE_DEFAULT_TS;
     uint64_t maxTs = 32503654800;
     MB_String deviceId;
@@ -698,11 +748,22 @@ private:
     void executeStatement(struct conditions_info_t *conditionsListItem, statement_type_t type);
     void assignDataValue(struct data_value_info_t *lvalue, struct data_value_info_t *rvalue, assignment_operator_type_t ass, bool setType, bool rvalTypeCheck);
     void assignNotValue(struct data_value_info_t *rvalue);
-    void evalExpressionsList(struct expressions_info_t *exprList);
-    void evalExpressionsItem(struct expression_item_info_t *cond);
+    void compileCondition(struct conditions_info_t &item);
+    void compileConditionList(struct program_builder_t &b, MB_VECTOR<struct condition_item_info_t> &list);
+    void compileConditionItem(struct program_builder_t &b, struct condition_item_info_t &cond);
+    void compileExpressionList(struct program_builder_t &b, MB_VECTOR<struct expression_item_info_t> &list);
+    void compileExpressionItem(struct program_builder_t &b, struct expression_item_info_t &expr);
+    void compileExpressionProgram(struct program_info_t &prog, MB_VECTOR<struct expression_item_info_t> &list);
+    void emitConstant(struct program_builder_t &b, struct data_value_info_t value);
+    void emitChannel(struct program_builder_t &b, struct channel_info_t *channel, bool lastValue);
+    void emitInstruction(struct program_builder_t &b, program_opcode_t op, int sub = 0, int arg = 0);
+    size_t emitJump(struct program_builder_t &b, program_opcode_t op);
+    void setJumpTarget(struct program_builder_t &b, size_t at);
+    void endProgram(struct program_builder_t &b);
+    void compareDataValue(struct data_value_info_t *lvalue, struct data_value_info_t *rvalue, cond_comp_opr_type_t comp);
+    bool runProgram(struct program_info_t &prog, struct data_value_info_t &out);
     int isDigit(const char *str);
     void testConditionsList();
-    void testConditionItem(struct condition_item_info_t *cond);
     void restart();
     void checkCommand();
     void checkInput();
@@ -828,6 +889,7 @@ void FireSenseClass::copyConstructor(const FireSenseClass &other)
     userValueList = other.userValueList;
     functionList = other.functionList;
     conditionsList = other.conditionsList;
+    programStack = other.programStack;
     config = new struct firesense_config_t();
     *config = *other.config;
     _callback_function = other._callback_function;
@@ -1274,10 +1336,7 @@ void FireSenseClass::executeStatement(struct conditions_info_t *conditionsListIt
             if (statement->data.right.type == stm_operand_type_channel)
                 rvalue = getChannelValue(statement->data.right.channel);
             else if (statement->data.right.type == stm_operand_type_expression)
-            {
-                evalExpressionsList(&statement->data.right.exprs);
-                rvalue = statement->data.right.exprs.result;
-            }
+                runProgram(statement->data.right.program, rvalue);
 
             if (statement->data.left.type == stm_operand_type_channel)
             {
@@ -1454,257 +1513,343 @@ void FireSenseClass::assignDataValue(struct data_value_info_t *lvalue, struct da
     }
 }
 
-void FireSenseClass::testConditionItem(struct condition_item_info_t *cond)
+void FireSenseClass::compileCondition(struct conditions_info_t &item)
 {
-    if (!timeReady)
-        return;
-
-    if (!Firebase.ready())
-        return;
+    struct program_builder_t b;
+    b.prog = &item.program;
+    compileConditionList(b, item.conditions);
+    endProgram(b);
 
-    bool result = false;
-    cond->result = false;
-    delay(0);
+    // the parsed tree is no longer used once compiled
+    item.conditions.clear();
 
-    if (cond->data.left.type == cond_operand_type_date || cond->data.left.type == cond_operand_type_time || cond->data.left.type == cond_operand_type_day || cond->data.left.type == cond_operand_type_weekday || cond->data.left.type == cond_operand_type_year || cond->data.left.type == cond_operand_type_month || cond->data.left.type == cond_operand_type_hour || cond->data.left.type == cond_operand_type_min || cond->data.left.type == cond_operand_type_sec)
+    for (int k = 0; k < 2; k++)
     {
-        time_t current_ts = Firebase.getCurrentTime();
-        time_t target_ts = 0;
-        struct tm current_timeinfo;
-        localtime_r(&current_ts, &current_timeinfo);
+        MB_VECTOR<statement_item_info_t> *stms = k == 0 ? &item.thenStatements : &item.elseStatements;
 
-        if (cond->data.left.type == cond_operand_type_day || cond->data.left.type == cond_operand_type_weekday || cond->data.left.type == cond_operand_type_year || cond->data.left.type == cond_operand_type_month || cond->data.left.type == cond_operand_type_hour || cond->data.left.type == cond_operand_type_min || cond->data.left.type == cond_operand_type_sec)
+        for (size_t i = 0; i < stms->size(); i++)
         {
-            if (cond->data.left.type == cond_operand_type_day)
-            {
-                target_ts = cond->data.left.time.tm_mday;
-                current_ts = current_timeinfo.tm_mday;
-            }
-            else if (cond->data.left.type == cond_operand_type_weekday)
-            {
-                target_ts = cond->data.left.time.tm_wday;
-                current_ts = current_timeinfo.tm_wday;
-                if (current_ts == 0)
-                    current_ts = 7;
-            }
-            else if (cond->data.left.type == cond_operand_type_year)
-            {
-                target_ts = cond->data.left.time.tm_year;
-                current_ts = current_timeinfo.tm_year;
-            }
-            else if (cond->data.left.type == cond_operand_type_month)
-            {
-                target_ts = cond->data.left.time.tm_mon;
-                current_ts = current_timeinfo.tm_mon;
-            }
-            else if (cond->data.left.type == cond_operand_type_hour)
+#if defined(MB_USE_STD_VECTOR)
+            statement_item_info_t *statement = &(*(stms->begin() + i));
+#else
+            statement_item_info_t *statement = &((*stms)[i]);
+#endif
+            if (statement->data.right.type == stm_operand_type_expression)
             {
-                target_ts = cond->data.left.time.tm_hour;
-                current_ts = current_timeinfo.tm_hour;
+                compileExpressionProgram(statement->data.right.program, statement->data.right.exprs.expressions);
+                statement->data.right.exprs.expressions.clear();
             }
-            else if (cond->data.left.type == cond_operand_type_min)
+        }
+    }
+}
+
+void FireSenseClass::compileConditionList(struct program_builder_t &b, MB_VECTOR<struct condition_item_info_t> &list)
+{
+    struct data_value_info_t v;
+    v.type = data_type_bool;
+
+    if (list.size() == 0)
+    {
+        emitConstant(b, v);
+        return;
+    }
+
+    // the true result of || ends the group, the false result of && skips the next item
+    MB_VECTOR<size_t> exits;
+    size_t skip = 0;
+    bool skipPending = false;
+
+    for (size_t i = 0; i < list.size(); i++)
+    {
+        if (i > 0)
+        {
+            if (list[i - 1].next_comp_opr == next_comp_opr_or)
             {
-                target_ts = cond->data.left.time.tm_min;
-                current_ts = current_timeinfo.tm_min;
+                size_t at = emitJump(b, program_opcode_or_else);
+                exits.push_back(at);
             }
-            else if (cond->data.left.type == cond_operand_type_sec)
+            else
             {
-                target_ts = cond->data.left.time.tm_sec;
-                current_ts = current_timeinfo.tm_sec;
+                skip = emitJump(b, program_opcode_and_then);
+                skipPending = true;
             }
         }
-        else
+
+        compileConditionItem(b, list[i]);
+
+        if (skipPending)
         {
-            struct tm target_timeinfo = cond->data.left.time;
-
-            if (cond->data.left.time.tm_year == -1)
-                target_timeinfo.tm_year = current_timeinfo.tm_year;
-            if (cond->data.left.time.tm_mon == -1)
-                target_timeinfo.tm_mon = current_timeinfo.tm_mon;
-            if (cond->data.left.time.tm_mday == -1)
-                target_timeinfo.tm_mday = current_timeinfo.tm_mday;
-
-            if (cond->data.left.time.tm_hour == -1)
-                target_timeinfo.tm_hour = current_timeinfo.tm_hour;
-            if (cond->data.left.time.tm_min == -1)
-                target_timeinfo.tm_min = current_timeinfo.tm_min;
-            if (cond->data.left.time.tm_sec == -1)
-                target_timeinfo.tm_sec = current_timeinfo.tm_sec;
-
-            target_ts = mktime(&target_timeinfo);
+            setJumpTarget(b, skip);
+            skipPending = false;
         }
-
-        if (cond->data.left.not_op)
-            target_ts = target_ts > 0 ? 0 : 1;
-
-        if (cond->data.comp == cond_comp_opr_type_lt)
-            result = current_ts < target_ts;
-        else if (cond->data.comp == cond_comp_opr_type_gt)
-            result = current_ts > target_ts;
-        else if (cond->data.comp == cond_comp_opr_type_lteq)
-            result = current_ts <= target_ts;
-        else if (cond->data.comp == cond_comp_opr_type_gteq)
-            result = current_ts >= target_ts;
-        else if (cond->data.comp == cond_comp_opr_type_eq)
-            result = current_ts == target_ts;
-        else if (cond->data.comp == cond_comp_opr_type_neq)
-            result = current_ts != target_ts;
-
-        if (cond->not_op)
-            result = !result;
     }
-    else
+
+    for (size_t i = 0; i < exits.size(); i++)
+        setJumpTarget(b, exits[i]);
+}
+
+void FireSenseClass::compileConditionItem(struct program_builder_t &b, struct condition_item_info_t &cond)
+{
+    struct cond_item_data_t *data = &cond.data;
+    struct data_value_info_t v;
+
+    if (cond.list.size() > 0)
+        compileConditionList(b, cond.list);
+    else if (data->left.type == cond_operand_type_date || data->left.type == cond_operand_type_time)
     {
-        if (cond->data.left.type == cond_operand_type_millis || cond->data.left.type == cond_operand_type_micros || cond->data.left.type == cond_operand_type_expression || cond->data.left.type == cond_operand_type_channel || cond->data.left.type == cond_operand_type_changed)
-        {
-            struct data_value_info_t lvalue;
-            struct data_value_info_t rvalue;
-            if (cond->data.left.type == cond_operand_type_changed && cond->data.left.channel)
-            {
-                lvalue = cond->data.left.channel->current_value;
-                rvalue = cond->data.left.channel->last_value;
+        struct program_date_t date;
+        date.time = data->left.time;
+        date.not_op = data->left.not_op;
+        b.prog->dates.push_back(date);
+        emitInstruction(b, program_opcode_test_date, data->comp, b.prog->dates.size() - 1);
+    }
+    else if (data->left.type == cond_operand_type_day || data->left.type == cond_operand_type_weekday || data->left.type == cond_operand_type_year || data->left.type == cond_operand_type_month || data->left.type == cond_operand_type_hour || data->left.type == cond_operand_type_min || data->left.type == cond_operand_type_sec)
+    {
+        if (data->left.type == cond_operand_type_day)
+            v.int_data = data->left.time.tm_mday;
+        else if (data->left.type == cond_operand_type_weekday)
+            v.int_data = data->left.time.tm_wday;
+        else if (data->left.type == cond_operand_type_year)
+            v.int_data = data->left.time.tm_year;
+        else if (data->left.type == cond_operand_type_month)
+            v.int_data = data->left.time.tm_mon;
+        else if (data->left.type == cond_operand_type_hour)
+            v.int_data = data->left.time.tm_hour;
+        else if (data->left.type == cond_operand_type_min)
+            v.int_data = data->left.time.tm_min;
+        else
+            v.int_data = data->left.time.tm_sec;
 
-                if (cond->data.left.not_op)
-                    assignNotValue(&lvalue);
+        if (data->left.not_op)
+            v.int_data = v.int_data > 0 ? 0 : 1;
 
-                result = (lvalue.int_data != rvalue.int_data || lvalue.float_data != rvalue.float_data);
-            }
-            else
-            {
-                if (cond->data.left.type == cond_operand_type_channel && cond->data.left.channel)
-                    lvalue = cond->data.left.channel->current_value;
-                else if (cond->data.left.type == cond_operand_type_millis)
-                {
-                    lvalue.int_data = millis();
-                    lvalue.float_data = (float)lvalue.int_data;
-                    lvalue.type = data_type_int;
-                }
-                else if (cond->data.left.type == cond_operand_type_micros)
-                {
-                    lvalue.int_data = micros();
-                    lvalue.float_data = (float)lvalue.int_data;
-                    lvalue.type = data_type_int;
-                }
-                else if (cond->data.left.type == cond_operand_type_expression)
-                {
-                    evalExpressionsList(&cond->data.left.exprs);
-                    lvalue = cond->data.left.exprs.result;
-                }
+        v.float_data = (float)v.int_data;
+        v.type = data_type_int;
 
-                if (cond->data.left.not_op)
-                    assignNotValue(&lvalue);
+        emitInstruction(b, program_opcode_push_time_field, data->left.type);
+        emitConstant(b, v);
+        emitInstruction(b, program_opcode_compare, data->comp);
+    }
+    else if (data->left.type == cond_operand_type_changed)
+    {
+        emitChannel(b, data->left.channel, false);
+        if (data->left.not_op)
+            emitInstruction(b, program_opcode_not);
+        emitChannel(b, data->left.channel, true);
+        emitInstruction(b, program_opcode_changed);
+    }
+    else if (data->left.type == cond_operand_type_millis || data->left.type == cond_operand_type_micros || data->left.type == cond_operand_type_expression || data->left.type == cond_operand_type_channel)
+    {
+        if (data->left.type == cond_operand_type_channel)
+            emitChannel(b, data->left.channel, false);
+        else if (data->left.type == cond_operand_type_millis)
+            emitInstruction(b, program_opcode_push_millis);
+        else if (data->left.type == cond_operand_type_micros)
+            emitInstruction(b, program_opcode_push_micros);
+        else
+            compileExpressionList(b, data->left.exprs.expressions);
 
-                if (cond->data.right.type == cond_operand_type_channel && cond->data.right.channel)
-                    rvalue = cond->data.right.channel->current_value;
-                else if (cond->data.right.type == cond_operand_type_millis)
-                {
-                    rvalue.int_data = millis();
-                    rvalue.float_data = (float)rvalue.int_data;
-                }
-                else if (cond->data.right.type == cond_operand_type_micros)
-                {
-                    rvalue.int_data = micros();
-                    rvalue.float_data = (float)rvalue.int_data;
-                }
-                else if (cond->data.right.type == cond_operand_type_expression)
-                {
-                    evalExpressionsList(&cond->data.right.exprs);
-                    rvalue = cond->data.right.exprs.result;
-                }
-                else if (cond->data.right.type == cond_operand_type_undefined)
-                    result = lvalue.int_data > 0;
+        if (data->left.not_op)
+            emitInstruction(b, program_opcode_not);
 
-                if (cond->data.right.not_op)
-                    assignNotValue(&rvalue);
+        if (data->right.type == cond_operand_type_undefined && data->comp == cond_comp_opr_type_undefined)
+            emitInstruction(b, program_opcode_truth);
+        else
+        {
+            if (data->right.type == cond_operand_type_channel)
+                emitChannel(b, data->right.channel, false);
+            else if (data->right.type == cond_operand_type_millis)
+                emitInstruction(b, program_opcode_push_millis);
+            else if (data->right.type == cond_operand_type_micros)
+                emitInstruction(b, program_opcode_push_micros);
+            else if (data->right.type == cond_operand_type_expression)
+                compileExpressionList(b, data->right.exprs.expressions);
+            else
+                emitConstant(b, v);
 
-                if (cond->data.comp == cond_comp_opr_type_lt)
-                {
-                    if (lvalue.type == data_type_float)
-                        result = (lvalue.float_data < rvalue.float_data);
-                    else
-                        result = (lvalue.int_data < rvalue.int_data);
-                }
-                else if (cond->data.comp == cond_comp_opr_type_gt)
-                {
-                    if (lvalue.type == data_type_float)
-                        result = (lvalue.float_data > rvalue.float_data);
-                    else
-                        result = (lvalue.int_data > rvalue.int_data);
-                }
-                else if (cond->data.comp == cond_comp_opr_type_lteq)
-                {
-                    if (lvalue.type == data_type_float)
-                        result = (lvalue.float_data <= rvalue.float_data);
-                    else
-                        result = (lvalue.int_data <= rvalue.int_data);
-                }
-                else if (cond->data.comp == cond_comp_opr_type_gteq)
-                {
-                    if (lvalue.type == data_type_float)
-                        result = (lvalue.float_data >= rvalue.float_data);
-                    else
-                        result = (lvalue.int_data >= rvalue.int_data);
-                }
-                else if (cond->data.comp == cond_comp_opr_type_eq)
-                {
-                    if (lvalue.type == data_type_float)
-                        result = (lvalue.float_data == rvalue.float_data);
-                    else
-                        result = (lvalue.int_data == rvalue.int_data);
-                }
-                else if (cond->data.comp == cond_comp_opr_type_neq)
-                {
-                    if (lvalue.type == data_type_float)
-                        result = (lvalue.float_data != rvalue.float_data);
-                    else
-                        result = (lvalue.int_data != rvalue.int_data);
-                }
-            }
+            if (data->right.not_op)
+                emitInstruction(b, program_opcode_not);
 
-            if (cond->not_op)
-                result = !result;
+            emitInstruction(b, program_opcode_compare, data->comp);
         }
     }
+    else
+    {
+        v.type = data_type_bool;
+        emitConstant(b, v);
+    }
 
-    if (cond->list.size() > 0)
+    if (cond.not_op)
+        emitInstruction(b, program_opcode_not);
+}
+
+void FireSenseClass::compileExpressionList(struct program_builder_t &b, MB_VECTOR<struct expression_item_info_t> &list)
+{
+    if (list.size() == 0)
     {
-        bool res = false;
+        struct data_value_info_t v;
+        emitConstant(b, v);
+        return;
+    }
 
-        next_comp_opr_t next_comp_opr = next_comp_opr_none;
+    // + and - have the lower precedence, the other operators are applied from left to right
+    assignment_operator_type_t sum_opr = assignment_operator_type_undefined;
+
+    for (size_t i = 0; i < list.size(); i++)
+    {
+        assignment_operator_type_t opr = i > 0 ? list[i - 1].next_ass_opr : assignment_operator_type_undefined;
+        bool additive = opr == assignment_operator_type_add || opr == assignment_operator_type_subtract;
 
-        for (size_t i = 0; i < cond->list.size(); i++)
+        if (additive)
         {
-            delay(0);
-            struct condition_item_info_t *_cond = &cond->list[i];
+            if (sum_opr != assignment_operator_type_undefined)
+                emitInstruction(b, program_opcode_arith, sum_opr);
+            sum_opr = opr;
+        }
 
-            testConditionItem(_cond);
+        compileExpressionItem(b, list[i]);
 
-            if (i == 0)
-                res = _cond->result;
+        if (i > 0 && !additive)
+            emitInstruction(b, program_opcode_arith, opr);
+    }
 
-            if (next_comp_opr == next_comp_opr_or)
-            {
-                res |= _cond->result;
-                if (res)
-                    break;
-            }
-            else if (next_comp_opr == next_comp_opr_and)
-                res &= _cond->result;
+    if (sum_opr != assignment_operator_type_undefined)
+        emitInstruction(b, program_opcode_arith, sum_opr);
+}
 
-            next_comp_opr = _cond->next_comp_opr;
-            if (next_comp_opr == next_comp_opr_or && res)
-                break;
+void FireSenseClass::compileExpressionItem(struct program_builder_t &b, struct expression_item_info_t &expr)
+{
+    if (expr.list.size() > 0)
+        compileExpressionList(b, expr.list);
+    else
+    {
+        if (expr.data.type == expr_operand_type_channel)
+            emitChannel(b, expr.data.channel, false);
+        else if (expr.data.type == expr_operand_type_millis)
+            emitInstruction(b, program_opcode_push_millis);
+        else if (expr.data.type == expr_operand_type_micros)
+            emitInstruction(b, program_opcode_push_micros);
+        else if (expr.data.type == expr_operand_type_value)
+            emitConstant(b, expr.data.value);
+        else
+        {
+            struct data_value_info_t v;
+            emitConstant(b, v);
         }
 
-        if (cond->next_comp_opr == next_comp_opr_or)
-            result |= res;
-        else if (cond->next_comp_opr == next_comp_opr_and)
-            result &= res;
+        if (expr.data.not_op)
+            emitInstruction(b, program_opcode_not);
+    }
+
+    if (expr.not_op)
+        emitInstruction(b, program_opcode_not);
+}
+
+void FireSenseClass::compileExpressionProgram(struct program_info_t &prog, MB_VECTOR<struct expression_item_info_t> &list)
+{
+    struct program_builder_t b;
+    b.prog = &prog;
+    compileExpressionList(b, list);
+    endProgram(b);
+}
+
+void FireSenseClass::emitConstant(struct program_builder_t &b, struct data_value_info_t value)
+{
+    b.prog->consts.push_back(value);
+    emitInstruction(b, program_opcode_push_const, 0, b.prog->consts.size() - 1);
+}
+
+void FireSenseClass::emitChannel(struct program_builder_t &b, struct channel_info_t *channel, bool lastValue)
+{
+    // resolve the channel to its slot in channelsList
+    for (size_t i = 0; channel && i < channelsList.size(); i++)
+    {
+        if (&channelsList[i] == channel)
+        {
+            emitInstruction(b, lastValue ? program_opcode_push_last : program_opcode_push_channel, 0, i);
+            return;
+        }
+    }
+
+    struct data_value_info_t v;
+    emitConstant(b, v);
+}
+
+void FireSenseClass::emitInstruction(struct program_builder_t &b, program_opcode_t op, int sub, int arg)
+{
+    struct program_info_t *prog = b.prog;
+    size_t n = prog->code.size();
+
+    // fold the operations on constants which are not the jump target
+    if ((op == program_opcode_not || op == program_opcode_truth) && n > b.label && prog->code[n - 1].op == program_opcode_push_const)
+    {
+        struct data_value_info_t *v = &prog->consts[prog->code[n - 1].arg];
+        if (op == program_opcode_not)
+            assignNotValue(v);
         else
-            result = res;
+        {
+            v->int_data = v->int_data > 0 ? 1 : 0;
+            v->float_data = (float)v->int_data;
+            v->type = data_type_bool;
+        }
+        return;
+    }
+
+    if ((op == program_opcode_arith || op == program_opcode_compare) && n >= b.label + 2 && prog->code[n - 1].op == program_opcode_push_const && prog->code[n - 2].op == program_opcode_push_const)
+    {
+        struct data_value_info_t *lvalue = &prog->consts[prog->code[n - 2].arg];
+        struct data_value_info_t rvalue = prog->consts[prog->code[n - 1].arg];
+
+        // leave the remainder by zero to the run time as before
+        if (op == program_opcode_compare || sub != assignment_operator_type_remainder || rvalue.int_data != 0)
+        {
+            if (op == program_opcode_arith)
+                assignDataValue(lvalue, &rvalue, (assignment_operator_type_t)sub, true, true);
+            else
+                compareDataValue(lvalue, &rvalue, (cond_comp_opr_type_t)sub);
+
+            prog->code.pop_back();
+            prog->consts.pop_back();
+            b.depth--;
+            return;
+        }
     }
 
-    cond->result = result;
+    if (op == program_opcode_arith || op == program_opcode_compare || op == program_opcode_changed || op == program_opcode_or_else || op == program_opcode_and_then)
+        b.depth--;
+    else if (op != program_opcode_not && op != program_opcode_truth)
+        b.depth++;
+
+    if (b.depth > prog->stack_size)
+        prog->stack_size = b.depth;
+
+    struct program_instruction_t ins;
+    ins.op = op;
+    ins.sub = sub;
+    ins.arg = arg;
+    prog->code.push_back(ins);
+}
+
+size_t FireSenseClass::emitJump(struct program_builder_t &b, program_opcode_t op)
+{
+    emitInstruction(b, op);
+    return b.prog->code.size() - 1;
+}
+
+void FireSenseClass::setJumpTarget(struct program_builder_t &b, size_t at)
+{
+    b.prog->code[at].arg = b.prog->code.size();
+    b.label = b.prog->code.size();
+}
+
+void FireSenseClass::endProgram(struct program_builder_t &b)
+{
+    // the evaluation stack is shared by all programs and only grows here
+    while (programStack.size() < b.prog->stack_size)
+    {
+        struct data_value_info_t v;
+        programStack.push_back(v);
+    }
 }
 
 int FireSenseClass::isDigit(const char *str)
@@ -1725,151 +1870,201 @@ int FireSenseClass::isDigit(const char *str)
     return dot;
 }
 
-void FireSenseClass::evalExpressionsList(struct expressions_info_t *exprList)
+void FireSenseClass::compareDataValue(struct data_value_info_t *lvalue, struct data_value_info_t *rvalue, cond_comp_opr_type_t comp)
 {
-    if (!timeReady)
-        return;
-
-    if (!Firebase.ready())
-        return;
+    bool result = false;
 
-    MB_VECTOR<struct expression_group_item_t> resList;
+    if (lvalue->type == data_type_float)
+    {
+        if (comp == cond_comp_opr_type_lt)
+            result = lvalue->float_data < rvalue->float_data;
+        else if (comp == cond_comp_opr_type_gt)
+            result = lvalue->float_data > rvalue->float_data;
+        else if (comp == cond_comp_opr_type_lteq)
+            result = lvalue->float_data <= rvalue->float_data;
+        else if (comp == cond_comp_opr_type_gteq)
+            result = lvalue->float_data >= rvalue->float_data;
+        else if (comp == cond_comp_opr_type_eq)
+            result = lvalue->float_data == rvalue->float_data;
+        else if (comp == cond_comp_opr_type_neq)
+            result = lvalue->float_data != rvalue->float_data;
+    }
+    else
+    {
+        if (comp == cond_comp_opr_type_lt)
+            result = lvalue->int_data < rvalue->int_data;
+        else if (comp == cond_comp_opr_type_gt)
+            result = lvalue->int_data > rvalue->int_data;
+        else if (comp == cond_comp_opr_type_lteq)
+            result = lvalue->int_data <= rvalue->int_data;
+        else if (comp == cond_comp_opr_type_gteq)
+            result = lvalue->int_data >= rvalue->int_data;
+        else if (comp == cond_comp_opr_type_eq)
+            result = lvalue->int_data == rvalue->int_data;
+        else if (comp == cond_comp_opr_type_neq)
+            result = lvalue->int_data != rvalue->int_data;
+    }
 
-    struct expression_group_item_t r;
+    lvalue->int_data = result ? 1 : 0;
+    lvalue->float_data = (float)lvalue->int_data;
+    lvalue->type = data_type_bool;
+}
 
-    for (size_t i = 0; i < exprList->expressions.size(); i++)
-    {
-        if (!timeReady)
-            break;
+bool FireSenseClass::runProgram(struct program_info_t &prog, struct data_value_info_t &out)
+{
+    size_t len = prog.code.size();
 
-        delay(0);
-        struct expression_item_info_t *expr = &exprList->expressions[i];
+    if (len == 0 || programStack.size() < prog.stack_size)
+        return false;
 
-        evalExpressionsItem(expr);
+    size_t slots = channelsList.size();
+    size_t pc = 0;
+    int sp = 0;
 
-        if (expr->not_op)
-            assignNotValue(&expr->result);
+    while (pc < len)
+    {
+        struct program_instruction_t ins = prog.code[pc++];
+        struct data_value_info_t *top = &programStack[sp > 0 ? sp - 1 : 0];
 
-        if (i == 0)
-            assignDataValue(&r.result, &expr->result, assignment_operator_type_assignment, true, true);
-        else
+        switch (ins.op)
         {
-            if (r.next_ass_opr == assignment_operator_type_add || r.next_ass_opr == assignment_operator_type_subtract)
-            {
-                resList.push_back(r);
-                assignDataValue(&r.result, &expr->result, assignment_operator_type_assignment, true, true);
-            }
+        case program_opcode_push_const:
+            programStack[sp++] = prog.consts[ins.arg];
+            break;
+
+        case program_opcode_push_channel:
+        case program_opcode_push_last:
+            if (ins.arg < slots)
+                programStack[sp] = ins.op == program_opcode_push_channel ? channelsList[ins.arg].current_value : channelsList[ins.arg].last_value;
             else
-                assignDataValue(&r.result, &expr->result, r.next_ass_opr, true, true);
-        }
+                programStack[sp] = data_value_info_t();
+            sp++;
+            break;
 
-        r.next_ass_opr = expr->next_ass_opr;
-    }
+        case program_opcode_push_millis:
+        case program_opcode_push_micros:
+            top = &programStack[sp++];
+            top->int_data = ins.op == program_opcode_push_millis ? millis() : micros();
+            top->float_data = (float)top->int_data;
+            top->type = data_type_int;
+            break;
 
-    if (resList.size() > 0)
-    {
-        assignment_operator_type_t next_ass_opr = assignment_operator_type_undefined;
+        case program_opcode_push_time_field:
+            top = &programStack[sp++];
+            if (ins.sub == cond_operand_type_day)
+                top->int_data = tickTime.tm_mday;
+            else if (ins.sub == cond_operand_type_weekday)
+                top->int_data = tickTime.tm_wday == 0 ? 7 : tickTime.tm_wday;
+            else if (ins.sub == cond_operand_type_year)
+                top->int_data = tickTime.tm_year;
+            else if (ins.sub == cond_operand_type_month)
+                top->int_data = tickTime.tm_mon;
+            else if (ins.sub == cond_operand_type_hour)
+                top->int_data = tickTime.tm_hour;
+            else if (ins.sub == cond_operand_type_min)
+                top->int_data = tickTime.tm_min;
+            else
+                top->int_data = tickTime.tm_sec;
+            top->float_data = (float)top->int_data;
+            top->type = data_type_int;
+            break;
 
-        for (size_t i = 0; i < resList.size(); i++)
+        case program_opcode_test_date:
         {
-            if (i == 0)
-                assignDataValue(&exprList->result, &resList[i].result, assignment_operator_type_assignment, true, true);
-            else
-            {
-                if (next_ass_opr == assignment_operator_type_add || next_ass_opr == assignment_operator_type_subtract)
-                    assignDataValue(&exprList->result, &resList[i].result, next_ass_opr, true, true);
-            }
-            next_ass_opr = resList[i].next_ass_opr;
+            struct program_date_t *date = &prog.dates[ins.arg];
+            struct tm target_timeinfo = date->time;
+
+            if (target_timeinfo.tm_year == -1)
+                target_timeinfo.tm_year = tickTime.tm_year;
+            if (target_timeinfo.tm_mon == -1)
+                target_timeinfo.tm_mon = tickTime.tm_mon;
+            if (target_timeinfo.tm_mday == -1)
+                target_timeinfo.tm_mday = tickTime.tm_mday;
+            if (target_timeinfo.tm_hour == -1)
+                target_timeinfo.tm_hour = tickTime.tm_hour;
+            if (target_timeinfo.tm_min == -1)
+                target_timeinfo.tm_min = tickTime.tm_min;
+            if (target_timeinfo.tm_sec == -1)
+                target_timeinfo.tm_sec = tickTime.tm_sec;
+            target_timeinfo.tm_isdst = tickTime.tm_isdst;
+
+            time_t target_ts = mktime(&target_timeinfo);
+            if (date->not_op)
+                target_ts = target_ts > 0 ? 0 : 1;
+
+            bool result = false;
+            if (ins.sub == cond_comp_opr_type_lt)
+                result = tickTs < target_ts;
+            else if (ins.sub == cond_comp_opr_type_gt)
+                result = tickTs > target_ts;
+            else if (ins.sub == cond_comp_opr_type_lteq)
+                result = tickTs <= target_ts;
+            else if (ins.sub == cond_comp_opr_type_gteq)
+                result = tickTs >= target_ts;
+            else if (ins.sub == cond_comp_opr_type_eq)
+                result = tickTs == target_ts;
+            else if (ins.sub == cond_comp_opr_type_neq)
+                result = tickTs != target_ts;
+
+            top = &programStack[sp++];
+            top->int_data = result ? 1 : 0;
+            top->float_data = (float)top->int_data;
+            top->type = data_type_bool;
+            break;
         }
 
-        if (next_ass_opr == assignment_operator_type_add || next_ass_opr == assignment_operator_type_subtract)
-            assignDataValue(&exprList->result, &r.result, next_ass_opr, true, true);
-    }
-    else
-        assignDataValue(&exprList->result, &r.result, assignment_operator_type_assignment, true, true);
-}
-
-void FireSenseClass::evalExpressionsItem(struct expression_item_info_t *expr)
-{
-    if (!timeReady)
-        return;
+        case program_opcode_not:
+            assignNotValue(top);
+            break;
 
-    if (!Firebase.ready())
-        return;
+        case program_opcode_truth:
+            top->int_data = top->int_data > 0 ? 1 : 0;
+            top->float_data = (float)top->int_data;
+            top->type = data_type_bool;
+            break;
 
-    delay(0);
+        case program_opcode_arith:
+            sp--;
+            assignDataValue(&programStack[sp - 1], &programStack[sp], (assignment_operator_type_t)ins.sub, true, true);
+            break;
 
-    if (expr->list.size() == 0)
-    {
-        if (expr->data.type == expr_operand_type_channel && expr->data.channel)
-            assignDataValue(&expr->result, &expr->data.channel->current_value, assignment_operator_type_assignment, true, true);
-        else if (expr->data.type == expr_operand_type_millis)
-        {
-            expr->result.int_data = millis();
-            expr->result.type = data_type_int;
-            expr->result.float_data = (float)expr->result.int_data;
-        }
-        else if (expr->data.type == expr_operand_type_micros)
-        {
-            expr->result.int_data = micros();
-            expr->result.type = data_type_int;
-            expr->result.float_data = (float)expr->result.int_data;
-        }
-        else if (expr->data.type == expr_operand_type_value)
-            assignDataValue(&expr->result, &expr->data.value, assignment_operator_type_assignment, true, true);
+        case program_opcode_compare:
+            sp--;
+            compareDataValue(&programStack[sp - 1], &programStack[sp], (cond_comp_opr_type_t)ins.sub);
+            break;
 
-        if (expr->data.not_op)
+        case program_opcode_changed:
         {
-            expr->result.int_data = expr->result.int_data > 0 ? 0 : 1;
-            expr->result.float_data = (float)expr->result.int_data;
+            sp--;
+            struct data_value_info_t *lvalue = &programStack[sp - 1];
+            struct data_value_info_t *rvalue = &programStack[sp];
+            lvalue->int_data = (lvalue->int_data != rvalue->int_data || lvalue->float_data != rvalue->float_data) ? 1 : 0;
+            lvalue->float_data = (float)lvalue->int_data;
+            lvalue->type = data_type_bool;
+            break;
         }
-    }
-    else
-    {
-        MB_VECTOR<struct expression_group_item_t> resList;
-
-        struct expression_group_item_t r;
 
-        for (size_t i = 0; i < expr->list.size(); i++)
-        {
-            delay(0);
-            struct expression_item_info_t *_expr = &expr->list[i];
-            evalExpressionsItem(_expr);
-            if (i == 0)
-                assignDataValue(&r.result, &_expr->result, assignment_operator_type_assignment, true, true);
+        case program_opcode_or_else:
+            if (top->int_data > 0)
+                pc = ins.arg;
             else
-            {
-                if (r.next_ass_opr == assignment_operator_type_add || r.next_ass_opr == assignment_operator_type_subtract)
-                {
-                    resList.push_back(r);
-                    assignDataValue(&r.result, &_expr->result, assignment_operator_type_assignment, true, true);
-                }
-                else
-                    assignDataValue(&r.result, &_expr->result, r.next_ass_opr, true, true);
-            }
-            r.next_ass_opr = _expr->next_ass_opr;
-        }
-
-        if (resList.size() > 0)
-        {
-            assignment_operator_type_t next_ass_opr = assignment_operator_type_undefined;
-
-            for (size_t i = 0; i < resList.size(); i++)
-            {
-                if (i == 0)
-                    assignDataValue(&expr->result, &resList[i].result, assignment_operator_type_assignment, true, true);
-                else if (next_ass_opr == assignment_operator_type_add || next_ass_opr == assignment_operator_type_subtract)
-                    assignDataValue(&expr->result, &resList[i].result, next_ass_opr, true, true);
+                sp--;
+            break;
 
-                next_ass_opr = resList[i].next_ass_opr;
-            }
+        case program_opcode_and_then:
+            if (top->int_data <= 0)
+                pc = ins.arg;
+            else
+                sp--;
+            break;
 
-            if (next_ass_opr == assignment_operator_type_add || next_ass_opr == assignment_operator_type_subtract)
-                assignDataValue(&expr->result, &r.result, next_ass_opr, true, true);
+        default:
+            break;
         }
-        else
-            assignDataValue(&expr->result, &r.result, assignment_operator_type_assignment, true, true);
     }
+
+    out = programStack[0];
+    return true;
 }
 
 void FireSenseClass::testConditionsList()
@@ -1887,40 +2082,17 @@ void FireSenseClass::testConditionsList()
     {
         conditionMillis = millis();
 
+        // the time operands of all conditions are tested against the same time
+        tickTs = Firebase.getCurrentTime();
+        localtime_r(&tickTs, &tickTime);
+
+        struct data_value_info_t res;
+
         for (size_t i = 0; i < conditionsList.size(); i++)
         {
-            if (!timeReady)
-                break;
             delay(0);
             struct conditions_info_t *listItem = &conditionsList[i];
-            listItem->result = false;
-
-            next_comp_opr_t next_comp_opr = next_comp_opr_none;
-
-            for (size_t j = 0; j < listItem->conditions.size(); j++)
-            {
-                if (!timeReady)
-                    break;
-
-                delay(0);
-                struct condition_item_info_t *condition = &listItem->conditions[j];
-
-                testConditionItem(condition);
-
-                if (j == 0)
-                    listItem->result = condition->result;
-
-                if (next_comp_opr == next_comp_opr_or)
-                    listItem->result |= condition->result;
-                else if (next_comp_opr == next_comp_opr_and)
-                    listItem->result &= condition->result;
-                else
-                    listItem->result = condition->result;
-
-                next_comp_opr = condition->next_comp_opr;
-                if (next_comp_opr == next_comp_opr_or && listItem->result)
-                    break;
-            }
+            listItem->result = runProgram(listItem->program, res) && res.int_data > 0;
 
             if (listItem->result)
             {
@@ -1938,6 +2110,7 @@ void FireSenseClass::testConditionsList()
             channelsList[i].last_value = channelsList[i].current_value;
     }
 }
+
 void FireSenseClass::pauseStream()
 {
     if (!configReady() || !config->stream_fbdo)
@@ -2517,7 +2690,10 @@ void FireSenseClass::addCondition(struct firesense_condition_t cond, bool addToD
     }
 
     if (cond.IF.length() > 0)
+    {
+        compileCondition(conds);
         conditionsList.push_back(conds);
+    }
 
     delay(0);
     if (addToDatabase)
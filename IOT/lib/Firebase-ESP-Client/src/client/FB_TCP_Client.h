@@ -95,6 +95,9 @@ public:
   Firebase_TCP_Client()
   {
     _tcp_client = new ESP_SSLClient();
+#if defined(ESP_SSLCLIENT_HAS_MEMORY_CALLBACKS)
+    _tcp_client->setMemoryCallbacks(tlsMalloc, tlsFree);
+#endif
   };
 
   virtual ~Firebase_TCP_Client()
@@ -176,6 +179,9 @@ public:
 
       _x509 = new X509List(caCert);
       _tcp_client->setTrustAnchors(_x509);
+#if defined(ESP_SSL_FS_SUPPORTED)
+      _tcp_client->setCertStore(nullptr);
+#endif
 
       setCertType(firebase_cert_type_data);
     }
@@ -186,6 +192,19 @@ public:
     }
   }
 
+#if defined(ESP_SSL_FS_SUPPORTED)
+  /**
+   * Set the store that the issuer certificates are looked up.
+   * @param store The CertStore or TrustAnchorStore.
+   */
+  void setCertStore(CertStoreBase *store)
+  {
+    _tcp_client->setTrustAnchors(nullptr);
+    _tcp_client->setCertStore(store);
+    setCertType(firebase_cert_type_data);
+  }
+#endif
+
   /**
    * Set Root CA certificate to verify.
    * @param certFile The certificate file path.
@@ -219,6 +238,9 @@ public:
 
         _x509 = new X509List(der, len);
         _tcp_client->setTrustAnchors(_x509);
+#if defined(ESP_SSL_FS_SUPPORTED)
+        _tcp_client->setCertStore(nullptr);
+#endif
         _mbfs->delP(&der);
 
         setCertType(firebase_cert_type_file);
@@ -521,6 +543,11 @@ public:
     _host = host;
     _port = port;
     _tcp_client->setBufferSizes(_rx_size, _tx_size);
+#if defined(ESP_SSLCLIENT_HAS_CIPHER_PROFILES)
+    // the buffer sizes of the profile take precedence
+    if (_cipher_profile != esp_ssl_cipher_profile_default)
+      _tcp_client->setCipherProfile(_cipher_profile);
+#endif
     _last_error = 0;
     this->response_code = response_code;
     return true;
@@ -537,6 +564,29 @@ public:
     _tx_size = tx;
   }
 
+  /**
+   * Set the Max Fragment Length to negotiate.
+   * @param len The fragment length (512, 1024, 2048 or 4096) or 0 to disable.
+   * @param hosts The probe results that are shared by the clients.
+   * @param mutex The lock of the probe results.
+   */
+  void setMFLN(uint16_t len, MB_VECTOR<firebase_mfln_host_t> *hosts, firebase_mutex_t *mutex)
+  {
+    _mfln_size = len == 512 || len == 1024 || len == 2048 || len == 4096 ? len : 0;
+    _mfln_hosts = hosts;
+    _mfln_hosts_mutex = mutex;
+  }
+
+#if defined(ESP_SSLCLIENT_HAS_CIPHER_PROFILES)
+  void setCipherProfile(esp_ssl_cipher_profile profile)
+  {
+    // restore the default suites when the profile was removed
+    if (profile != _cipher_profile && profile == esp_ssl_cipher_profile_default)
+      _tcp_client->setCipherProfile(profile);
+    _cipher_profile = profile;
+  }
+#endif
+
   operator bool()
   {
     return connected();
@@ -585,6 +635,10 @@ public:
 
     _tcp_client->setClient(_basic_client);
     _tcp_client->setDebugLevel(2);
+
+    if (_mfln_size > 0 && _mfln_hosts && _mfln_hosts_mutex)
+      setMFLNBufferSizes();
+
     if (!_tcp_client->connect(_host.c_str(), _port))
       return setError(FIREBASE_ERROR_TCP_ERROR_CONNECTION_REFUSED);
 
@@ -660,6 +714,59 @@ public:
     return *response_code;
   }
 
+  // Find the cached probe result of the host, the caller holds the lock
+  int findMFLNHost()
+  {
+    for (size_t i = 0; i < _mfln_hosts->size(); i++)
+    {
+      firebase_mfln_host_t &h = (*_mfln_hosts)[i];
+      if (h.port == _port && h.probed == _mfln_size && strcmp(h.host.c_str(), _host.c_str()) == 0)
+        return i;
+    }
+    return -1;
+  }
+
+  void setMFLNBufferSizes()
+  {
+    // the result is copied, the vector can grow in other tasks after the lock was released
+    bool supported = false;
+
+    _mfln_hosts_mutex->lock();
+    int index = findMFLNHost();
+    if (index > -1)
+      supported = (*_mfln_hosts)[index].supported;
+    _mfln_hosts_mutex->unlock();
+
+    // the host is probed once, the result is shared by all clients,
+    // the probe that failed before the server answered is retried on the next connection
+    if (index < 0)
+    {
+      supported = _tcp_client->probeMaxFragmentLength(_host.c_str(), _port, _mfln_size);
+
+      if (_tcp_client->isMFLNProbeCompleted())
+      {
+        _mfln_hosts_mutex->lock();
+        if (findMFLNHost() < 0)
+        {
+          firebase_mfln_host_t h;
+          h.host = _host;
+          h.port = _port;
+          h.probed = _mfln_size;
+          h.supported = supported;
+          _mfln_hosts->push_back(h);
+        }
+        _mfln_hosts_mutex->unlock();
+      }
+    }
+
+    // BearSSL requests the fragment length of the receive buffer size,
+    // the host that does not support it sends the records up to 16k
+    if (supported)
+      _tcp_client->setBufferSizes(_mfln_size, _tx_size < _mfln_size ? _tx_size : _mfln_size);
+    else
+      _tcp_client->setBufferSizes(16384, _tx_size);
+  }
+
   size_t write(const uint8_t *data, size_t size)
   {
 
@@ -1142,6 +1249,9 @@ public:
   bool clockReady = false;
 
 private:
+  static void *tlsMalloc(size_t len) { return MB_Alloc::alloc(len, mb_alloc_sys_tls); }
+  static void tlsFree(void *ptr) { MB_Alloc::free(ptr); }
+
   // lwIP TCP Keepalive idle in seconds.
   int _tcpKeepIdleSeconds = -1;
   // lwIP TCP Keepalive interval in seconds.
@@ -1180,6 +1290,12 @@ private:
   int _last_error = 0;
   volatile bool _network_status = false;
   int _rx_size = 1024, _tx_size = 512;
+  uint16_t _mfln_size = 0;
+  MB_VECTOR<firebase_mfln_host_t> *_mfln_hosts = nullptr;
+  firebase_mutex_t *_mfln_hosts_mutex = nullptr;
+#if defined(ESP_SSLCLIENT_HAS_CIPHER_PROFILES)
+  esp_ssl_cipher_profile _cipher_profile = esp_ssl_cipher_profile_default;
+#endif
   int *response_code = nullptr;
   FirebaseConfig *_config = nullptr;
   FirebaseAuth *_auth = nullptr;
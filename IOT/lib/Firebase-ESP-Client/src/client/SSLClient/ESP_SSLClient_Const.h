@@ -55,6 +55,25 @@ enum esp_ssl_client_error_types
     esp_ssl_internal_error
 };
 
+// The memory allocator callbacks for the TLS buffers
+#define ESP_SSLCLIENT_HAS_MEMORY_CALLBACKS
+typedef void *(*esp_ssl_client_malloc_cb)(size_t len);
+typedef void (*esp_ssl_client_free_cb)(void *ptr);
+
+// The cipher suite order, ECDHE curves and buffer sizes that are set together
+#define ESP_SSLCLIENT_HAS_CIPHER_PROFILES
+enum esp_ssl_cipher_profile
+{
+    // the default suites and curves, the buffer sizes are not changed
+    esp_ssl_cipher_profile_default,
+    // ChaCha20-Poly1305 first, X25519/P-256 and the full size receive buffer
+    esp_ssl_cipher_profile_throughput,
+    // a few ECDHE suites, X25519/P-256 and the small buffers
+    esp_ssl_cipher_profile_low_ram,
+    // all suites and curves with the full size receive buffer
+    esp_ssl_cipher_profile_compat
+};
+
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
 
 static void esp_ssl_debug_print_prefix(const char *func_name, int level)
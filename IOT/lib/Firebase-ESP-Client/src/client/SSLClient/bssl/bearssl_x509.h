@@ -710,6 +710,8 @@ typedef struct {
 	const br_x509_trust_anchor* (*trust_anchor_dynamic)(void *ctx, void *hashed_dn, size_t hashed_dn_len);
 	/* And a chance to free any dynamically allocated TA returned from above */
 	void (*trust_anchor_dynamic_free)(void *ctx, const br_x509_trust_anchor *ta);
+	/* Dynamic trust anchor, the nth one (from 0) of those that share the hashed DN */
+	const br_x509_trust_anchor* (*trust_anchor_dynamic_nth)(void *ctx, void *hashed_dn, size_t hashed_dn_len, size_t n);
 
 	/*
 	 * Multi-hasher for the TBS.
@@ -797,6 +799,32 @@ br_x509_minimal_set_dynamic(br_x509_minimal_context *ctx, void *dynamic_ctx,
 	ctx->trust_anchor_dynamic_ctx = dynamic_ctx;
 	ctx->trust_anchor_dynamic = dynamic;
 	ctx->trust_anchor_dynamic_free = dynamic_free;
+	ctx->trust_anchor_dynamic_nth = 0;
+}
+
+/**
+ * \brief Set the optional dynamic trust anchor lookup callbacks for a store
+ * that may hold several anchors with the same hashed DN
+ *
+ * This is the same as `br_x509_minimal_set_dynamic()`, except that the lookup
+ * is called with n = 0, 1, 2... until it returns NULL or the returned anchor
+ * verifies the certificate signature. Each returned anchor is passed to the
+ * dynamic_free callback before the next one is requested.
+ *
+ * \param ctx                   context to initialise.
+ * \param dynamic_ctx           private context for the dynamic callback
+ * \param dynamic_nth           provides the nth trust_anchor* for a hashed_dn
+ * \param dynamic_free          allows deallocation of returned TA
+ */
+static inline void
+br_x509_minimal_set_dynamic_nth(br_x509_minimal_context *ctx, void *dynamic_ctx,
+	const br_x509_trust_anchor* (*dynamic_nth)(void *ctx, void *hashed_dn, size_t hashed_dn_len, size_t n),
+        void (*dynamic_free)(void *ctx, const br_x509_trust_anchor *ta))
+{
+	ctx->trust_anchor_dynamic_ctx = dynamic_ctx;
+	ctx->trust_anchor_dynamic = 0;
+	ctx->trust_anchor_dynamic_free = dynamic_free;
+	ctx->trust_anchor_dynamic_nth = dynamic_nth;
 }
 
 /**
@@ -1206,6 +1206,43 @@ br_x509_minimal_run(void *t0ctx)
 		}
 	}
 
+	/*
+	 * Dynamic trust anchor lookup by the issuer hash. With the nth
+	 * callback, every anchor with that hash is tried in turn.
+	 */
+	if (CTX->trust_anchor_dynamic || CTX->trust_anchor_dynamic_nth) {
+		const br_x509_trust_anchor *ta;
+		size_t n;
+		int err;
+
+		for (n = 0;; n ++) {
+			if (CTX->trust_anchor_dynamic_nth) {
+				ta = CTX->trust_anchor_dynamic_nth(
+					CTX->trust_anchor_dynamic_ctx,
+					CTX->saved_dn_hash, DNHASH_LEN, n);
+			} else if (n == 0) {
+				ta = CTX->trust_anchor_dynamic(
+					CTX->trust_anchor_dynamic_ctx,
+					CTX->saved_dn_hash, DNHASH_LEN);
+			} else {
+				ta = NULL;
+			}
+			if (ta == NULL) {
+				break;
+			}
+			err = (ta->flags & BR_X509_TA_CA)
+				? verify_signature(CTX, &ta->pkey) : -1;
+			if (CTX->trust_anchor_dynamic_free) {
+				CTX->trust_anchor_dynamic_free(
+					CTX->trust_anchor_dynamic_ctx, ta);
+			}
+			if (err == 0) {
+				CTX->err = BR_ERR_X509_OK;
+				T0_CO();
+			}
+		}
+	}
+
 				}
 				break;
 			case 25: {
@@ -273,6 +273,378 @@ namespace bssl
     cs->_x509 = nullptr;
   }
 
+  static const uint8_t ta_store_magic[4] = {'B', 'R', 'T', 'A'};
+  static const uint32_t ta_store_version = 1;
+
+  TrustAnchorStore::~TrustAnchorStore()
+  {
+    free(_blobName);
+    free(_record);
+  }
+
+  int TrustAnchorStore::_compareIndex(const void *a, const void *b)
+  {
+    return memcmp(static_cast<const TAIndex *>(a)->sha256, static_cast<const TAIndex *>(b)->sha256, 32);
+  }
+
+  int TrustAnchorStore::buildTrustAnchorStore(FS &fs, const char *pemFileName, const char *blobFileName)
+  {
+    File pem = fs.open(pemFileName, FILE_READ);
+    if (!pem)
+    {
+      return 0;
+    }
+
+    // Count the certificates to reserve the index space ahead of the records
+    uint32_t total = 0;
+    while (pem.available())
+    {
+      String line = pem.readStringUntil('\n');
+      if (line.startsWith(F("-----BEGIN CERTIFICATE")))
+      {
+        total++;
+      }
+    }
+
+    TAIndex *index = total ? (TAIndex *)calloc(total, sizeof(TAIndex)) : nullptr;
+    File blob = index ? fs.open(blobFileName, FILE_WRITE) : File();
+    if (!blob)
+    {
+      free(index);
+      pem.close();
+      return 0;
+    }
+
+    TAHeader header;
+    memcpy(header.magic, ta_store_magic, sizeof(header.magic));
+    header.version = ta_store_version;
+    header.count = 0;
+    blob.write((uint8_t *)&header, sizeof(header));
+    blob.write((uint8_t *)index, total * sizeof(TAIndex));
+
+    uint32_t offset = sizeof(TAHeader) + total * sizeof(TAIndex);
+    uint32_t count = 0;
+    String cert;
+    bool inCert = false;
+
+    pem.seek(0, SeekSet);
+    while (pem.available() && count < total)
+    {
+      String line = pem.readStringUntil('\n');
+      if (line.startsWith(F("-----BEGIN CERTIFICATE")))
+      {
+        inCert = true;
+        cert = "";
+      }
+
+      if (!inCert)
+      {
+        continue;
+      }
+
+      cert += line;
+      cert += '\n';
+
+      if (!line.startsWith(F("-----END CERTIFICATE")))
+      {
+        continue;
+      }
+
+      inCert = false;
+
+      // One certificate is decoded at a time
+      X509List *x509 = new (std::nothrow) X509List(cert.c_str());
+      const br_x509_trust_anchor *ta = x509 && x509->getCount() ? x509->getTrustAnchors() : nullptr;
+      if (ta && (ta->pkey.key_type == BR_KEYTYPE_RSA || ta->pkey.key_type == BR_KEYTYPE_EC))
+      {
+        TARecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.keyType = ta->pkey.key_type;
+        rec.flags = ta->flags;
+
+        if (rec.keyType == BR_KEYTYPE_RSA)
+        {
+          rec.len1 = ta->pkey.key.rsa.nlen;
+          rec.len2 = ta->pkey.key.rsa.elen;
+        }
+        else
+        {
+          rec.curve = ta->pkey.key.ec.curve;
+          rec.len1 = ta->pkey.key.ec.qlen;
+        }
+
+        // Keep the records 4 bytes aligned for the memory-mapped blob
+        uint32_t length = sizeof(rec) + rec.len1 + rec.len2;
+        uint8_t pad[3] = {0, 0, 0};
+        uint32_t padLen = (4 - (length & 3)) & 3;
+
+        blob.write((uint8_t *)&rec, sizeof(rec));
+        if (rec.keyType == BR_KEYTYPE_RSA)
+        {
+          blob.write(ta->pkey.key.rsa.n, rec.len1);
+          blob.write(ta->pkey.key.rsa.e, rec.len2);
+        }
+        else
+        {
+          blob.write(ta->pkey.key.ec.q, rec.len1);
+        }
+        blob.write(pad, padLen);
+
+        // The same hash as the x509 validator computes for the issuer DN
+        br_sha256_context sha256;
+        br_sha256_init(&sha256);
+        br_sha256_update(&sha256, ta->dn.data, ta->dn.len);
+        br_sha256_out(&sha256, index[count].sha256);
+        index[count].offset = offset;
+        index[count].length = length;
+
+        offset += length + padLen;
+        count++;
+      }
+      delete x509;
+    }
+    pem.close();
+
+    qsort(index, count, sizeof(TAIndex), _compareIndex);
+
+    header.count = count;
+    blob.seek(0, SeekSet);
+    blob.write((uint8_t *)&header, sizeof(header));
+    blob.write((uint8_t *)index, count * sizeof(TAIndex));
+    blob.close();
+    free(index);
+
+    return count;
+  }
+
+  int TrustAnchorStore::initTrustAnchorStore(const uint8_t *blob, size_t len)
+  {
+    TAHeader header;
+
+    _fs = nullptr;
+    _blob = nullptr;
+    _len = 0;
+    _count = 0;
+
+    if (!blob || len < sizeof(header))
+    {
+      return 0;
+    }
+
+    memcpy_P(&header, blob, sizeof(header));
+    if (memcmp(header.magic, ta_store_magic, sizeof(header.magic)) || header.version != ta_store_version ||
+        header.count > (len - sizeof(header)) / sizeof(TAIndex))
+    {
+      return 0;
+    }
+
+    _blob = blob;
+    _len = len;
+    _count = header.count;
+    return _count;
+  }
+
+  int TrustAnchorStore::initTrustAnchorStore(FS &fs, const char *blobFileName)
+  {
+    TAHeader header;
+
+    _fs = nullptr;
+    _blob = nullptr;
+    _len = 0;
+    _count = 0;
+
+    // In case initTrustAnchorStore called multiple times, don't leak old filename
+    free(_blobName);
+    _blobName = (char *)malloc(strlen_P(blobFileName) + 1);
+    if (!_blobName)
+    {
+      return 0;
+    }
+    memcpy_P(_blobName, blobFileName, strlen_P(blobFileName) + 1);
+
+    File blob = fs.open(_blobName, FILE_READ);
+    if (!blob)
+    {
+      return 0;
+    }
+
+    size_t len = blob.size();
+    if (len < sizeof(header) || blob.read((uint8_t *)&header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, ta_store_magic, sizeof(header.magic)) || header.version != ta_store_version ||
+        header.count > (len - sizeof(header)) / sizeof(TAIndex))
+    {
+      blob.close();
+      return 0;
+    }
+    blob.close();
+
+    _fs = &fs;
+    _len = len;
+    _count = header.count;
+    return _count;
+  }
+
+  void TrustAnchorStore::installCertStore(br_x509_minimal_context *ctx)
+  {
+    br_x509_minimal_set_dynamic_nth(ctx, (void *)this, findHashedTA, freeHashedTA);
+  }
+
+  bool TrustAnchorStore::_readIndex(File &blob, uint32_t i, TAIndex &ti)
+  {
+    uint32_t pos = sizeof(TAHeader) + i * sizeof(TAIndex);
+
+    if (_blob)
+    {
+      memcpy_P(&ti, _blob + pos, sizeof(ti));
+      return true;
+    }
+
+    return blob.seek(pos, SeekSet) && blob.read((uint8_t *)&ti, sizeof(ti)) == sizeof(ti);
+  }
+
+  bool TrustAnchorStore::_decodeRecord(const uint8_t *raw, uint32_t length)
+  {
+    TARecord rec;
+
+    if (length < sizeof(rec))
+    {
+      return false;
+    }
+
+    // The record may be in the flash of the memory blob
+    memcpy_P(&rec, raw, sizeof(rec));
+    if (length < sizeof(rec) + rec.len1 + rec.len2)
+    {
+      return false;
+    }
+
+    unsigned char *data = const_cast<unsigned char *>(raw + sizeof(rec));
+
+    // The DN is already hashed, the dynamic trust anchor is matched by the lookup
+    _ta.dn.data = _dn;
+    _ta.dn.len = sizeof(_dn);
+    _ta.flags = rec.flags;
+    _ta.pkey.key_type = rec.keyType;
+
+    if (rec.keyType == BR_KEYTYPE_RSA)
+    {
+      _ta.pkey.key.rsa.n = data;
+      _ta.pkey.key.rsa.nlen = rec.len1;
+      _ta.pkey.key.rsa.e = data + rec.len1;
+      _ta.pkey.key.rsa.elen = rec.len2;
+    }
+    else if (rec.keyType == BR_KEYTYPE_EC)
+    {
+      _ta.pkey.key.ec.curve = rec.curve;
+      _ta.pkey.key.ec.q = data;
+      _ta.pkey.key.ec.qlen = rec.len1;
+    }
+    else
+    {
+      return false;
+    }
+
+    return true;
+  }
+
+  const br_x509_trust_anchor *TrustAnchorStore::findHashedTA(void *ctx, void *hashed_dn, size_t len, size_t n)
+  {
+    TrustAnchorStore *ts = static_cast<TrustAnchorStore *>(ctx);
+    TAIndex ti;
+
+    if (!ts || len != sizeof(ti.sha256) || !ts->_count || (!ts->_blob && !ts->_fs) || n >= ts->_count)
+    {
+      return nullptr;
+    }
+
+    File blob;
+    if (!ts->_blob)
+    {
+      blob = ts->_fs->open(ts->_blobName, FILE_READ);
+      if (!blob)
+      {
+        return nullptr;
+      }
+    }
+
+    // Binary search of the first index entry with the hash, the entries
+    // with the same hash follow it in the sorted index
+    uint32_t lo = 0, hi = ts->_count;
+    bool found = false;
+    bool readError = false;
+    while (lo < hi)
+    {
+      uint32_t mid = lo + (hi - lo) / 2;
+
+      if (!ts->_readIndex(blob, mid, ti))
+      {
+        readError = true;
+        break;
+      }
+
+      if (memcmp(ti.sha256, hashed_dn, sizeof(ti.sha256)) < 0)
+      {
+        lo = mid + 1;
+      }
+      else
+      {
+        hi = mid;
+      }
+    }
+
+    // The nth entry with the hash
+    if (!readError && lo + n < ts->_count && ts->_readIndex(blob, lo + n, ti))
+    {
+      found = memcmp(ti.sha256, hashed_dn, sizeof(ti.sha256)) == 0;
+    }
+
+    // The record must be within the blob, after the index
+    uint32_t recordsStart = sizeof(TAHeader) + ts->_count * sizeof(TAIndex);
+    if (found && (ti.offset < recordsStart || ti.offset > ts->_len || ti.length > ts->_len - ti.offset))
+    {
+      found = false;
+    }
+
+    const uint8_t *raw = nullptr;
+    if (found)
+    {
+      if (ts->_blob)
+      {
+        raw = ts->_blob + ti.offset;
+      }
+      else
+      {
+        ts->_record = (uint8_t *)malloc(ti.length);
+        if (ts->_record && blob.seek(ti.offset, SeekSet) && blob.read(ts->_record, ti.length) == ti.length)
+        {
+          raw = ts->_record;
+        }
+      }
+    }
+
+    if (blob)
+    {
+      blob.close();
+    }
+
+    memcpy(ts->_dn, hashed_dn, sizeof(ts->_dn));
+    if (!raw || !ts->_decodeRecord(raw, ti.length))
+    {
+      freeHashedTA(ts, nullptr);
+      return nullptr;
+    }
+
+    return &ts->_ta;
+  }
+
+  void TrustAnchorStore::freeHashedTA(void *ctx, const br_x509_trust_anchor *ta)
+  {
+    TrustAnchorStore *ts = static_cast<TrustAnchorStore *>(ctx);
+    (void)ta; // Unused
+    free(ts->_record);
+    ts->_record = nullptr;
+  }
+
 }
 
 #endif
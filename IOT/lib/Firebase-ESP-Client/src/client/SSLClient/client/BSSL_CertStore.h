@@ -92,6 +92,84 @@ namespace bssl
     static CertInfo _preprocessCert(uint32_t length, uint32_t offset, const void *raw);
   };
 
+  // The trust anchors that were decoded in advance into a binary blob with the
+  // sorted index of subject DN hashes, the issuer is found with the binary search
+  // and no PEM or DER parsing is done at connect time.
+  // The anchors that share the subject DN (e.g. the renewed roots) are all tried.
+  //
+  // The blob layout (little endian, 4 bytes aligned)
+  //   header   "BRTA", version, count
+  //   index    count x TAIndex sorted by sha256
+  //   records  key type, flags, curve, 0, len1, len2 followed by
+  //            RSA n (len1 bytes) and e (len2 bytes) or EC q (len1 bytes)
+  class TrustAnchorStore : public CertStoreBase
+  {
+  public:
+    TrustAnchorStore(){};
+    ~TrustAnchorStore();
+
+    // Decode the PEM certificates file into the blob file, returns the number of trust anchors
+    static int buildTrustAnchorStore(FS &fs, const char *pemFileName, const char *blobFileName);
+
+    // Use the blob in RAM or memory-mapped flash, the blob is not copied
+    int initTrustAnchorStore(const uint8_t *blob, size_t len);
+
+    // Use the blob file, only the index entries and the matched record are read
+    int initTrustAnchorStore(FS &fs, const char *blobFileName);
+
+    // Installs the cert store into the X509 decoder (normally via static function callbacks)
+    void installCertStore(br_x509_minimal_context *ctx);
+
+    size_t count() const { return _count; }
+
+  protected:
+    FS *_fs = nullptr;
+    char *_blobName = nullptr;
+    const uint8_t *_blob = nullptr;
+    // the size of the blob in memory or of the blob file
+    size_t _len = 0;
+    uint32_t _count = 0;
+
+    // The trust anchor of the last lookup, its key points to the blob or _record
+    br_x509_trust_anchor _ta;
+    uint8_t _dn[32];
+    uint8_t *_record = nullptr;
+
+    static const br_x509_trust_anchor *findHashedTA(void *ctx, void *hashed_dn, size_t len, size_t n);
+    static void freeHashedTA(void *ctx, const br_x509_trust_anchor *ta);
+
+    class TAHeader
+    {
+    public:
+      uint8_t magic[4];
+      uint32_t version;
+      uint32_t count;
+    };
+
+    class TAIndex
+    {
+    public:
+      uint8_t sha256[32];
+      uint32_t offset;
+      uint32_t length;
+    };
+
+    class TARecord
+    {
+    public:
+      uint8_t keyType;
+      uint8_t flags;
+      uint8_t curve;
+      uint8_t reserved;
+      uint16_t len1;
+      uint16_t len2;
+    };
+
+    bool _readIndex(File &blob, uint32_t i, TAIndex &ti);
+    bool _decodeRecord(const uint8_t *raw, uint32_t length);
+    static int _compareIndex(const void *a, const void *b);
+  };
+
 };
 
 #endif
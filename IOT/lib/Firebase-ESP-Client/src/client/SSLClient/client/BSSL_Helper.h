@@ -158,6 +158,35 @@ static const uint16_t faster_suites_P[] PROGMEM = {
     BR_TLS_RSA_WITH_AES_256_CBC_SHA,
     BR_TLS_RSA_WITH_AES_128_CBC_SHA};
 
+// ChaCha20-Poly1305 is faster than the constant-time software AES where no AES hardware is used
+static const uint16_t throughput_suites_P[] PROGMEM = {
+#ifndef BEARSSL_SSL_BASIC
+    BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA,
+    BR_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA,
+    BR_TLS_RSA_WITH_AES_128_GCM_SHA256,
+#endif
+    BR_TLS_RSA_WITH_AES_128_CBC_SHA256,
+    BR_TLS_RSA_WITH_AES_128_CBC_SHA};
+
+// The short list for the small ClientHello and the AEAD suites only
+static const uint16_t low_ram_suites_P[] PROGMEM = {
+#ifndef BEARSSL_SSL_BASIC
+    BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
+    BR_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+    BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+#endif
+    BR_TLS_RSA_WITH_AES_128_CBC_SHA256};
+
+// X25519 and P-256, the ECDHE on P-384 and P-521 are much slower
+#define ESP_SSLCLIENT_FAST_CURVES ((uint32_t)1 << BR_EC_curve25519 | (uint32_t)1 << BR_EC_secp256r1)
+
 // Internal opaque structures, not needed by user applications
 namespace key_bssl
 {
@@ -569,6 +569,17 @@ void BSSL_SSL_Client::setBufferSizes(int recv, int xmit)
     _iobuf_out_size = xmit;
 }
 
+bool BSSL_SSL_Client::setMemoryCallbacks(esp_ssl_client_malloc_cb mallocCb, esp_ssl_client_free_cb freeCb)
+{
+    // The buffers in use must be freed by the allocator they were taken from.
+    if ((mallocCb == nullptr) != (freeCb == nullptr) || _iobuf_in || _iobuf_out || _cipher_list)
+        return false;
+
+    _malloc_cb = mallocCb;
+    _free_cb = freeCb;
+    return true;
+}
+
 int BSSL_SSL_Client::availableForWrite()
 {
     if (!mIsClientInitialized(false) || !_secure)
@@ -962,7 +973,9 @@ void BSSL_SSL_Client::setCertStore(CertStoreBase *certStore)
 // Set custom list of ciphers
 bool BSSL_SSL_Client::setCiphers(const uint16_t *cipherAry, int cipherCount)
 {
-    _cipher_list = reinterpret_cast<uint16_t *>(mallocImpl(cipherCount));
+    freeImpl(&_cipher_list);
+    _cipher_cnt = 0;
+    _cipher_list = reinterpret_cast<uint16_t *>(mallocImpl(cipherCount * sizeof(uint16_t)));
     if (!_cipher_list)
     {
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
@@ -985,6 +998,34 @@ bool BSSL_SSL_Client::setCiphersLessSecure()
     return setCiphers(faster_suites_P, sizeof(faster_suites_P) / sizeof(faster_suites_P[0]));
 }
 
+bool BSSL_SSL_Client::setCipherProfile(esp_ssl_cipher_profile profile)
+{
+    switch (profile)
+    {
+    case esp_ssl_cipher_profile_throughput:
+        _ec_curves = ESP_SSLCLIENT_FAST_CURVES;
+        setBufferSizes(16384, 2048);
+        return setCiphers(throughput_suites_P, sizeof(throughput_suites_P) / sizeof(throughput_suites_P[0]));
+
+    case esp_ssl_cipher_profile_low_ram:
+        _ec_curves = ESP_SSLCLIENT_FAST_CURVES;
+        setBufferSizes(1024, 512);
+        return setCiphers(low_ram_suites_P, sizeof(low_ram_suites_P) / sizeof(low_ram_suites_P[0]));
+
+    case esp_ssl_cipher_profile_compat:
+        _ec_curves = 0;
+        setBufferSizes(16384, 512);
+        return setCiphers(suites_P, sizeof(suites_P) / sizeof(suites_P[0]));
+
+    default:
+        // back to the default suites
+        _ec_curves = 0;
+        freeImpl(&_cipher_list);
+        _cipher_cnt = 0;
+        return true;
+    }
+}
+
 bool BSSL_SSL_Client::setSSLVersion(uint32_t min, uint32_t max)
 {
     if (((min != BR_TLS10) && (min != BR_TLS11) && (min != BR_TLS12)) ||
@@ -1022,6 +1063,8 @@ bool BSSL_SSL_Client::probeMaxFragmentLength(const String &host, uint16_t port,
     return BSSL_SSL_Client::probeMaxFragmentLength(host.c_str(), port, len);
 }
 
+bool BSSL_SSL_Client::isMFLNProbeCompleted() const { return _mfln_probe_completed; }
+
 size_t BSSL_SSL_Client::peekAvailable()
 {
     return available();
@@ -1271,12 +1314,15 @@ bool BSSL_SSL_Client::mProbeMaxFragmentLength(Client *probe, uint16_t len)
     if (!probe->connected() || (ret != 5) || (fragResp[0] != 0x16) || (fragResp[1] != 0x03) || (fragResp[2] != 0x03))
     {
         // Short read, not a HANDSHAKE or not TLS 1.2, so it's not supported
+        // Only the complete record header is the server's answer
+        _mfln_probe_completed = ret == 5;
         return send_abort(probe, supportsLen);
     }
     fragLen = (fragResp[3] << 8) | fragResp[4];
     if (fragLen < 4 + 2 + 32 + 1 + 2 + 1)
     {
         // Too short to have an extension
+        _mfln_probe_completed = true;
         return send_abort(probe, supportsLen);
     }
 
@@ -1299,6 +1345,7 @@ bool BSSL_SSL_Client::mProbeMaxFragmentLength(Client *probe, uint16_t len)
     if ((ret != 2) || (protoVer[0] != 0x03) || (protoVer[1] != 0x03))
     {
         // Short read or not tls 1.2, so can't do MFLN
+        _mfln_probe_completed = ret == 2;
         return send_abort(probe, supportsLen);
     }
 
@@ -1349,6 +1396,8 @@ bool BSSL_SSL_Client::mProbeMaxFragmentLength(Client *probe, uint16_t len)
     extLen = extBytes[1] | (extBytes[0] << 8);
     if ((extLen == 0) || (ret != 2))
     {
+        // No extensions at all is the server's answer, a short read is not
+        _mfln_probe_completed = ret == 2;
         return send_abort(probe, supportsLen);
     }
 
@@ -1373,6 +1422,7 @@ bool BSSL_SSL_Client::mProbeMaxFragmentLength(Client *probe, uint16_t len)
         if ((typeBytes[0] == 0x00) && (typeBytes[1] == 0x01))
         { // MFLN extension!
             // If present and 1-byte in length, it's supported
+            _mfln_probe_completed = true;
             return send_abort(probe, _extLen == 1 ? true : false);
         }
         // Skip the extension, move to next one
@@ -1384,11 +1434,16 @@ bool BSSL_SSL_Client::mProbeMaxFragmentLength(Client *probe, uint16_t len)
             return send_abort(probe, supportsLen);
         }
     }
+    // All extensions were parsed and none was MFLN
+    _mfln_probe_completed = true;
     return send_abort(probe, supportsLen);
 }
 
 bool BSSL_SSL_Client::mProbeMaxFragmentLength(const char *name, IPAddress ip, uint16_t port, uint16_t len)
 {
+    // Cleared until the server has answered the hello
+    _mfln_probe_completed = false;
+
     if (!mIsClientInitialized(false))
         return false;
 
@@ -1524,6 +1579,18 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
         return 0;
     }
 
+    // Limit the advertised curves after the X509 validator took the full EC implementation,
+    // the copy of EC implementation lives as long as the engine
+    if (_ec_curves && br_ssl_engine_get_ec(_eng))
+    {
+        _ec_impl = *br_ssl_engine_get_ec(_eng);
+        if (_ec_impl.supported_curves & _ec_curves)
+        {
+            _ec_impl.supported_curves &= _ec_curves;
+            br_ssl_engine_set_ec(_eng, &_ec_impl);
+        }
+    }
+
     br_ssl_engine_set_buffers_bidi(_eng, _iobuf_in, _iobuf_in_size, _iobuf_out, _iobuf_out_size);
     br_ssl_engine_set_versions(_eng, _tls_min, _tls_max);
 
@@ -2222,6 +2289,15 @@ void *BSSL_SSL_Client::mallocImpl(size_t len, bool clear)
 {
     void *p;
     size_t newLen = getReservedLen(len);
+
+    if (_malloc_cb)
+    {
+        p = _malloc_cb(newLen);
+        if (p && clear)
+            memset(p, 0, newLen);
+        return p;
+    }
+
 #if defined(BOARD_HAS_PSRAM) && defined(ESP_SSLCLIENT_USE_PSRAM)
 
     if (ESP.getPsramSize() > 0)
@@ -2260,7 +2336,10 @@ void BSSL_SSL_Client::freeImpl(void *ptr)
     void **p = reinterpret_cast<void **>(ptr);
     if (*p)
     {
-        free(*p);
+        if (_free_cb)
+            _free_cb(*p);
+        else
+            free(*p);
         *p = 0;
     }
 }
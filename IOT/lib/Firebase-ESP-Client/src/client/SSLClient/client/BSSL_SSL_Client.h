@@ -166,6 +166,8 @@ public:
 
     void setBufferSizes(int recv, int xmit);
 
+    bool setMemoryCallbacks(esp_ssl_client_malloc_cb mallocCb, esp_ssl_client_free_cb freeCb);
+
     operator bool() override { return connected() > 0; }
 
     int availableForWrite() override;
@@ -200,6 +202,8 @@ public:
 
     bool setCiphersLessSecure();
 
+    bool setCipherProfile(esp_ssl_cipher_profile profile);
+
     bool setSSLVersion(uint32_t min, uint32_t max);
 
     bool probeMaxFragmentLength(IPAddress ip, uint16_t port, uint16_t len);
@@ -208,6 +212,10 @@ public:
 
     bool probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len);
 
+    // true when the last probe got the server's answer, so a false result means unsupported
+    // rather than a DNS, connect or read failure
+    bool isMFLNProbeCompleted() const;
+
     size_t peekAvailable() EMBED_SSL_ENGINE_BASE_OVERRIDE;
 
     const char *peekBuffer() EMBED_SSL_ENGINE_BASE_OVERRIDE;
@@ -305,6 +313,8 @@ private:
 
     bool _is_connected = false;
 
+    bool _mfln_probe_completed = false;
+
     //  store the index of where we are writing in the buffer
     //  so we can send our records all at once to prevent
     //  weird timing issues
@@ -352,8 +362,15 @@ private:
 
     // Custom cipher list pointer or nullptr if default
     uint16_t *_cipher_list = nullptr;
+
+    esp_ssl_client_malloc_cb _malloc_cb = nullptr;
+    esp_ssl_client_free_cb _free_cb = nullptr;
     uint8_t _cipher_cnt = 0;
 
+    // The ECDHE curves to advertise or 0 for all curves of the EC implementation
+    uint32_t _ec_curves = 0;
+    br_ec_impl _ec_impl;
+
     // TLS ciphers allowed
     uint32_t _tls_min = BR_TLS10;
     uint32_t _tls_max = BR_TLS12;
@@ -301,6 +301,11 @@ void BSSL_TCP_Client::setBufferSizes(int recv, int xmit)
     _ssl_client.setBufferSizes(recv, xmit);
 }
 
+bool BSSL_TCP_Client::setMemoryCallbacks(esp_ssl_client_malloc_cb mallocCb, esp_ssl_client_free_cb freeCb)
+{
+    return _ssl_client.setMemoryCallbacks(mallocCb, freeCb);
+}
+
 int BSSL_TCP_Client::availableForWrite() { return _ssl_client.availableForWrite(); };
 
 void BSSL_TCP_Client::setSession(BearSSL_Session *session) { _ssl_client.setSession(session); };
@@ -374,6 +379,11 @@ bool BSSL_TCP_Client::setCiphersLessSecure()
     return _ssl_client.setCiphersLessSecure();
 }
 
+bool BSSL_TCP_Client::setCipherProfile(esp_ssl_cipher_profile profile)
+{
+    return _ssl_client.setCipherProfile(profile);
+}
+
 bool BSSL_TCP_Client::setSSLVersion(uint32_t min, uint32_t max)
 {
     return _ssl_client.setSSLVersion(min, max);
@@ -385,6 +395,8 @@ bool BSSL_TCP_Client::probeMaxFragmentLength(const char *hostname, uint16_t port
 
 bool BSSL_TCP_Client::probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len) { return _ssl_client.probeMaxFragmentLength(host, port, len); };
 
+bool BSSL_TCP_Client::isMFLNProbeCompleted() const { return _ssl_client.isMFLNProbeCompleted(); };
+
 // peek buffer API is present
 bool BSSL_TCP_Client::hasPeekBufferAPI() const { return true; }
 
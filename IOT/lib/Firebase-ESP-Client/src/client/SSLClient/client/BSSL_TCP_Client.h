@@ -342,6 +342,14 @@ public:
      */
     void setBufferSizes(int recv, int xmit);
 
+    /**
+     *  Sets the memory allocator for the TLS buffers.
+     *  @param mallocCb The allocate function.
+     *  @param freeCb The free function.
+     *  @return The callbacks were set or not, they cannot be changed while the buffers are allocated.
+     */
+    bool setMemoryCallbacks(esp_ssl_client_malloc_cb mallocCb, esp_ssl_client_free_cb freeCb);
+
     operator bool() override { return connected(); }
 
     int availableForWrite() override;
@@ -382,6 +390,23 @@ public:
 
     bool setCiphersLessSecure();
 
+    /**
+     * Set the cipher suite order, ECDHE curves and buffer sizes together.
+     *
+     * @param profile The esp_ssl_cipher_profile enum value.
+     * esp_ssl_cipher_profile_throughput - ChaCha20-Poly1305 first, X25519/P-256 and the 16k receive buffer.
+     * esp_ssl_cipher_profile_low_ram - a few AEAD suites, X25519/P-256 and the 1k receive buffer.
+     * esp_ssl_cipher_profile_compat - all suites and curves and the 16k receive buffer.
+     * esp_ssl_cipher_profile_default - the default suites and curves.
+     * @return The cipher list was set or not.
+     *
+     * @note The server with the ECDSA key on P-384 or P-521 cannot be connected with the throughput and low_ram profiles,
+     * the CA certificates on those curves are still verified.
+     * The low_ram receive buffer requires the server that supports the maximum fragment length negotiation
+     * or sends the small records.
+     */
+    bool setCipherProfile(esp_ssl_cipher_profile profile);
+
     bool setSSLVersion(uint32_t min = BR_TLS10, uint32_t max = BR_TLS12);
 
     bool probeMaxFragmentLength(IPAddress ip, uint16_t port, uint16_t len);
@@ -390,6 +415,14 @@ public:
 
     bool probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len);
 
+    /**
+     * Check whether the last probeMaxFragmentLength got the server answer.
+     * @return boolean status of the probe completion.
+     *
+     * When false, the probe result came from DNS, connect or read failure and should not be cached.
+     */
+    bool isMFLNProbeCompleted() const;
+
     bool hasPeekBufferAPI() const EMBED_SSL_ENGINE_BASE_OVERRIDE;
 
     size_t peekAvailable() EMBED_SSL_ENGINE_BASE_OVERRIDE;
@@ -60,6 +60,7 @@ void FirebaseCore::end()
     multi = nullptr;
 #endif
     freeClient(&tcpClient);
+    freeSignerKey();
 }
 
 bool FirebaseCore::parseSAFile()
@@ -134,6 +135,8 @@ bool FirebaseCore::parseSAFile()
 
 void FirebaseCore::clearServiceAccountCreds()
 {
+    freeSignerKey();
+
     if (config)
     {
         config->service_account.data.private_key = "";
@@ -252,6 +255,7 @@ bool FirebaseCore::checkAuthTypeChanged(FirebaseConfig *config, FirebaseAuth *au
         // reset token status and flags if auth type changed
         if (auth_changed)
         {
+            freeSignerKey();
             config->signer.tokens.status = token_status_uninitialized;
             config->signer.tokens.expires = 0;
             config->signer.idTokenCustomSet = false;
@@ -440,8 +444,8 @@ bool FirebaseCore::handleToken()
                     config->signer.anonymous)
                     return true;
 
-                // return when tcp client was used by other processes
-                if (internal.fb_processing)
+                // return when tcp client was used by other processes or the token is being renewed
+                if (internal.fb_processing || internal.fb_token_renewing)
                     return false;
 
                 // refresh new auth token
@@ -477,7 +481,7 @@ bool FirebaseCore::handleToken()
                     if (config->signer.step == firebase_jwt_generation_step_begin)
                     {
                         // if service account key json file assigned and no private key parsing data
-                        if (config->service_account.json.path.length() > 0 && config->signer.pk.length() == 0)
+                        if (config->service_account.json.path.length() > 0 && config->signer.pk.length() == 0 && !signerKey)
                         {
                             // if fail to parse the private key from service account json file, reset the token status
                             if (!parseSAFile())
@@ -805,23 +809,8 @@ bool FirebaseCore::refreshToken()
     if (!initClient(firebase_auth_pgm_str_9 /* "securetoken" */, token_status_on_refresh))
         return false;
 
-    jsonPtr->add(pgm2Str(firebase_auth_pgm_str_11 /* "grantType" */), pgm2Str(firebase_auth_pgm_str_12 /* "refresh_token" */));
-    jsonPtr->add(pgm2Str(firebase_auth_pgm_str_13 /* "refreshToken" */), internal.refresh_token.c_str());
-
     MB_String req;
-    hh.addRequestHeaderFirst(req, http_post);
-
-    req += firebase_auth_pgm_str_10; // "/v1/token?Key=""
-    req += config->api_key;
-    hh.addRequestHeaderLast(req);
-
-    hh.addGAPIsHostHeader(req, firebase_auth_pgm_str_9 /* "securetoken" */);
-    hh.addUAHeader(req);
-    hh.addContentLengthHeader(req, strlen(jsonPtr->raw()));
-    hh.addContentTypeHeader(req, firebase_pgm_str_62 /* "application/json" */);
-    hh.addNewLine(req);
-
-    req += jsonPtr->raw(); // {"grantType":"refresh_token","refreshToken":"<refresh token>"}
+    makeRefreshRequest(req, jsonPtr);
 
     tcpClient->send(req.c_str());
 
@@ -886,6 +875,228 @@ bool FirebaseCore::refreshToken()
     return true;
 }
 
+void FirebaseCore::makeRefreshRequest(MB_String &req, FirebaseJson *json)
+{
+    json->add(pgm2Str(firebase_auth_pgm_str_11 /* "grantType" */), pgm2Str(firebase_auth_pgm_str_12 /* "refresh_token" */));
+    json->add(pgm2Str(firebase_auth_pgm_str_13 /* "refreshToken" */), internal.refresh_token.c_str());
+
+    hh.addRequestHeaderFirst(req, http_post);
+
+    req += firebase_auth_pgm_str_10; // "/v1/token?Key=""
+    req += config->api_key;
+    hh.addRequestHeaderLast(req);
+
+    hh.addGAPIsHostHeader(req, firebase_auth_pgm_str_9 /* "securetoken" */);
+    hh.addUAHeader(req);
+    hh.addContentLengthHeader(req, strlen(json->raw()));
+    hh.addContentTypeHeader(req, firebase_pgm_str_62 /* "application/json" */);
+    hh.addNewLine(req);
+
+    req += json->raw(); // {"grantType":"refresh_token","refreshToken":"<refresh token>"}
+}
+
+bool FirebaseCore::readyToRenew()
+{
+    if (!config || !auth || config->signer.refreshRatio <= 0 || config->signer.test_mode)
+        return false;
+
+    // only the id token is renewed in the background, it is exchanged with the refresh token
+    // over the internal client which is not shared with the sessions
+    if (!isAuthToken(false) || config->signer.tokens.status != token_status_ready ||
+        internal.refresh_token.length() == 0 || internal.ltok_len > 0 ||
+        config->signer.tokens.lifetime == 0 || _cli_type != firebase_client_type_internal_basic_client)
+        return false;
+
+    if (internal.fb_token_renewing || internal.fb_token_renewed)
+        return false;
+
+    // detain the next renewal after failure
+    if (internal.fb_last_token_renew_millis > 0 && millis() - internal.fb_last_token_renew_millis < config->signer.reqTO)
+        return false;
+
+    float ratio = config->signer.refreshRatio > 1 ? 1 : config->signer.refreshRatio;
+
+    return millis() - config->signer.tokens.last_millis >= (unsigned long)(config->signer.tokens.lifetime * ratio) * 1000;
+}
+
+bool FirebaseCore::renewToken()
+{
+#if !defined(USE_LEGACY_TOKEN_ONLY) && !defined(FIREBASE_USE_LEGACY_TOKEN_ONLY)
+
+    // the token status and the processing flag are not changed then the current token is still used by the requests
+    internal.fb_token_renewing = true;
+    internal.fb_last_token_renew_millis = millis();
+
+    Firebase_TCP_Client *client = nullptr;
+    newClient(&client);
+
+    bool ret = false;
+    int code = 0;
+
+    if (client && reconnect(client, nullptr) && client->isInitialized())
+    {
+        client->setCACert(nullptr);
+        client->setBufferSizes(2048, 1024);
+        client->setMFLN(config->signer.mflnSize, &internal.mfln_hosts, &internal.mfln_hosts_mutex);
+
+        MB_String host;
+        hh.addGAPIsHost(host, firebase_auth_pgm_str_9 /* "securetoken" */);
+        client->begin(host.c_str(), 443, &code);
+
+        FirebaseJson json;
+        FirebaseJsonData result;
+        MB_String req;
+
+        // the refresh token is replaced by the swap in other task
+        lockToken();
+        makeRefreshRequest(req, &json);
+        unlockToken();
+        json.clear();
+
+        client->send(req.c_str());
+        req.clear();
+
+        int httpCode = 0;
+        if (code >= 0 && handleTokenResponse(client, &json, httpCode) && httpCode == FIREBASE_ERROR_HTTP_CODE_OK &&
+            jh.parse(&json, &result, firebase_auth_pgm_str_14 /* "id_token" */))
+        {
+            MB_String idToken = result.to<const char *>();
+            MB_String refreshToken;
+
+            if (jh.parse(&json, &result, firebase_auth_pgm_str_12 /* "refresh_token" */))
+                refreshToken = result.to<const char *>();
+
+            unsigned long lifetime = jh.parse(&json, &result, firebase_auth_pgm_str_15 /* "expires_in" */)
+                                         ? atoi(result.to<const char *>())
+                                         : config->signer.tokens.lifetime;
+
+            lockToken();
+            internal.renewed_auth_token = idToken;
+            internal.renewed_refresh_token = refreshToken.length() > 0 ? refreshToken : internal.refresh_token;
+            internal.renewed_lifetime = lifetime;
+            internal.renewed_millis = millis();
+            // the token is swapped by the next request of the owner task
+            internal.fb_token_renewed = true;
+            unlockToken();
+
+            ret = true;
+        }
+    }
+
+    if (client)
+        client->stop();
+    freeClient(&client);
+
+    internal.fb_token_renewing = false;
+
+    return ret;
+
+#endif
+
+    return false;
+}
+
+void FirebaseCore::swapRenewedToken()
+{
+    if (!internal.fb_token_renewed || !config)
+        return;
+
+#if defined(ESP32) || (defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS))
+    // only the loop task swaps, the stream and queue tasks keep using the current token until then
+    if (internal.token_owner_task_handle && xTaskGetCurrentTaskHandle() != internal.token_owner_task_handle)
+        return;
+#endif
+
+    lockToken();
+
+    // swap the buffers, the replaced token is still valid for the requests that are sending it
+    internal.auth_token.swap(internal.renewed_auth_token);
+    internal.atok_len = internal.auth_token.length();
+    internal.ltok_len = 0;
+    internal.refresh_token = internal.renewed_refresh_token;
+    internal.rtok_len = internal.refresh_token.length();
+    internal.renewed_refresh_token.clear();
+
+    config->signer.tokens.expires = getTime() - (millis() - internal.renewed_millis) / 1000 + internal.renewed_lifetime;
+    config->signer.tokens.last_millis = internal.renewed_millis;
+    config->signer.tokens.lifetime = internal.renewed_lifetime;
+
+    // the next renewal can't start before the swap was done
+    internal.fb_token_renewed = false;
+
+    unlockToken();
+}
+
+void FirebaseCore::lockToken()
+{
+#if defined(ESP32)
+    if (internal.token_renew_mutex)
+        xSemaphoreTake(internal.token_renew_mutex, portMAX_DELAY);
+#endif
+}
+
+void FirebaseCore::unlockToken()
+{
+#if defined(ESP32)
+    if (internal.token_renew_mutex)
+        xSemaphoreGive(internal.token_renew_mutex);
+#endif
+}
+
+void FirebaseCore::runTokenRenewTask()
+{
+#if defined(ESP32) || (defined(MB_ARDUINO_PICO) && defined(ENABLE_PICO_FREE_RTOS))
+    // Firebase.ready() is called from the loop task
+    if (!internal.token_owner_task_handle)
+        internal.token_owner_task_handle = xTaskGetCurrentTaskHandle();
+#endif
+
+#if defined(ESP32)
+
+    if (internal.token_renew_task_handle || !config || config->signer.refreshRatio <= 0)
+        return;
+
+    if (!internal.token_renew_mutex)
+        internal.token_renew_mutex = xSemaphoreCreateMutex();
+
+    TaskFunction_t taskCode = [](void *param)
+    {
+        const TickType_t xDelay = 1000 / portTICK_PERIOD_MS;
+        for (;;)
+        {
+            if (!Core.config || Core.config->signer.refreshRatio <= 0)
+                break;
+
+            if (Core.readyToRenew())
+                Core.renewToken();
+
+            vTaskDelay(xDelay);
+        }
+
+        Core.internal.token_renew_task_handle = NULL;
+        vTaskDelete(NULL);
+    };
+
+    xTaskCreatePinnedToCore(taskCode, "TokenRenew", TOKEN_RENEW_TASK_STACK_SIZE, NULL, 1,
+                            &internal.token_renew_task_handle, 1);
+
+#else
+
+    // renew the token in the loop
+    if (readyToRenew())
+        renewToken();
+
+#endif
+}
+
+void FirebaseCore::countRefreshStall()
+{
+    // called only from the request entry, the polling of the token status is not counted,
+    // the request that waits for the first token is not counted
+    if (config && config->signer.tokens.lifetime > 0)
+        internal.fb_token_refresh_stalls++;
+}
+
 void FirebaseCore::newClient(Firebase_TCP_Client **client)
 {
     freeClient(client);
@@ -1047,8 +1258,13 @@ void FirebaseCore::sendTokenStatusCB()
 
 bool FirebaseCore::handleTokenResponse(int &httpCode)
 {
+    return handleTokenResponse(tcpClient, jsonPtr, httpCode);
+}
 
-    if (!reconnect(tcpClient, nullptr))
+bool FirebaseCore::handleTokenResponse(Firebase_TCP_Client *client, FirebaseJson *json, int &httpCode)
+{
+
+    if (!reconnect(client, nullptr))
         return false;
 
     MB_String header, payload;
@@ -1056,12 +1272,12 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
     struct server_response_data_t response;
     struct firebase_tcp_response_handler_t tcpHandler;
 
-    hh.intTCPHandler(tcpClient, tcpHandler, 2048, 2048, nullptr, false);
+    hh.intTCPHandler(client, tcpHandler, 2048, 2048, nullptr, false);
 
-    while (tcpClient->connected() && tcpClient->available() == 0)
+    while (client->connected() && client->available() == 0)
     {
         FBUtils::idle();
-        if (!reconnect(tcpClient, nullptr, tcpHandler.dataTime))
+        if (!reconnect(client, nullptr, tcpHandler.dataTime))
             return false;
     }
 
@@ -1075,17 +1291,17 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
     {
         FBUtils::idle();
 
-        if (!reconnect(tcpClient, nullptr, tcpHandler.dataTime))
+        if (!reconnect(client, nullptr, tcpHandler.dataTime))
             return false;
 
-        if (!hh.readStatusLine(&sh, &mbfs, tcpClient, tcpHandler, response))
+        if (!hh.readStatusLine(&sh, &mbfs, client, tcpHandler, response))
         {
 
             // The next chunk data can be the remaining http header
             if (tcpHandler.isHeader)
             {
                 // Read header, complete?
-                if (hh.readHeader(&sh, &mbfs, tcpClient, tcpHandler, response))
+                if (hh.readHeader(&sh, &mbfs, client, tcpHandler, response))
                 {
                     if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
                         tcpHandler.error.code = 0;
@@ -1101,10 +1317,10 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
                 // Read the avilable data
                 // chunk transfer encoding?
                 if (response.isChunkedEnc)
-                    tcpHandler.bufferAvailable = hh.readChunkedData(&sh, &mbfs, tcpClient,
+                    tcpHandler.bufferAvailable = hh.readChunkedData(&sh, &mbfs, client,
                                                                     pChunk, nullptr, tcpHandler);
                 else
-                    tcpHandler.bufferAvailable = hh.readLine(tcpClient,
+                    tcpHandler.bufferAvailable = hh.readLine(client,
                                                              pChunk, tcpHandler.chunkBufSize);
 
                 if (tcpHandler.bufferAvailable > 0)
@@ -1126,19 +1342,19 @@ bool FirebaseCore::handleTokenResponse(int &httpCode)
     // To make sure all chunks read and
     // ready to send next request
     if (response.isChunkedEnc)
-        tcpClient->flush();
+        client->flush();
 
     mbfs.delP(&pChunk);
 
-    if (tcpClient->connected())
-        tcpClient->stop();
+    if (client->connected())
+        client->stop();
 
     httpCode = response.httpCode;
 
-    if (jsonPtr && payload.length() > 0 && !response.noContent)
+    if (json && payload.length() > 0 && !response.noContent)
     {
         // Just a simple JSON which is suitable for parsing in low memory device
-        jsonPtr->setJsonData(payload.c_str());
+        json->setJsonData(payload.c_str());
         payload.clear();
         return true;
     }
@@ -1303,33 +1519,30 @@ bool FirebaseCore::createJWT()
     {
         config->signer.tokens.status = token_status_on_signing;
 
-        // RSA private key
-        PrivateKey *pk = nullptr;
         FBUtils::idle();
-        // parse priv key
-        if (config->signer.pk.length() > 0)
-            pk = new PrivateKey((const char *)config->signer.pk.c_str());
-        else if (strlen_P(config->service_account.data.private_key) > 0)
-            pk = new PrivateKey((const char *)config->service_account.data.private_key);
+        // parse priv key, the parsed key is kept for the next token cycle
+        if (!signerKey)
+        {
+            if (config->signer.pk.length() > 0)
+                signerKey = new PrivateKey((const char *)config->signer.pk.c_str());
+            else if (strlen_P(config->service_account.data.private_key) > 0)
+                signerKey = new PrivateKey((const char *)config->service_account.data.private_key);
+        }
 
-        if (!pk)
+        if (!signerKey)
             return handleError(FIREBASE_ERROR_TOKEN_PARSE_PK, (const char *)FPSTR("BearSSL, PrivateKey: "));
 
-        if (!pk->isRSA())
+        if (!signerKey->isRSA())
         {
-            delete pk;
-            pk = nullptr;
+            freeSignerKey();
             return handleError(FIREBASE_ERROR_TOKEN_PARSE_PK, (const char *)FPSTR("BearSSL, isRSA: "));
         }
 
-        const br_rsa_private_key *br_rsa_key = pk->getRSA();
-
         // generate RSA signature from private key and message digest
-        config->signer.signature = new unsigned char[config->signer.signatureSize];
+        config->signer.signature = reinterpret_cast<unsigned char *>(mbfs.newP(config->signer.signatureSize));
 
         FBUtils::idle();
-        int ret = br_rsa_i15_pkcs1_sign(BR_HASH_OID_SHA256, (const unsigned char *)config->signer.hash,
-                                        br_sha256_SIZE, br_rsa_key, config->signer.signature);
+        int ret = signRSA(signerKey->getRSA(), (const unsigned char *)config->signer.hash, config->signer.signature);
         FBUtils::idle();
         mbfs.delP(&config->signer.hash);
 
@@ -1339,8 +1552,6 @@ bool FirebaseCore::createJWT()
         config->signer.encSignature = buf;
         mbfs.delP(&buf);
         mbfs.delP(&config->signer.signature);
-        delete pk;
-        pk = nullptr;
 
         // get the signed JWT
         if (ret > 0)
@@ -1350,7 +1561,7 @@ bool FirebaseCore::createJWT()
             config->signer.encSignature.clear();
         }
         else
-            return handleError(FIREBASE_ERROR_TOKEN_SIGN, (const char *)FPSTR("BearSSL, br_rsa_i15_pkcs1_sign: "));
+            return handleError(FIREBASE_ERROR_TOKEN_SIGN, (const char *)FPSTR("BearSSL, br_rsa_pkcs1_sign: "));
     }
 
 #endif
@@ -1358,6 +1569,85 @@ bool FirebaseCore::createJWT()
     return true;
 }
 
+int FirebaseCore::signRSA(const br_rsa_private_key *key, const unsigned char *hash, unsigned char *sig)
+{
+    firebase_rsa_engine engine = config->signer.rsaEngine != firebase_rsa_engine_auto ? config->signer.rsaEngine : internal.rsa_engine;
+
+    if (engine != firebase_rsa_engine_auto)
+    {
+        br_rsa_pkcs1_sign sign = getRSASign(engine);
+
+        // i62 is not available without the 64-bit multiplications
+        if (!sign)
+        {
+            engine = firebase_rsa_engine_i31;
+            sign = getRSASign(engine);
+        }
+
+        internal.rsa_engine = engine;
+        return sign(BR_HASH_OID_SHA256, hash, br_sha256_SIZE, key, sig);
+    }
+
+    // the opt-in benchmark, sign with each implementation and select the fastest one,
+    // the PKCS#1 v1.5 signature is deterministic then any of the results can be used
+    int ret = 0;
+    uint32_t best = 0;
+    internal.rsa_engine = firebase_rsa_engine_i15;
+
+    for (int i = firebase_rsa_engine_i15; i < firebase_rsa_engine_max; i++)
+    {
+        br_rsa_pkcs1_sign sign = getRSASign((firebase_rsa_engine)i);
+        internal.rsa_sign_us[i] = 0;
+
+        if (!sign)
+            continue;
+
+        FBUtils::idle();
+        unsigned long us = micros();
+        int res = sign(BR_HASH_OID_SHA256, hash, br_sha256_SIZE, key, sig);
+        us = micros() - us;
+
+        if (res <= 0)
+            continue;
+
+        internal.rsa_sign_us[i] = us > 0 ? us : 1;
+        ret = res;
+
+        if (best == 0 || internal.rsa_sign_us[i] < best)
+        {
+            best = internal.rsa_sign_us[i];
+            internal.rsa_engine = (firebase_rsa_engine)i;
+        }
+    }
+
+    return ret;
+}
+
+br_rsa_pkcs1_sign FirebaseCore::getRSASign(firebase_rsa_engine engine)
+{
+    switch (engine)
+    {
+    case firebase_rsa_engine_i15:
+        return &br_rsa_i15_pkcs1_sign;
+    case firebase_rsa_engine_i31:
+        return &br_rsa_i31_pkcs1_sign;
+    case firebase_rsa_engine_i32:
+        return &br_rsa_i32_pkcs1_sign;
+    case firebase_rsa_engine_i62:
+        // 0 when the 64-bit multiplications are not supported
+        return br_rsa_i62_pkcs1_sign_get();
+    default:
+        return 0;
+    }
+}
+
+void FirebaseCore::freeSignerKey()
+{
+    if (signerKey)
+        delete signerKey;
+    signerKey = nullptr;
+}
+
 bool FirebaseCore::getIdToken(bool createUser, MB_StringPtr email, MB_StringPtr password)
 {
 #if !defined(USE_LEGACY_TOKEN_ONLY) && !defined(FIREBASE_USE_LEGACY_TOKEN_ONLY)
@@ -1770,6 +2060,7 @@ bool FirebaseCore::initClient(PGM_P subDomain, firebase_auth_token_status status
         return handleTaskError(FIREBASE_ERROR_HTTP_CODE_REQUEST_TIMEOUT, FIREBASE_ERROR_EXTERNAL_CLIENT_NOT_INITIALIZED);
 
     tcpClient->setBufferSizes(2048, 1024);
+    tcpClient->setMFLN(config->signer.mflnSize, &internal.mfln_hosts, &internal.mfln_hosts_mutex);
 
     initJson();
 
@@ -1954,6 +2245,7 @@ void FirebaseCore::getExpiration(const char *exp)
     unsigned long ms = millis();
     config->signer.tokens.expires = now + atoi(exp);
     config->signer.tokens.last_millis = ms;
+    config->signer.tokens.lifetime = atoi(exp);
 }
 
 bool FirebaseCore::handleEmailSending(MB_StringPtr payload, firebase_user_email_sending_type type)
@@ -2059,18 +2351,27 @@ bool FirebaseCore::checkToken()
     return config->signer.tokens.status == token_status_ready;
 }
 
-bool FirebaseCore::tokenReady()
+bool FirebaseCore::tokenReady(bool request)
 {
     if (!config)
         return false;
 
+    swapRenewedToken();
+
     checkToken();
 
     // call checkToken to send callback before checking connection.
     if (!reconnect())
         return false;
 
-    return config->signer.tokens.status == token_status_ready;
+    if (config->signer.tokens.status != token_status_ready)
+    {
+        if (request)
+            countRefreshStall();
+        return false;
+    }
+
+    return true;
 };
 
 void FirebaseCore::errorToString(int httpCode, MB_String &buff)
@@ -2293,6 +2594,10 @@ void FirebaseCore::errorToString(int httpCode, MB_String &buff)
         return;
 #endif
 
+    case FIREBASE_ERROR_DOWNLOAD_CHECKSUM_MISMATCH:
+        buff += firebase_storage_err_pgm_str_6; // "downloaded data does not match the object checksum"
+        return;
+
     case FIREBASE_ERROR_NTP_TIMEOUT:
         buff += firebase_time_err_pgm_str_1; // "NTP server time reading timed out"
         break;
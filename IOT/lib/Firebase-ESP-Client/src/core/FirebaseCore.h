@@ -59,6 +59,8 @@ class FirebaseCore
     friend class FB_RTDB;
     friend class FirebaseData;
     friend class QueryFilter;
+    friend class RTDBBatch;
+    friend class RTDBAsyncPool;
 
 public:
     FirebaseCore();
@@ -87,6 +89,8 @@ private:
     struct token_info_t tokenInfo;
     bool authenticated = false;
     Firebase_TCP_Client *tcpClient = nullptr;
+    // the parsed service account private key
+    PrivateKey *signerKey = nullptr;
     FirebaseJson *jsonPtr = nullptr;
     FirebaseJsonData *resultPtr = nullptr;
     int response_code = 0;
@@ -133,6 +137,19 @@ private:
     bool isErrorCBTimeOut();
     /* handle the auth tokens generation */
     bool handleToken();
+    /* is the time to renew the token in the background */
+    bool readyToRenew();
+    /* exchange the refresh token for the new token without changing the token status */
+    bool renewToken();
+    /* swap the renewed token with the current token */
+    void swapRenewedToken();
+    /* lock the renewed token and the refresh token that are shared with the token renewal task */
+    void lockToken();
+    void unlockToken();
+    /* run the token renewal task (ESP32) or renew the token when it is the time */
+    void runTokenRenewTask();
+    /* count the request that was stalled by the token refresh */
+    void countRefreshStall();
     /* init the temp use Json objects */
     void initJson();
     /* free the temp use Json objects */
@@ -148,6 +165,8 @@ private:
 
     /* exchane the auth token with the refresh token */
     bool refreshToken();
+    /* build the refresh token request */
+    void makeRefreshRequest(MB_String &req, FirebaseJson *json);
     /* set the token status by error code */
     void setTokenError(int code);
     /* create new TCP client */
@@ -158,11 +177,18 @@ private:
     bool handleTaskError(int code, int httpCode = 0);
     // parse the auth token response
     bool handleTokenResponse(int &httpCode);
+    bool handleTokenResponse(Firebase_TCP_Client *client, FirebaseJson *json, int &httpCode);
     /* process the tokens (generation, signing, request and refresh) */
     void tokenProcessingTask();
     bool handleError(int code, const char *descr, int errNum = 0);
     /* encode and sign the JWT token */
     bool createJWT();
+    /* sign the message digest with the selected RSA implementation */
+    int signRSA(const br_rsa_private_key *key, const unsigned char *hash, unsigned char *sig);
+    /* get the PKCS#1 signing function of RSA implementation */
+    br_rsa_pkcs1_sign getRSASign(firebase_rsa_engine engine);
+    /* free the parsed private key */
+    void freeSignerKey();
     /* verifying the user with email/passwod to get id token */
     bool getIdToken(bool createUser, MB_StringPtr email, MB_StringPtr password);
     /* delete id token */
@@ -177,8 +203,9 @@ private:
     bool handleEmailSending(MB_StringPtr payload, firebase_user_email_sending_type type);
     /* return error string from code */
     void errorToString(int httpCode, MB_String &buff);
-    /* check the token ready status and process the token tasks and returns the status */
-    bool tokenReady();
+    /* check the token ready status and process the token tasks and returns the status,
+    the request that found the token not ready is counted as the refresh stall */
+    bool tokenReady(bool request = false);
     /* error status callback */
     void sendTokenStatusCB();
     /* get auth token */
@@ -0,0 +1,188 @@
+/**
+ * Google's Cloud Firestore DocumentPager class, DocumentPager.cpp version 1.0.0
+ *
+ * Created October 19, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_FIRESTORE) || defined(FIREBASE_ENABLE_FIRESTORE)
+
+#ifndef FIREBASE_DOCUMENT_PAGER_CPP
+#define FIREBASE_DOCUMENT_PAGER_CPP
+
+#include "DocumentPager.h"
+#include "FB_Firestore.h"
+
+DocumentPager::DocumentPager()
+{
+}
+
+DocumentPager::~DocumentPager()
+{
+    clear();
+}
+
+bool DocumentPager::next()
+{
+    if (!_cfs || !_fbdo)
+        return false;
+
+    // the consumed document is freed
+    if (_pos > 0)
+        _pages[_cur].documents[_pos - 1].clear();
+
+    // the page can be empty while the next page token was returned
+    while (_pos >= _pages[_cur].documents.size())
+    {
+        if (!fetch())
+            return false;
+    }
+
+    _pos++;
+    _index++;
+
+    // the next page is read as soon as its response was arrived, no more than two pages are kept,
+    // the failed page is requested again when this page was consumed
+    if (_pending && !_fetched && _fbdo->tcpClient.available() > 0)
+        readPage();
+
+    return true;
+}
+
+const char *DocumentPager::document()
+{
+    struct firebase_firestore_page_t &page = _pages[_cur];
+    return _pos > 0 && _pos <= page.documents.size() ? page.documents[_pos - 1].c_str() : "";
+}
+
+void DocumentPager::clear()
+{
+    if (_cfs && _pending)
+        _cfs->mStopPager(this);
+
+    freePage(_pages[0]);
+    freePage(_pages[1]);
+    _req.pageToken.clear();
+    _cur = 0;
+    _pos = 0;
+    _index = 0;
+    _pending = false;
+    _fetched = false;
+    _last = false;
+    _complete = false;
+    _error.clear();
+    _httpCode = 0;
+}
+
+bool DocumentPager::fetch()
+{
+    freePage(_pages[_cur]);
+    _pos = 0;
+
+    if (!_fetched)
+    {
+        // no more page
+        if (_last)
+        {
+            _complete = true;
+            return false;
+        }
+
+        // the page that was failed to request or read is requested again with the same page token
+        if ((!_pending && !sendPage()) || !readPage())
+            return false;
+    }
+
+    _cur = 1 - _cur;
+    _fetched = false;
+
+    // the following page is requested while this page is consumed
+    if (!_last)
+        sendPage();
+
+    return true;
+}
+
+bool DocumentPager::sendPage()
+{
+    if (!_cfs->mSendPage(this))
+        setError();
+    return _pending;
+}
+
+bool DocumentPager::readPage()
+{
+    _pending = false;
+    _fetched = _cfs->mReadPage(this);
+
+    if (_fetched)
+    {
+        _error.clear();
+        _httpCode = 0;
+    }
+    else
+        setError();
+
+    return _fetched;
+}
+
+void DocumentPager::setError()
+{
+    _httpCode = _fbdo->httpCode();
+    _error = _fbdo->errorReason().c_str();
+
+    // the response of the failed request may be partly read
+    _fbdo->closeSession();
+}
+
+void DocumentPager::freePage(struct firebase_firestore_page_t &page)
+{
+    MB_VECTOR<MB_String>().swap(page.documents);
+    page.outer.clear();
+}
+
+void DocumentPager::getPageToken(const MB_String &outer, MB_String &token)
+{
+    // {"documents":,"nextPageToken":"token"}
+    token.clear();
+
+    size_t p = outer.find(MB_String(firebase_cfs_pgm_str_56 /* "\"nextPageToken\"" */));
+    if (p == MB_String::npos)
+        return;
+
+    p = outer.find(':', p);
+    if (p != MB_String::npos)
+        p = outer.find('"', p);
+    if (p == MB_String::npos)
+        return;
+
+    size_t e = outer.find('"', p + 1);
+    if (e != MB_String::npos)
+        token = outer.substr(p + 1, e - p - 1);
+}
+
+#endif
+
+#endif // ENABLE
@@ -0,0 +1,133 @@
+
+/**
+ * Google's Cloud Firestore DocumentPager class, DocumentPager.h version 1.0.0
+ *
+ * Created October 19, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_FIRESTORE) || defined(FIREBASE_ENABLE_FIRESTORE)
+
+#ifndef FIREBASE_DOCUMENT_PAGER_H
+#define FIREBASE_DOCUMENT_PAGER_H
+#include <Arduino.h>
+#include "./FB_Utils.h"
+#include "./core/FirebaseCore.h"
+
+using namespace mb_string;
+
+class FB_Firestore;
+class FirebaseData;
+
+/* Lists the documents of the collection one document at a time, the next page is requested while the current page is consumed */
+class DocumentPager
+{
+    friend class FB_Firestore;
+
+public:
+    DocumentPager();
+    ~DocumentPager();
+
+    /** Move to the next document.
+     *
+     * @return Boolean value, indicates the document is available.
+     *
+     * @note The pager should be assigned with Firebase.Firestore.beginPager before use.
+     * When the current page was consumed, this waits for the response of the next page which was already requested.
+     * Use isComplete() to check whether all documents were listed or the listing was failed,
+     * see errorReason() and httpCode() for the failure.
+     * When the page was failed to request or read, calling next() again requests that page again and the listing
+     * continues from the failed page.
+     */
+    bool next();
+
+    /** Get the current document.
+     *
+     * @return The JSON text of the Document object which is valid until the next call of next().
+     */
+    const char *document();
+
+    /** Get the index of the current document in the listing.
+     *
+     * @return The index of the current document.
+     */
+    size_t index() { return _index > 0 ? _index - 1 : 0; }
+
+    /** Get the status of the listing.
+     *
+     * @return Boolean value, indicates all documents were listed.
+     */
+    bool isComplete() { return _complete; }
+
+    /** Get the error reason of the last failed page.
+     *
+     * @return The error reason string or empty string when the last page was read.
+     */
+    String errorReason() { return _error.c_str(); }
+
+    /** Get the http code or the error code of the last failed page.
+     *
+     * @return The http code or error code, 0 when the last page was read.
+     */
+    int httpCode() { return _httpCode; }
+
+    /** Stop the listing and free the pages.
+     *
+     * @note The response of the requested page that was not read is discarded by closing the session.
+     */
+    void clear();
+
+private:
+    FB_Firestore *_cfs = nullptr;
+    FirebaseData *_fbdo = nullptr;
+    struct firebase_firestore_req_t _req;
+    // the current page and the next page
+    struct firebase_firestore_page_t _pages[2];
+    uint8_t _cur = 0;
+    // the number of documents of the current page that were consumed
+    size_t _pos = 0;
+    size_t _index = 0;
+    // the request of the next page was sent but its response was not read
+    bool _pending = false;
+    // the response of the next page was read
+    bool _fetched = false;
+    // the page without the next page token was read
+    bool _last = false;
+    bool _complete = false;
+    // the error of the page that was failed to request or read
+    MB_String _error;
+    int _httpCode = 0;
+
+    bool fetch();
+    bool readPage();
+    bool sendPage();
+    void setError();
+    void freePage(struct firebase_firestore_page_t &page);
+    void getPageToken(const MB_String &outer, MB_String &token);
+};
+
+#endif
+
+#endif // ENABLE
@@ -74,8 +74,7 @@ bool FB_Firestore::mImportExportDocuments(FirebaseData *fbdo, MB_StringPtr proje
                       uriPrefix);
     Core.jh.addTokens(&Core.sh,fbdo->session.jsonPtr, firebase_cfs_pgm_str_2 /* "collectionIds" */, MB_String(collectionIds));
 
-    Core.jh.toString(fbdo->session.jsonPtr, req.payload, true);
-    fbdo->clearJson();
+    req.json = fbdo->session.jsonPtr;
     return sendRequest(fbdo, &req);
 }
 
@@ -189,8 +188,7 @@ bool FB_Firestore::mCommitDocument(FirebaseData *fbdo, MB_StringPtr projectId, M
     if (writes.size() > 0)
     {
         Core.jh.addString(fbdo->session.jsonPtr, firebase_cfs_pgm_str_28 /* "transaction" */, MB_String(transaction));
-        Core.jh.toString(fbdo->session.jsonPtr, req.payload, true);
-        fbdo->clearJson();
+        req.json = fbdo->session.jsonPtr;
     }
 
     return sendRequest(fbdo, &req);
@@ -209,8 +207,7 @@ bool FB_Firestore::mBatchWrite(FirebaseData *fbdo, MB_StringPtr projectId, MB_St
     {
         if (labels)
             Core.jh.addObject(fbdo->session.jsonPtr, firebase_pgm_str_64 /* "labels" */, labels, false);
-        Core.jh.toString(fbdo->session.jsonPtr, req.payload, true);
-        fbdo->clearJson();
+        req.json = fbdo->session.jsonPtr;
     }
 
     return sendRequest(fbdo, &req);
@@ -308,20 +305,24 @@ void FB_Firestore::parseWrites(FirebaseData *fbdo, MB_VECTOR<struct firebase_fir
 bool FB_Firestore::mGetDocument(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
                                 MB_StringPtr documentPath, MB_StringPtr mask, MB_StringPtr transaction,
                                 FirebaseJson *newTransaction, MB_StringPtr readTime,
-                                FirebaseData::FirestoreBatchOperationsCallback batchOperationCallback)
+                                FirebaseData::FirestoreBatchOperationsCallback batchOperationCallback,
+                                CFS_ResultCallback resultCallback)
 {
     struct firebase_firestore_req_t req;
 
-    makeRequest(req, batchOperationCallback ? firebase_firestore_request_type_batch_get_doc : firebase_firestore_request_type_get_doc,
+    bool batch = batchOperationCallback || resultCallback;
+
+    makeRequest(req, batch ? firebase_firestore_request_type_batch_get_doc : firebase_firestore_request_type_get_doc,
                 projectId, databaseId, toStringPtr(""), toStringPtr(""));
 
     req.documentPath = documentPath;
     req.mask = mask;
     req.transaction = transaction;
     req.readTime = readTime;
-    if (batchOperationCallback)
+    if (batch)
     {
         req.responseCallback = (FB_ResponseCallback)batchOperationCallback;
+        req.resultCallback = resultCallback;
 
         MB_String docPathBase = Core.ut.makeDocPath(req, Core.config->service_account.data.project_id);
         docPathBase += firebase_pgm_str_1; /* "/" */
@@ -343,7 +344,7 @@ bool FB_Firestore::mGetDocument(FirebaseData *fbdo, MB_StringPtr projectId, MB_S
             Core.jh.addString(fbdo->session.jsonPtr, firebase_cfs_pgm_str_28 /* "transaction" */, req.transaction);
         else if (req.readTime.length() > 0)
             Core.jh.addString(fbdo->session.jsonPtr, firebase_cfs_pgm_str_24 /* "readTime" */, req.readTime);
-        Core.jh.toString(fbdo->session.jsonPtr, req.payload, false);
+        req.json = fbdo->session.jsonPtr;
     }
 
     return sendRequest(fbdo, &req);
@@ -364,7 +365,7 @@ bool FB_Firestore::mBeginTransaction(FirebaseData *fbdo, MB_StringPtr projectId,
                           transactionOptions->readWrite.retryTransaction);
     }
 
-    Core.jh.toString(fbdo->session.jsonPtr, req.payload, true);
+    req.json = fbdo->session.jsonPtr;
     return sendRequest(fbdo, &req);
 }
 
@@ -375,17 +376,19 @@ bool FB_Firestore::mRollback(FirebaseData *fbdo, MB_StringPtr projectId, MB_Stri
     req.async = false;
     fbdo->initJson();
     Core.jh.addString(fbdo->session.jsonPtr, firebase_cfs_pgm_str_28 /* "transaction" */, MB_String(transaction));
-    Core.jh.toString(fbdo->session.jsonPtr, req.payload, true);
+    req.json = fbdo->session.jsonPtr;
     return sendRequest(fbdo, &req);
 }
 
 bool FB_Firestore::mRunQuery(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
                              MB_StringPtr documentPath, FirebaseJson *structuredQuery,
-                             firebase_firestore_consistency_mode consistencyMode, MB_StringPtr consistency)
+                             firebase_firestore_consistency_mode consistencyMode, MB_StringPtr consistency,
+                             CFS_ResultCallback resultCallback)
 {
     struct firebase_firestore_req_t req;
     makeRequest(req, firebase_firestore_request_type_run_query, projectId, databaseId, toStringPtr(""), toStringPtr(""));
     req.documentPath = documentPath;
+    req.resultCallback = resultCallback;
     fbdo->initJson();
     if (consistencyMode != firebase_firestore_consistency_mode_undefined)
     {
@@ -397,7 +400,7 @@ bool FB_Firestore::mRunQuery(FirebaseData *fbdo, MB_StringPtr projectId, MB_Stri
             Core.jh.addString(fbdo->session.jsonPtr, firebase_cfs_pgm_str_24 /* "readTime" */, MB_String(consistency));
     }
     Core.jh.addObject(fbdo->session.jsonPtr, firebase_cfs_pgm_str_27 /* "structuredQuery" */, structuredQuery, false);
-    Core.jh.toString(fbdo->session.jsonPtr, req.payload, true);
+    req.json = fbdo->session.jsonPtr;
     return sendRequest(fbdo, &req);
 }
 
@@ -426,6 +429,62 @@ bool FB_Firestore::mListDocuments(FirebaseData *fbdo, MB_StringPtr projectId, MB
     return sendRequest(fbdo, &req);
 }
 
+bool FB_Firestore::mBeginPager(FirebaseData *fbdo, DocumentPager *pager, MB_StringPtr projectId,
+                               MB_StringPtr databaseId, MB_StringPtr collectionId, MB_StringPtr pageSize,
+                               MB_StringPtr orderBy, MB_StringPtr mask, bool showMissing)
+{
+    if (!pager)
+        return false;
+
+    pager->clear();
+    pager->_cfs = this;
+    pager->_fbdo = fbdo;
+
+    makeRequest(pager->_req, firebase_firestore_request_type_list_doc, projectId, databaseId, toStringPtr(""), collectionId);
+    pager->_req.pageSize = atoi(stringPtr2Str(pageSize));
+    pager->_req.orderBy = orderBy;
+    pager->_req.mask = mask;
+    pager->_req.showMissing = showMissing;
+    // the response is read when the page is needed
+    pager->_req.deferred = true;
+
+    return pager->sendPage();
+}
+
+bool FB_Firestore::mSendPage(DocumentPager *pager)
+{
+    pager->_pending = sendRequest(pager->_fbdo, &pager->_req);
+    return pager->_pending;
+}
+
+bool FB_Firestore::mReadPage(DocumentPager *pager)
+{
+    struct firebase_firestore_page_t &page = pager->_pages[1 - pager->_cur];
+
+    pager->_req.page = &page;
+    bool ret = handleResponse(pager->_fbdo, &pager->_req);
+    pager->_req.page = nullptr;
+
+    if (ret)
+    {
+        pager->getPageToken(page.outer, pager->_req.pageToken);
+        pager->_last = pager->_req.pageToken.length() == 0;
+    }
+    else
+        pager->freePage(page);
+
+    page.outer.clear();
+
+    return ret;
+}
+
+void FB_Firestore::mStopPager(DocumentPager *pager)
+{
+    // the unread response can't be skipped
+    if (pager->_fbdo)
+        pager->_fbdo->closeSession();
+}
+
 bool FB_Firestore::mListCollectionIds(FirebaseData *fbdo, MB_StringPtr projectId,
                                       MB_StringPtr databaseId, MB_StringPtr documentPath, MB_StringPtr pageSize,
                                       MB_StringPtr pageToken)
@@ -436,7 +495,7 @@ bool FB_Firestore::mListCollectionIds(FirebaseData *fbdo, MB_StringPtr projectId
     fbdo->initJson();
     Core.jh.addNumberString(fbdo->session.jsonPtr, firebase_pgm_str_63 /* "pageSize" */, MB_String(pageSize));
     Core.jh.addString(fbdo->session.jsonPtr, firebase_pgm_str_65 /* pageToken" */, stringPtr2Str(pageToken));
-    Core.jh.toString(fbdo->session.jsonPtr, req.payload, true);
+    req.json = fbdo->session.jsonPtr;
     return sendRequest(fbdo, &req);
 }
 
@@ -451,7 +510,7 @@ bool FB_Firestore::mCreateIndex(FirebaseData *fbdo, MB_StringPtr projectId, MB_S
     Core.jh.addString(fbdo->session.jsonPtr, firebase_cfs_pgm_str_30 /* apiScope" */, stringPtr2Str(apiScope));
     Core.jh.addArray(fbdo->session.jsonPtr, firebase_cfs_pgm_str_31 /* fields" */, fields, false);
 
-    Core.jh.toString(fbdo->session.jsonPtr, req.payload, true);
+    req.json = fbdo->session.jsonPtr;
     return sendRequest(fbdo, &req);
 }
 
@@ -491,7 +550,7 @@ bool FB_Firestore::sendRequest(FirebaseData *fbdo, struct firebase_firestore_req
         return true;
 #endif
 
-    if (!fbdo->reconnect() || !Core.tokenReady())
+    if (!fbdo->reconnect() || !Core.tokenReady(true))
         return false;
 
     if (fbdo->session.long_running_task > 0)
@@ -518,6 +577,10 @@ bool FB_Firestore::sendRequest(FirebaseData *fbdo, struct firebase_firestore_req
     if (!ret)
         fbdo->closeSession();
 
+    // the JSON payload was already written to the socket
+    if (req->json)
+        fbdo->clearJson();
+
     Core.internal.fb_processing = false;
 
     return ret;
@@ -525,7 +588,8 @@ bool FB_Firestore::sendRequest(FirebaseData *fbdo, struct firebase_firestore_req
 
 bool FB_Firestore::firestore_sendRequest(FirebaseData *fbdo, struct firebase_firestore_req_t *req)
 {
-    fbdo->_responseCallback = req->responseCallback;
+    // the decoded results are passed to the result callback instead
+    fbdo->_responseCallback = req->resultCallback ? NULL : req->responseCallback;
     bool ret = false;
     bool hasParam = false;
     MB_String header;
@@ -674,10 +738,13 @@ bool FB_Firestore::firestore_sendRequest(FirebaseData *fbdo, struct firebase_fir
 
     Core.hh.addRequestHeaderLast(header);
 
-    if (req->payload.length() > 0 && (method == http_post || method == http_patch))
+    // The length of JSON payload is counted without serializing it.
+    size_t payloadLen = req->json ? req->json->serializedBufferLength() : req->payload.length();
+
+    if (payloadLen > 0 && (method == http_post || method == http_patch))
     {
         Core.hh.addContentTypeHeader(header, firebase_pgm_str_62 /* "application/json" */);
-        Core.hh.addContentLengthHeader(header, req->payload.length());
+        Core.hh.addContentLengthHeader(header, payloadLen);
     }
 
     Core.hh.addGAPIsHostHeader(header, firebase_cfs_pgm_str_55 /* "firestore." */);
@@ -714,17 +781,18 @@ bool FB_Firestore::firestore_sendRequest(FirebaseData *fbdo, struct firebase_fir
     if (fbdo->session.response.code < 0)
         return false;
 
-    if (fbdo->session.response.code > 0 && req->payload.length() > 0 &&
+    if (fbdo->session.response.code > 0 && payloadLen > 0 &&
         (method == http_post || method == http_patch))
     {
         if (req->uploadCallback)
         {
-            req->size = req->payload.length();
+            req->size = payloadLen;
             CFS_UploadStatusInfo in;
             in.status = firebase_cfs_upload_status_init;
             in.size = req->size;
             sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
-            ret = tcpSend(fbdo, req->payload.c_str(), req);
+            // the JSON payload is streamed from req->json, the payload string is empty then
+            ret = tcpSend(fbdo, req->json ? nullptr : req->payload.c_str(), req);
             if (ret > 0)
             {
                 CFS_UploadStatusInfo in;
@@ -740,11 +808,13 @@ bool FB_Firestore::firestore_sendRequest(FirebaseData *fbdo, struct firebase_fir
                 sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
             }
         }
+        else if (req->json)
+            tcpSend(fbdo, nullptr, req);
         else
             fbdo->tcpClient.send(req->payload.c_str());
     }
 
-    if (fbdo->session.response.code > 0 && (fbdo->session.cfs.async || handleResponse(fbdo, req)))
+    if (fbdo->session.response.code > 0 && (fbdo->session.cfs.async || req->deferred || handleResponse(fbdo, req)))
         return true;
 
     return false;
@@ -794,6 +864,10 @@ bool FB_Firestore::handleResponse(FirebaseData *fbdo, struct firebase_firestore_
 
     bool complete = false;
 
+    // the results array is decoded as it was received instead of keeping the whole payload
+    firebase_json_array_decoder_t decoder;
+    MB_String chunk;
+
     while (tcpHandler.available() > 0 /* data available to read payload */ ||
            tcpHandler.payloadRead < response.contentLen /* incomplete content read  */ || !complete)
     {
@@ -811,12 +885,21 @@ bool FB_Firestore::handleResponse(FirebaseData *fbdo, struct firebase_firestore_
             sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
         }
 
-        if (!fbdo->readResponse(&fbdo->session.cfs.payload, tcpHandler, response) && !response.isChunkedEnc)
+        // the error response is kept in the payload for parsing
+        bool decode = (req->resultCallback || req->page) && response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK;
+
+        if (!fbdo->readResponse(decode ? &chunk : &fbdo->session.cfs.payload, tcpHandler, response) && !response.isChunkedEnc)
         {
             complete = true;
             break;
         }
 
+        if (decode && chunk.length() > 0)
+        {
+            decodeResults(req, decoder, chunk);
+            chunk.clear();
+        }
+
         // Last chunk?
         if (Core.ut.isChunkComplete(&tcpHandler, &response, complete))
             break;
@@ -832,6 +915,30 @@ bool FB_Firestore::handleResponse(FirebaseData *fbdo, struct firebase_firestore_
     return tcpHandler.error.code == 0;
 }
 
+void FB_Firestore::decodeResults(struct firebase_firestore_req_t *req, firebase_json_array_decoder_t &decoder,
+                                 const MB_String &chunk)
+{
+    size_t pos = 0;
+    while (Core.jh.readArrayElement(decoder, chunk.c_str(), chunk.length(), pos, req->page ? &req->page->outer : nullptr))
+    {
+        if (req->page)
+        {
+            req->page->documents.push_back(decoder.element);
+            decoder.element.clear();
+            continue;
+        }
+
+        CFS_ResultInfo info;
+        info.index = decoder.index++;
+        info.data = decoder.element.c_str();
+        req->resultCallback(info);
+
+        // free the result before decoding the next one
+        decoder.element.clear();
+        decoder.element.shrink_to_fit();
+    }
+}
+
 void FB_Firestore::reportUploadProgress(FirebaseData *fbdo, struct firebase_firestore_req_t *req, size_t readBytes)
 {
     if (req->size == 0)
@@ -864,8 +971,6 @@ void FB_Firestore::sendUploadCallback(FirebaseData *fbdo, CFS_UploadStatusInfo &
 
 int FB_Firestore::tcpSend(FirebaseData *fbdo, const char *data, struct firebase_firestore_req_t *req)
 {
-    size_t len = strlen(data);
-
 #if defined(ESP8266)
     if (fbdo->session.bssl_tx_size < 512)
         fbdo->session.bssl_tx_size = 512;
@@ -877,6 +982,23 @@ int FB_Firestore::tcpSend(FirebaseData *fbdo, const char *data, struct firebase_
     int sent = 0;
     int ret = 0;
 
+    // no data, serialize the JSON payload to the socket chunk by chunk
+    if (!data && req->json)
+    {
+        reportUploadProgress(fbdo, req, sent);
+        ret = fbdo->tcpSend(req->json, chunkSize);
+        // fewer bytes than the announced Content-Length were written
+        if (ret < 0)
+        {
+            fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED;
+            return ret;
+        }
+        reportUploadProgress(fbdo, req, ret);
+        return ret;
+    }
+
+    size_t len = strlen(data);
+
     while (sent < (int)len)
     {
         if (sent + chunkSize > (int)len)
@@ -37,6 +37,7 @@
 #include "./FB_Utils.h"
 #include "./session/FB_Session.h"
 #include "./json/FirebaseJson.h"
+#include "DocumentPager.h"
 
 #include "./client/SSLClient/ESP_SSLClient.h"
 
@@ -45,6 +46,7 @@ using namespace mb_string;
 class FB_Firestore
 {
     friend class Firebase_ESP_Client;
+    friend class DocumentPager;
 
 public:
     FB_Firestore();
@@ -279,7 +281,7 @@ public:
                      T5 transaction = "", T6 readTime = "")
     {
         return mGetDocument(fbdo, toStringPtr(projectId), toStringPtr(databaseId),
-                            toStringPtr(documentPath), toStringPtr(mask), toStringPtr(transaction), nullptr, toStringPtr(readTime), NULL);
+                            toStringPtr(documentPath), toStringPtr(mask), toStringPtr(transaction), nullptr, toStringPtr(readTime), NULL, NULL);
     }
 
     /** Gets multiple documents.
@@ -316,7 +318,38 @@ public:
                           FirebaseData::FirestoreBatchOperationsCallback batchOperationCallback, T5 transaction, FirebaseJson *newTransaction, T6 readTime)
     {
         return mGetDocument(fbdo, toStringPtr(projectId), toStringPtr(databaseId),
-                            toStringPtr(documentPaths), toStringPtr(mask), toStringPtr(transaction), newTransaction, toStringPtr(readTime), batchOperationCallback);
+                            toStringPtr(documentPaths), toStringPtr(mask), toStringPtr(transaction), newTransaction, toStringPtr(readTime), batchOperationCallback, NULL);
+    }
+
+    /** Gets multiple documents and passes each result to the callback as soon as it was received.
+     *
+     * @param fbdo The pointer to Firebase Data Object.
+     * @param projectId The Firebase project id (only the name without the firebaseio.com).
+     * @param databaseId The Firebase Cloud Firestore database id which is (default) or empty "".
+     * @param documentPaths The list of relative path of documents to get. Use comma (,) to separate between the field names.
+     * @param mask The fields to return. If not set, returns all fields. Use comma (,) to separate between the field names.
+     * @param resultCallback The callback fuction that accepts CFS_ResultInfo data.
+     * @param transaction Reads the document in a transaction. A base64-encoded string.
+     * @param newTransaction FirebaseJson pointer that represents TransactionOptions object.
+     * @param readTime Reads documents as they were at the given time. This may not be older than 270 seconds.
+     *
+     * @return Boolean value, indicates the success of the operation.
+     *
+     * @note The results are not kept in FirebaseData.payload(), only one result is kept in memory at a time
+     * and its data is valid only inside the callback.
+     *
+     * This function requires Email/password, Custom token or OAuth2.0 authentication.
+     *
+     * For more detail, see https://cloud.google.com/firestore/docs/reference/rest/v1/projects.databases.documents/batchGet
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *,
+              typename T4 = const char *, typename T5 = const char *, typename T6 = const char *>
+    bool batchGetDocuments(FirebaseData *fbdo, T1 projectId, T2 databaseId, T3 documentPaths, T4 mask,
+                           CFS_ResultCallback resultCallback, T5 transaction, FirebaseJson *newTransaction, T6 readTime)
+    {
+        return mGetDocument(fbdo, toStringPtr(projectId), toStringPtr(databaseId),
+                            toStringPtr(documentPaths), toStringPtr(mask), toStringPtr(transaction), newTransaction, toStringPtr(readTime), NULL, resultCallback);
     }
 
     /** Starts a new transaction.
@@ -398,7 +431,34 @@ public:
                   T4 consistency = "")
     {
         return mRunQuery(fbdo, toStringPtr(projectId), toStringPtr(databaseId), toStringPtr(documentPath),
-                         structuredQuery, consistencyMode, toStringPtr(consistency));
+                         structuredQuery, consistencyMode, toStringPtr(consistency), NULL);
+    }
+
+    /** Runs a query and passes each result to the callback as soon as it was received.
+     *
+     * @param fbdo The pointer to Firebase Data Object.
+     * @param projectId The Firebase project id (only the name without the firebaseio.com).
+     * @param databaseId The Firebase Cloud Firestore database id which is (default) or empty "".
+     * @param documentPath The relative path of document to get.
+     * @param structuredQuery The pointer to FirebaseJson object that contains the Firestore query.
+     * @param resultCallback The callback fuction that accepts CFS_ResultInfo data.
+     * @param consistencyMode Optional. The consistency mode for this transaction.
+     * @param consistency Optional. The value based on consistency mode.
+     *
+     * @return Boolean value, indicates the success of the operation.
+     *
+     * @note The results are not kept in FirebaseData.payload(), only one result is kept in memory at a time
+     * and its data is valid only inside the callback.
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *>
+    bool runQuery(FirebaseData *fbdo, T1 projectId, T2 databaseId, T3 documentPath, FirebaseJson *structuredQuery,
+                  CFS_ResultCallback resultCallback,
+                  firebase_firestore_consistency_mode consistencyMode = firebase_firestore_consistency_mode_undefined,
+                  T4 consistency = "")
+    {
+        return mRunQuery(fbdo, toStringPtr(projectId), toStringPtr(databaseId), toStringPtr(documentPath),
+                         structuredQuery, consistencyMode, toStringPtr(consistency), resultCallback);
     }
 
     /** Delete a document at the defined path.
@@ -457,6 +517,37 @@ public:
                               toStringPtr(mask), showMissing);
     }
 
+    /** Begin listing the documents in the defined documents collection with the DocumentPager object.
+     *
+     * @param fbdo The pointer to Firebase Data Object.
+     * @param pager The pointer to DocumentPager object.
+     * @param projectId The Firebase project id (only the name without the firebaseio.com).
+     * @param databaseId The Firebase Cloud Firestore database id which is (default) or empty "".
+     * @param collectionId The relative path of document colection.
+     * @param pageSize The maximum number of documents of each page.
+     * @param orderBy The order to sort results by. For example: priority desc, name.
+     * @param mask The fields to return. If not set, returns all fields.
+     * @param showMissing If the list should show missing documents.
+     *
+     * @return Boolean value, indicates the first page was requested.
+     *
+     * @note The documents are read with DocumentPager.next() and DocumentPager.document().
+     * The next page is requested as soon as the current page was read and its response is read while
+     * the current page is consumed, then the Firebase Data Object should not be used for other requests
+     * until the listing was complete or DocumentPager.clear() was called.
+     *
+     * This function requires Email/password, Custom token or OAuth2.0 authentication (when showMissing is true).
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = size_t,
+              typename T5 = const char *, typename T6 = const char *>
+    bool beginPager(FirebaseData *fbdo, DocumentPager *pager, T1 projectId, T2 databaseId, T3 collectionId, T4 pageSize,
+                    T5 orderBy = "", T6 mask = "", bool showMissing = false)
+    {
+        return mBeginPager(fbdo, pager, toStringPtr(projectId), toStringPtr(databaseId), toStringPtr(collectionId),
+                           toStringPtr(pageSize, -1), toStringPtr(orderBy), toStringPtr(mask), showMissing);
+    }
+
     /** List the document collection ids in the defined document path.
      *
      * @param fbdo The pointer to Firebase Data Object.
@@ -597,6 +688,7 @@ private:
     bool sendRequest(FirebaseData *fbdo, struct firebase_firestore_req_t *req);
     bool firestore_sendRequest(FirebaseData *fbdo, struct firebase_firestore_req_t *req);
     bool handleResponse(FirebaseData *fbdo, struct firebase_firestore_req_t *req);
+    void decodeResults(struct firebase_firestore_req_t *req, firebase_json_array_decoder_t &decoder, const MB_String &chunk);
     void reportUploadProgress(FirebaseData *fbdo, struct firebase_firestore_req_t *req, size_t readBytes);
     int tcpSend(FirebaseData *fbdo, const char *data, struct firebase_firestore_req_t *req);
     void sendUploadCallback(FirebaseData *fbdo, CFS_UploadStatusInfo &in, CFS_UploadProgressCallback cb, CFS_UploadStatusInfo *out);
@@ -618,13 +710,14 @@ private:
     bool mGetDocument(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
                       MB_StringPtr documentPath, MB_StringPtr mask,
                       MB_StringPtr transaction, FirebaseJson *newTransaction, MB_StringPtr readTime,
-                      FirebaseData::FirestoreBatchOperationsCallback batchOperationCallback);
+                      FirebaseData::FirestoreBatchOperationsCallback batchOperationCallback,
+                      CFS_ResultCallback resultCallback);
     bool mBeginTransaction(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
                            TransactionOptions *transactionOptions = nullptr);
     bool mRollback(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId, MB_StringPtr transaction);
     bool mRunQuery(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
                    MB_StringPtr documentPath, FirebaseJson *structuredQuery, firebase_firestore_consistency_mode consistencyMode,
-                   MB_StringPtr consistency);
+                   MB_StringPtr consistency, CFS_ResultCallback resultCallback);
     bool mDeleteDocument(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
                          MB_StringPtr documentPath, MB_StringPtr exists, MB_StringPtr updateTime);
     bool mListDocuments(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
@@ -632,6 +725,12 @@ private:
                         MB_StringPtr mask, bool showMissing);
     bool mListCollectionIds(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
                             MB_StringPtr documentPath, MB_StringPtr pageSize, MB_StringPtr pageToken);
+    bool mBeginPager(FirebaseData *fbdo, DocumentPager *pager, MB_StringPtr projectId, MB_StringPtr databaseId,
+                     MB_StringPtr collectionId, MB_StringPtr pageSize, MB_StringPtr orderBy, MB_StringPtr mask,
+                     bool showMissing);
+    bool mSendPage(DocumentPager *pager);
+    bool mReadPage(DocumentPager *pager);
+    void mStopPager(DocumentPager *pager);
 
     bool mCreateIndex(FirebaseData *fbdo, MB_StringPtr projectId, MB_StringPtr databaseId,
                       MB_StringPtr collectionId, MB_StringPtr apiScope, MB_StringPtr queryScope,
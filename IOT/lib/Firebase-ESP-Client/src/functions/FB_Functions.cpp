@@ -456,7 +456,7 @@ bool FB_Functions::sendRequest(FirebaseData *fbdo, struct firebase_functions_req
         return true;
 #endif
 
-    if (!fbdo->reconnect() || !Core.tokenReady())
+    if (!fbdo->reconnect() || !Core.tokenReady(true))
         return false;
 
     if (Core.internal.fb_processing)
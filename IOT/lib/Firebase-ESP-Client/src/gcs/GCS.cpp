@@ -89,7 +89,7 @@ bool GG_CloudStorage::sendRequest(FirebaseData *fbdo, struct firebase_gcs_req_t
     if (!fbdo->reconnect())
         return false;
 
-    if (!Core.tokenReady())
+    if (!Core.tokenReady(true))
         return false;
 
     if (fbdo->session.long_running_task > 0)
@@ -146,7 +146,11 @@ bool GG_CloudStorage::sendRequest(FirebaseData *fbdo, struct firebase_gcs_req_t
 
     Core.internal.fb_processing = true;
 
-    bool ret = gcs_sendRequest(fbdo, req);
+    bool ret = false;
+    if (req->requestType == firebase_gcs_request_type_download || req->requestType == firebase_gcs_request_type_download_ota)
+        ret = gcs_download(fbdo, req);
+    else
+        ret = gcs_sendRequest(fbdo, req);
 
     Core.internal.fb_processing = false;
 
@@ -355,12 +359,30 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
                     req->requestType = firebase_gcs_request_type_upload_multipart;
                 else
                 {
-                    uint32_t chunkLen = req->fileSize / 4;
-                    uint32_t factor = (chunkLen / gcs_min_chunkSize);
-                    if (factor * gcs_min_chunkSize < gcs_min_chunkSize)
-                        gcs_chunkSize = gcs_min_chunkSize;
-                    else
-                        gcs_chunkSize = factor * gcs_min_chunkSize;
+                    // start small, the chunk grows with the measured throughput
+                    req->chunkSize = gcs_min_chunkSize;
+
+                    // continue the unfinished upload of the same file e.g. the one interrupted by reboot,
+                    // the file that was changed since then is uploaded in the new session
+                    if (Core.config->gcs.resumable_state_file.length() > 0 && fileCrc32c(req, req->fileCrc))
+                    {
+                        MB_String location;
+                        _resumableUploadMutex.lock();
+                        int index = findResumeState(req);
+                        if (index > -1 && _resumeStates[index].fileSize == req->fileSize &&
+                            _resumeStates[index].crc32c == req->fileCrc)
+                            location = _resumeStates[index].location;
+                        _resumableUploadMutex.unlock();
+
+                        if (location.length() > 0)
+                        {
+                            req->location = location;
+                            req->requestType = firebase_gcs_request_type_upload_resumable_run;
+                            req->queryStatus = true;
+                        }
+                        else
+                            removeResumeState(req);
+                    }
                 }
             }
         }
@@ -375,7 +397,7 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
 
     if (req->requestType == firebase_gcs_request_type_upload_simple ||
         req->requestType == firebase_gcs_request_type_upload_multipart ||
-        req->requestType == firebase_gcs_request_type_upload_resumable_init)
+        req->requestType == firebase_gcs_request_type_upload_resumable_init || req->queryStatus)
     {
         UploadStatusInfo in;
         makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_upload_status_init,
@@ -422,6 +444,9 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
         header += firebase_gcs_pgm_str_4; // "?alt=media"
         setGetOptions(req, header, true);
         Core.hh.addRequestHeaderLast(header);
+
+        if (req->range.offset > 0 || Core.config->gcs.download_range_size > 0)
+            Core.hh.addRangeHeader(header, req->range.offset, Core.config->gcs.download_range_size);
     }
     else if (req->requestType == firebase_gcs_request_type_upload_simple)
     {
@@ -520,6 +545,9 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
 #if defined(USE_CONNECTION_KEEP_ALIVE_MODE)
     keepAlive = true;
 #endif
+    // the next chunk goes through the same connection
+    if (req->requestType == firebase_gcs_request_type_upload_resumable_run)
+        keepAlive = true;
     Core.hh.addConnectionHeader(header, keepAlive);
 
     if (req->requestType == firebase_gcs_request_type_upload_simple)
@@ -589,22 +617,24 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
 
         Core.hh.addContentLengthHeader(header, strlen(fbdo->session.jsonPtr->raw()));
     }
+    else if (req->requestType == firebase_gcs_request_type_upload_resumable_run && req->queryStatus)
+    {
+        // ask for the persisted offset, the server replies 308 with the Range header
+        req->chunkLen = 0;
+        Core.hh.addContentLengthHeader(header, 0);
+        header += firebase_gcs_pgm_str_11; // "Content-Range: bytes "
+        header += firebase_gcs_pgm_str_49; // "*/"
+        header += req->fileSize;
+        Core.hh.addNewLine(header);
+    }
     else if (req->requestType == firebase_gcs_request_type_upload_resumable_run)
     {
+        uint32_t chunkSize = req->chunkSize > 0 ? req->chunkSize : gcs_min_chunkSize;
 
         req->chunkPos = req->chunkRange + 1;
-        if (req->chunkRange == -1 && req->fileSize <= gcs_chunkSize)
-            req->chunkLen = req->fileSize;
-        else if (req->chunkRange == -1 && req->fileSize > gcs_chunkSize)
-            req->chunkLen = gcs_chunkSize;
-        else if (req->chunkRange != -1)
-        {
-            int b = req->fileSize - req->chunkRange;
-            if (b > (int)gcs_chunkSize)
-                req->chunkLen = gcs_chunkSize;
-            else
-                req->chunkLen = b - 1;
-        }
+        req->chunkLen = req->fileSize - req->chunkPos;
+        if (req->chunkLen > (int)chunkSize)
+            req->chunkLen = chunkSize;
 
         Core.hh.addContentLengthHeader(header, req->chunkLen);
 
@@ -711,7 +741,7 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
 
             reportUploadProgress(fbdo, req, req->fileSize);
         }
-        else if (req->requestType == firebase_gcs_request_type_upload_resumable_run)
+        else if (req->requestType == firebase_gcs_request_type_upload_resumable_run && !req->queryStatus)
         {
             size_t byteRead = 0;
             int available = 0;
@@ -735,6 +765,8 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
 
             reportUploadProgress(fbdo, req, req->chunkPos);
 
+            unsigned long sendStart = millis();
+
             while (byteRead < totalBytes)
             {
                 FBUtils::idle();
@@ -767,61 +799,188 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
                     available = totalBytes - byteRead;
             }
 
+            req->sendMs = millis() - sendStart;
+
             Core.mbfs.delP(&buf);
 
             if (Core.mbfs.available(mbfs_type req->storageType) == 0)
                 Core.mbfs.close(mbfs_type req->storageType);
         }
 
+        // the response is read later with completeRequest
+        if (req->deferResponse && fbdo->session.response.code > 0 && fbdo->tcpClient.connected())
+            return true;
+    }
+
+    if (completeRequest(fbdo, req))
+        return true;
+
+    // the saved session of this upload was expired, upload the file in the new session
+    if (req->sessionExpired && req->queryStatus && fbdo->reconnect())
+    {
+        req->requestType = firebase_gcs_request_type_upload_resumable_init;
+        req->location.clear();
+        req->chunkRange = -1;
+        req->queryStatus = false;
+        req->sessionExpired = false;
+        Core.internal.fb_processing = true;
+        gcs_connect(fbdo);
+        return gcs_sendRequest(fbdo, req);
+    }
+
+    return false;
+}
+
+bool GG_CloudStorage::gcs_download(FirebaseData *fbdo, struct firebase_gcs_req_t *req)
+{
+    bool isOTA = req->requestType == firebase_gcs_request_type_download_ota;
+    bool ret = false;
+    uint8_t resume = 0;
+
+    // continue the interrupted file download from the local file
+    if (!isOTA)
+        Core.ut.loadDownloadRange(&Core.mbfs, req->localFileName, req->storageType, req->range);
+
+    ret = req->range.total > 0 && req->range.offset >= req->range.total;
+
+    while (!ret)
+    {
+        req->range.changed = false;
+
+        if (gcs_sendRequest(fbdo, req))
+        {
+            resume = 0;
+            // request the next range
+            ret = req->range.offset >= req->range.total;
+            if (!ret)
+                gcs_connect(fbdo);
+            continue;
+        }
+
+        // the object was changed, download it from the beginning unless the firmware was partly written
+        if (!(req->range.changed && !req->range.started) &&
+            !(Core.ut.isDownloadResumable(fbdo->session.response.code) && req->range.offset > 0))
+            break;
+
+        if (resume++ >= Core.config->gcs.download_max_resume)
+            break;
+
+        if (!isOTA)
+            Core.ut.saveDownloadRange(&Core.mbfs, req->localFileName, req->storageType, req->range);
+
+        delay(resume * 500);
+
+        if (!fbdo->reconnect())
+            break;
+
+        gcs_connect(fbdo);
+    }
+
+    if (ret && req->range.crc32c.length() == 0)
+    {
+        // the response has no x-goog-hash header, get the CRC32C from the object metadata
+        struct firebase_gcs_req_t meta;
+        meta.requestType = firebase_gcs_request_type_get_metadata;
+        meta.bucketID = req->bucketID;
+        meta.remoteFileName = req->remoteFileName;
+        meta.getOptions = req->getOptions;
+        gcs_connect(fbdo);
+        if (gcs_sendRequest(fbdo, &meta))
+            req->range.crc32c = fbdo->session.gcs.meta.crc32;
+        fbdo->session.gcs.requestType = req->requestType;
+    }
+
+    if (ret && !Core.ut.checkDownloadRange(&Core.bh, &Core.mbfs, req->range, isOTA))
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_DOWNLOAD_CHECKSUM_MISMATCH;
+        ret = false;
+    }
+
+    if (isOTA)
+    {
+        // the firmware is committed only when its CRC32C was verified
+        if (req->range.started)
+        {
+            int code = fbdo->commitDownloadOTA(ret);
+            if (code != 0)
+            {
+                fbdo->session.response.code = code;
+                ret = false;
+            }
+        }
+    }
+    else if (ret || fbdo->session.response.code == FIREBASE_ERROR_DOWNLOAD_CHECKSUM_MISMATCH)
+    {
+        if (!ret)
+            Core.mbfs.remove(req->localFileName, mbfs_type req->storageType);
+        Core.ut.removeDownloadRange(&Core.mbfs, req->localFileName, req->storageType);
+    }
+    else if (req->range.offset > 0)
+        Core.ut.saveDownloadRange(&Core.mbfs, req->localFileName, req->storageType, req->range);
+
+    if (ret)
+    {
+        DownloadStatusInfo in;
+        makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_download_status_complete,
+                           100, req->fileSize, 0, "");
+        sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
+    }
+
+    return ret;
+}
+
+bool GG_CloudStorage::completeRequest(FirebaseData *fbdo, struct firebase_gcs_req_t *req)
+{
+    bool isRun = req->requestType == firebase_gcs_request_type_upload_resumable_run;
+
+    if (fbdo->session.response.code > 0)
+    {
         if (fbdo->tcpClient.connected())
         {
             bool ret = handleResponse(fbdo, req);
-            fbdo->closeSession();
+
+            // the status other than 200, 201 and 308
+            if (isRun && fbdo->session.response.code != FIREBASE_ERROR_HTTP_CODE_OK)
+                ret = false;
+
+            if (!ret || !isRun || !req->chunkPending)
+                fbdo->closeSession();
+
             if (ret)
             {
                 if (Core.mbfs.ready(mbfs_type req->storageType) && req->requestType == firebase_gcs_request_type_download)
                     Core.mbfs.close(mbfs_type req->storageType);
 
                 Core.internal.fb_processing = false;
-                if (req->requestType == firebase_gcs_request_type_download ||
-                    req->requestType == firebase_gcs_request_type_download_ota)
-                {
-                    DownloadStatusInfo in;
-                    makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_download_status_complete,
-                                       100, req->fileSize, 0, "");
-                    sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
-                }
-                else if (req->requestType == firebase_gcs_request_type_upload_simple ||
-                         req->requestType == firebase_gcs_request_type_upload_multipart)
+                // the download status is sent from gcs_download after the object was verified
+                if (req->requestType == firebase_gcs_request_type_upload_simple ||
+                    req->requestType == firebase_gcs_request_type_upload_multipart)
                 {
                     UploadStatusInfo in;
                     makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_upload_status_complete,
                                      100, 0, 0, "");
                     sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
                 }
-                else if (req->requestType == firebase_gcs_request_type_upload_resumable_run)
+                else if (isRun && !req->chunkPending)
                 {
-                    if (Core.mbfs.available(mbfs_type req->storageType) == 0)
-                    {
-                        UploadStatusInfo in;
-                        makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_upload_status_complete,
-                                         100, 0, 0, "");
-                        sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
-                        fbdo->session.long_running_task -= _resumableUploadTasks.size();
-                        _resumableUploadTasks.clear();
-                    }
+                    removeResumeState(req);
+                    UploadStatusInfo in;
+                    makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_upload_status_complete,
+                                     100, 0, 0, "");
+                    sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
                 }
                 return true;
             }
         }
     }
 
-    if (req->requestType == firebase_gcs_request_type_download || req->requestType == firebase_gcs_request_type_download_ota)
+    if (isRun && req->sessionExpired)
     {
-        DownloadStatusInfo in;
-        makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_download_status_error,
-                           0, 0, 0, fbdo->errorReason());
-        sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
+        // the session can't be continued, the saved one is restarted by gcs_sendRequest
+        // and the running one is queued to start over
+        removeResumeState(req);
+        if (!req->queryStatus)
+            pushResumableInitTask(fbdo, req);
     }
     else if (req->requestType == firebase_gcs_request_type_upload_resumable_init ||
              req->requestType == firebase_gcs_request_type_upload_resumable_run ||
@@ -832,8 +991,10 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_re
         makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_upload_status_error,
                          0, 0, 0, fbdo->errorReason());
         sendUploadCallback(fbdo, in, req->uploadCallback, req->uploadStatusInfo);
-        fbdo->session.long_running_task -= _resumableUploadTasks.size();
-        _resumableUploadTasks.clear();
+
+        // the upload session was rejected or expired, keep the state for the network errors only
+        if (isRun && fbdo->session.response.code >= FIREBASE_ERROR_HTTP_CODE_BAD_REQUEST)
+            removeResumeState(req);
     }
 
     if (Core.mbfs.ready(mbfs_type req->storageType) && req->requestType == firebase_gcs_request_type_download)
@@ -1059,6 +1220,10 @@ void GG_CloudStorage::mRunResumableUploadTask()
     {
 #if defined(ESP32)
 
+        // the running task also takes the uploads that were added later
+        if (Core.internal.resumable_upload_task_handle)
+            return;
+
         static GG_CloudStorage *_this = this;
         MB_String taskName = "ResumableUpload_";
         taskName += random(1,100);
@@ -1067,8 +1232,6 @@ void GG_CloudStorage::mRunResumableUploadTask()
         {
             while (_this->_resumable_upload_task_enable)
             {
-                vTaskDelay(100 / portTICK_PERIOD_MS);
-
                 if (!_this->mRunResumableUpload())
                     break;
 
@@ -1088,7 +1251,7 @@ void GG_CloudStorage::mRunResumableUploadTask()
         if (!mRunResumableUpload())
             return;
 
-        if (_resumableUploadTasks.size() > 0)
+        if (resumableTaskCount() > 0)
             Core.set_scheduled_callback(std::bind(&GG_CloudStorage::mRunResumableUploadTask, this));
 
 #endif
@@ -1099,40 +1262,337 @@ void GG_CloudStorage::mRunResumableUploadTask()
 
 bool GG_CloudStorage::mRunResumableUpload()
 {
+    _resumableUploadMutex.lock();
+
     if (_resumableUploadTasks.size() == 0)
+    {
+        _resumableUploadMutex.unlock();
         return false;
+    }
 
-    if (_resumableUplaodTaskIndex < _resumableUploadTasks.size() - 1)
-        _resumableUplaodTaskIndex++;
-    else
+    if (_resumableUplaodTaskIndex >= _resumableUploadTasks.size())
         _resumableUplaodTaskIndex = 0;
 
-    struct fb_gcs_upload_resumable_task_info_t *taskInfo = &_resumableUploadTasks[_resumableUplaodTaskIndex];
+    // take the tasks out before running, the chunk response appends the next task of the same upload
+    struct fb_gcs_upload_resumable_task_info_t tasks[2];
+    size_t n = 0;
+
+    tasks[n++] = _resumableUploadTasks[_resumableUplaodTaskIndex];
+    _resumableUploadTasks.erase(_resumableUploadTasks.begin() + _resumableUplaodTaskIndex);
+
+    if (Core.config && Core.config->gcs.resumable_upload_connections > 1)
+    {
+        for (size_t i = 0; i < _resumableUploadTasks.size(); i++)
+        {
+            if (_resumableUploadTasks[i].fbdo != tasks[0].fbdo)
+            {
+                tasks[n++] = _resumableUploadTasks[i];
+                _resumableUploadTasks.erase(_resumableUploadTasks.begin() + i);
+                break;
+            }
+        }
+    }
+
+    _resumableUploadMutex.unlock();
+
+    // With two uploads, both chunks are sent before either response is read,
+    // the response latency of one connection overlaps the transfer on the other.
+    for (size_t i = 0; i < n; i++)
+    {
+        tasks[i].req.deferResponse = n > 1;
+        if (!gcs_sendRequest(tasks[i].fbdo, &tasks[i].req))
+        {
+            tasks[i].req.deferResponse = false;
+            tasks[i].fbdo->closeSession();
+        }
+    }
 
-    if (!taskInfo->done)
+    for (size_t i = 0; i < n; i++)
     {
-        taskInfo->done = true;
-        if (!gcs_sendRequest(taskInfo->fbdo, &taskInfo->req))
-            taskInfo->fbdo->closeSession();
+        if (tasks[i].req.deferResponse && !completeRequest(tasks[i].fbdo, &tasks[i].req))
+            tasks[i].fbdo->closeSession();
+        tasks[i].fbdo->session.long_running_task--;
     }
 
     mResumableUploadUpdate();
 
-    return _resumableUploadTasks.size() > 0;
+    return resumableTaskCount() > 0;
 }
 
 void GG_CloudStorage::mResumableUploadUpdate()
 {
-    size_t n = 0;
-    for (size_t i = 0; i < _resumableUploadTasks.size(); i++)
-        if (_resumableUploadTasks[i].done)
-            n++;
+    if (resumableTaskCount() == 0)
+        _resumable_upload_task_enable = false;
+}
 
-    if (n == _resumableUploadTasks.size())
+size_t GG_CloudStorage::resumableTaskCount()
+{
+    _resumableUploadMutex.lock();
+    size_t count = _resumableUploadTasks.size();
+    _resumableUploadMutex.unlock();
+    return count;
+}
+
+void GG_CloudStorage::pushResumableTask(FirebaseData *fbdo, struct firebase_gcs_req_t *req,
+                                        const MB_String &location, int chunkRange)
+{
+    struct fb_gcs_upload_resumable_task_info_t ruTask;
+    fbdo->createResumableTask(ruTask, req->fileSize, location, req->localFileName, req->remoteFileName,
+                              req->storageType, firebase_gcs_request_type_upload_resumable_run);
+    ruTask.req.chunkRange = chunkRange;
+    ruTask.req.chunkSize = req->chunkSize;
+    ruTask.req.rate = req->rate;
+    ruTask.req.rtt = req->rtt;
+    ruTask.req.fileCrc = req->fileCrc;
+    // to start over in the new session when this one expires
+    ruTask.req.bucketID = req->bucketID;
+    ruTask.req.mime = req->mime;
+    ruTask.req.uploadCallback = req->uploadCallback;
+    ruTask.req.uploadStatusInfo = req->uploadStatusInfo;
+
+    _resumableUploadMutex.lock();
+    _resumableUploadTasks.push_back(ruTask);
+    _resumableUploadMutex.unlock();
+
+    req->chunkPending = true;
+    setResumeState(req, location, chunkRange + 1);
+
+    fbdo->session.long_running_task++;
+    _resumable_upload_task_enable = true;
+}
+
+void GG_CloudStorage::pushResumableInitTask(FirebaseData *fbdo, struct firebase_gcs_req_t *req)
+{
+    // the upload options and request properties of the upload call are not kept by the tasks
+    struct fb_gcs_upload_resumable_task_info_t ruTask;
+    fbdo->createResumableTask(ruTask, req->fileSize, MB_String(), req->localFileName, req->remoteFileName,
+                              req->storageType, firebase_gcs_request_type_upload_resumable_init);
+    ruTask.req.bucketID = req->bucketID;
+    ruTask.req.mime = req->mime;
+    ruTask.req.uploadCallback = req->uploadCallback;
+    ruTask.req.uploadStatusInfo = req->uploadStatusInfo;
+
+    _resumableUploadMutex.lock();
+    _resumableUploadTasks.push_back(ruTask);
+    _resumableUploadMutex.unlock();
+
+    fbdo->session.long_running_task++;
+    _resumable_upload_task_enable = true;
+}
+
+bool GG_CloudStorage::fileCrc32c(struct firebase_gcs_req_t *req, uint32_t &crc)
+{
+    crc = 0;
+
+    int len = Core.mbfs.open(req->localFileName, mbfs_type req->storageType, mb_fs_open_mode_read);
+    if (len < 0)
+        return false;
+
+    int bufLen = Core.ut.getUploadBufSize(Core.config, firebase_con_mode_gc_storage);
+    uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufLen));
+    int read = 0;
+
+    while (len > 0 && (read = Core.mbfs.read(mbfs_type req->storageType, buf, len < bufLen ? len : bufLen)) > 0)
     {
-        _resumableUploadTasks.clear();
-        _resumable_upload_task_enable = false;
+        crc = Core.ut.crc32c(crc, buf, read);
+        len -= read;
+        FBUtils::idle();
+    }
+
+    Core.mbfs.delP(&buf);
+    Core.mbfs.close(mbfs_type req->storageType);
+
+    return len == 0;
+}
+
+void GG_CloudStorage::updateChunkSize(struct firebase_gcs_req_t *req, uint32_t rtt)
+{
+    if (req->chunkLen <= 0)
+        return;
+
+    uint32_t rate = (uint64_t)req->chunkLen * 1000 / (req->sendMs > 0 ? req->sendMs : 1);
+
+    // smooth the samples, one stalled chunk should not collapse the size
+    req->rate = req->rate > 0 ? (req->rate * 3 + rate) / 4 : rate;
+    req->rtt = req->rtt > 0 ? (req->rtt * 3 + rtt) / 4 : rtt;
+
+    // every chunk waits one response, send long enough to hide it
+    uint32_t targetMs = req->rtt * gcs_chunk_rtt_factor;
+    if (targetMs < gcs_chunk_target_ms)
+        targetMs = gcs_chunk_target_ms;
+
+    uint64_t size = (uint64_t)req->rate * targetMs / 1000;
+
+    // grow two times at most per chunk
+    uint32_t chunkSize = req->chunkSize > 0 ? req->chunkSize : gcs_min_chunkSize;
+    if (size > (uint64_t)chunkSize * 2)
+        size = (uint64_t)chunkSize * 2;
+
+    if (size > Core.config->gcs.resumable_max_chunk_size)
+        size = Core.config->gcs.resumable_max_chunk_size;
+
+    // the chunks other than the last one should be multiple of 256 KiB
+    req->chunkSize = (size / gcs_min_chunkSize) * gcs_min_chunkSize;
+    if (req->chunkSize < gcs_min_chunkSize)
+        req->chunkSize = gcs_min_chunkSize;
+}
+
+void GG_CloudStorage::loadResumeStates()
+{
+    if (_resumeStatesLoaded || !Core.config || Core.config->gcs.resumable_state_file.length() == 0)
+        return;
+
+    _resumeStatesLoaded = true;
+    _resumeStates.clear();
+
+    mbfs_file_type type = mbfs_type Core.config->gcs.resumable_state_storage_type;
+
+    int len = Core.mbfs.open(Core.config->gcs.resumable_state_file, type, mb_fs_open_mode_read);
+    if (len <= 0)
+    {
+        if (len == 0)
+            Core.mbfs.close(type);
+        return;
+    }
+
+    char *buf = reinterpret_cast<char *>(Core.mbfs.newP(len + 1));
+    int read = Core.mbfs.read(type, (uint8_t *)buf, len);
+    Core.mbfs.close(type);
+
+    MB_String content;
+    if (read > 0)
+    {
+        buf[read] = '\0';
+        content = buf;
+    }
+    Core.mbfs.delP(&buf);
+
+    // size, CRC32C, offset, local file, remote file and session URI, one upload per line,
+    // the line without CRC32C was saved by the older version and is not continued
+    MB_VECTOR<MB_String> lines;
+    Core.sh.splitTk(content, lines, "\n");
+
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        MB_VECTOR<MB_String> tk;
+        Core.sh.splitTk(lines[i], tk, "\t");
+        if (tk.size() != 6)
+            continue;
+
+        struct fb_gcs_upload_resume_state_t state;
+        state.fileSize = strtoul(tk[0].c_str(), NULL, 10);
+        state.crc32c = strtoul(tk[1].c_str(), NULL, 10);
+        state.offset = strtoul(tk[2].c_str(), NULL, 10);
+        state.localFileName = tk[3];
+        state.remoteFileName = tk[4];
+        state.location = tk[5];
+        _resumeStates.push_back(state);
+    }
+}
+
+void GG_CloudStorage::saveResumeStates()
+{
+    if (!Core.config || Core.config->gcs.resumable_state_file.length() == 0)
+        return;
+
+    mbfs_file_type type = mbfs_type Core.config->gcs.resumable_state_storage_type;
+
+    if (_resumeStates.size() == 0)
+    {
+        if (Core.mbfs.existed(Core.config->gcs.resumable_state_file, type))
+            Core.mbfs.remove(Core.config->gcs.resumable_state_file, type);
+        return;
+    }
+
+    MB_String content;
+    for (size_t i = 0; i < _resumeStates.size(); i++)
+    {
+        content += _resumeStates[i].fileSize;
+        content += '\t';
+        content += _resumeStates[i].crc32c;
+        content += '\t';
+        content += _resumeStates[i].offset;
+        content += '\t';
+        content += _resumeStates[i].localFileName;
+        content += '\t';
+        content += _resumeStates[i].remoteFileName;
+        content += '\t';
+        content += _resumeStates[i].location;
+        content += '\n';
     }
+
+    if (Core.mbfs.open(Core.config->gcs.resumable_state_file, type, mb_fs_open_mode_write) < 0)
+        return;
+
+    Core.mbfs.write(type, (uint8_t *)content.c_str(), content.length());
+    Core.mbfs.close(type);
+}
+
+// The caller holds _resumableUploadMutex
+int GG_CloudStorage::findResumeState(struct firebase_gcs_req_t *req)
+{
+    loadResumeStates();
+
+    // one state per local and remote file, the size and CRC32C are checked before continuing
+    for (size_t i = 0; i < _resumeStates.size(); i++)
+    {
+        if (strcmp(_resumeStates[i].localFileName.c_str(), req->localFileName.c_str()) == 0 &&
+            strcmp(_resumeStates[i].remoteFileName.c_str(), req->remoteFileName.c_str()) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+void GG_CloudStorage::setResumeState(struct firebase_gcs_req_t *req, const MB_String &location, size_t offset)
+{
+    if (!Core.config || Core.config->gcs.resumable_state_file.length() == 0)
+        return;
+
+    _resumableUploadMutex.lock();
+
+    int index = findResumeState(req);
+
+    if (index < 0)
+    {
+        struct fb_gcs_upload_resume_state_t state;
+        state.localFileName = req->localFileName;
+        state.remoteFileName = req->remoteFileName;
+        _resumeStates.push_back(state);
+        index = _resumeStates.size() - 1;
+    }
+
+    _resumeStates[index].fileSize = req->fileSize;
+    _resumeStates[index].crc32c = req->fileCrc;
+    _resumeStates[index].location = location;
+    _resumeStates[index].offset = offset;
+
+    saveResumeStates();
+
+    _resumableUploadMutex.unlock();
+}
+
+void GG_CloudStorage::removeResumeState(struct firebase_gcs_req_t *req)
+{
+    _resumableUploadMutex.lock();
+
+    int index = findResumeState(req);
+    if (index > -1)
+    {
+        _resumeStates.erase(_resumeStates.begin() + index);
+        saveResumeStates();
+    }
+
+    _resumableUploadMutex.unlock();
+}
+
+void GG_CloudStorage::clearResumableUploadState()
+{
+    _resumableUploadMutex.lock();
+    _resumeStates.clear();
+    _resumeStatesLoaded = true;
+    saveResumeStates();
+    _resumableUploadMutex.unlock();
 }
 
 void GG_CloudStorage::runResumableUploadTask()
@@ -1144,7 +1604,7 @@ void GG_CloudStorage::runResumableUploadTask()
         return;
 #endif
 
-    if (_resumableUploadTasks.size() > 0)
+    if (resumableTaskCount() > 0)
         mRunResumableUploadTask();
 }
 
@@ -1170,6 +1630,7 @@ bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct firebase_gcs_req
 
     bool isList = false, isMeta = false;
     int upos = 0;
+    unsigned long waitStart = millis();
 
     if (!fbdo->waitResponse(tcpHandler))
         return false;
@@ -1179,7 +1640,7 @@ bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct firebase_gcs_req
 
     if (req->requestType == firebase_gcs_request_type_download &&
         strlen(Core.mbfs.name(mbfs_type req->storageType)) == 0 &&
-        !fbdo->prepareDownload(req->localFileName, req->storageType, true))
+        !fbdo->prepareDownload(req->localFileName, req->storageType, true, req->range.offset > 0))
         return false;
 
     bool ruTask = req->requestType == firebase_gcs_request_type_upload_resumable_init ||
@@ -1206,43 +1667,24 @@ bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct firebase_gcs_req
             else
                 fbdo->session.response.code = response.httpCode;
 
-            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT) // resume incomplete
-            {
-                int p1 = 0;
-                if (Core.sh.find(tcpHandler.header, firebase_gcs_pgm_str_48 /* "Range: bytes=0-" */, false, 0, p1))
-                {
-                    if (_resumableUploadTasks.size() > 0)
-                    {
-                        struct fb_gcs_upload_resumable_task_info_t ruTask;
-                        fbdo->createResumableTask(ruTask, req->fileSize, req->location,
-                                                  req->localFileName, req->remoteFileName, req->storageType,
-                                                  firebase_gcs_request_type_upload_resumable_run);
-                        ruTask.req.chunkRange = atoi(tcpHandler.header.substr(p1 + strlen_P(firebase_gcs_pgm_str_48 /* "Range: bytes=0-" */),
-                                                                              tcpHandler.header.length() - p1 - strlen_P(firebase_gcs_pgm_str_48 /* "Range: bytes=0-" */))
-                                                         .c_str());
-                        ruTask.req.uploadCallback = req->uploadCallback;
-                        ruTask.req.uploadStatusInfo = req->uploadStatusInfo;
-                        _resumableUploadTasks.push_back(ruTask);
-
-                        fbdo->session.long_running_task++;
-                        _resumable_upload_task_enable = true;
-                    }
-                }
-            }
-            else if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.location.length() > 0)
+            if ((response.httpCode == FIREBASE_ERROR_HTTP_CODE_NOT_FOUND ||
+                 response.httpCode == FIREBASE_ERROR_HTTP_CODE_GONE) &&
+                req->requestType == firebase_gcs_request_type_upload_resumable_run)
+                req->sessionExpired = true;
+            else if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT) // resume incomplete
             {
-                struct fb_gcs_upload_resumable_task_info_t ruTask;
-                fbdo->createResumableTask(ruTask, req->fileSize, response.location, req->localFileName,
-                                          req->remoteFileName, req->storageType, firebase_gcs_request_type_upload_resumable_run);
-                ruTask.req.uploadCallback = req->uploadCallback;
-                ruTask.req.uploadStatusInfo = req->uploadStatusInfo;
-                _resumableUploadTasks.push_back(ruTask);
-
-                fbdo->session.long_running_task++;
-                _resumable_upload_task_enable = true;
+                // no Range header means nothing was persisted yet, the next chunk starts over
+                if (req->requestType == firebase_gcs_request_type_upload_resumable_run && !req->queryStatus)
+                    updateChunkSize(req, millis() - waitStart);
+                pushResumableTask(fbdo, req, req->location, response.chunkRange);
             }
+            else if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.location.length() > 0 &&
+                     req->requestType == firebase_gcs_request_type_upload_resumable_init)
+                pushResumableTask(fbdo, req, response.location, -1);
 
-            if (_resumable_upload_task_enable && _resumableUploadTasks.size() == 1)
+            // the chunk responses queue their next chunk to the running task
+            if (_resumable_upload_task_enable &&
+                (req->requestType == firebase_gcs_request_type_upload_resumable_init || req->queryStatus))
                 mRunResumableUploadTask();
 
             if (_resumable_upload_task_enable && response.contentLen == 0)
@@ -1254,19 +1696,39 @@ bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct firebase_gcs_req
         {
             tcpHandler.header.clear();
 
-            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.contentLen > 0 &&
+            if ((response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK || response.httpCode == FIREBASE_ERROR_HTTP_CODE_PARTIAL_CONTENT) &&
+                response.contentLen > 0 &&
                 (fbdo->session.gcs.requestType == firebase_gcs_request_type_download ||
                  fbdo->session.gcs.requestType == firebase_gcs_request_type_download_ota))
             {
                 tcpHandler.dataTime = millis();
-
-                req->fileSize = response.contentLen;
                 tcpHandler.error.code = 0;
 
-                DownloadStatusInfo in;
-                makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_download_status_init,
-                                   0, req->fileSize, 0, "");
-                sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
+                size_t offset = req->range.offset;
+                int range = Core.ut.setDownloadRange(req->range, response);
+
+                // the object was changed since the previous range or the partly written firmware can't be continued
+                if (range < 0 || (range == 0 && offset > 0 && isOTA))
+                {
+                    req->range.changed = true;
+                    tcpHandler.error.code = FIREBASE_ERROR_HTTP_CODE_PRECONDITION_FAILED;
+                    fbdo->session.response.code = tcpHandler.error.code;
+                    break;
+                }
+
+                // the server sent the whole object, write the file from the beginning
+                if (range == 0 && offset > 0 && !fbdo->prepareDownload(req->localFileName, req->storageType, true))
+                    break;
+
+                req->fileSize = req->range.total;
+
+                if (req->range.offset == 0)
+                {
+                    DownloadStatusInfo in;
+                    makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_gcs_download_status_init,
+                                       0, req->fileSize, 0, "");
+                    sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
+                }
 
                 int bufLen = Core.config->gcs.download_buffer_size;
                 if (bufLen < 512)
@@ -1276,23 +1738,35 @@ bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct firebase_gcs_req
                     bufLen = 1024 * 16;
                 uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufLen, false));
                 int stage = 0;
+                size_t received = 0;
 
-                if (isOTA)
-                    fbdo->prepareDownloadOTA(tcpHandler, response);
+                if (isOTA && !req->range.started)
+                {
+                    fbdo->prepareDownloadOTA(tcpHandler, response, req->range.total);
+                    req->range.started = tcpHandler.error.code == 0;
+                }
 
                 while (fbdo->processDownload(req->localFileName, req->storageType, buf, bufLen, tcpHandler,
                                              response, stage, isOTA))
                 {
+                    // the buffer is written in the next call
                     if (stage)
-                        reportDownloadProgress(fbdo, req, tcpHandler.payloadRead);
+                    {
+                        req->range.crc = Core.ut.crc32c(req->range.crc, buf, tcpHandler.bufferAvailable);
+                        received += tcpHandler.bufferAvailable;
+                        reportDownloadProgress(fbdo, req, req->range.offset + received);
+                    }
                 }
 
                 Core.mbfs.delP(&buf);
 
-                reportDownloadProgress(fbdo, req, tcpHandler.payloadRead);
+                if (tcpHandler.error.code == 0)
+                    req->range.offset += received;
 
-                if (isOTA)
-                    fbdo->endDownloadOTA(tcpHandler);
+                if (response.contentLen == (int)received)
+                    reportDownloadProgress(fbdo, req, req->range.offset);
+                else if (tcpHandler.error.code == 0)
+                    tcpHandler.error.code = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
 
                 if (tcpHandler.error.code != 0)
                     fbdo->session.response.code = tcpHandler.error.code;
@@ -188,12 +188,27 @@ public:
     /** Run Resumable upload tasks manually. */
     void runResumableUploadTask();
 
+    /** Discard the saved state of the unfinished resumable uploads.
+     *
+     * @note The state is kept in the file set with config.gcs.resumable_state_file,
+     * the upload of the same local file, remote file, size and CRC32C will continue from the
+     * offset that was persisted by the server instead of starting over.
+     * The upload whose session URI was not found or expired starts in the new session.
+     */
+    void clearResumableUploadState();
+
 private:
     const uint32_t gcs_min_chunkSize = 256 * 1024; // Min Google recommended length
-    uint32_t gcs_chunkSize = 256 * 1024;
+    // the time that an adaptive chunk should take to send, at least this many times the response latency
+    const uint32_t gcs_chunk_target_ms = 2000;
+    const uint32_t gcs_chunk_rtt_factor = 16;
     bool _resumable_upload_task_enable = false;
     MB_VECTOR<struct fb_gcs_upload_resumable_task_info_t> _resumableUploadTasks;
     size_t _resumableUplaodTaskIndex = 0;
+    MB_VECTOR<struct fb_gcs_upload_resume_state_t> _resumeStates;
+    bool _resumeStatesLoaded = false;
+    // the tasks and states are changed by the upload task and the caller of upload
+    firebase_mutex_t _resumableUploadMutex;
 
     void rescon(FirebaseData *fbdo, const char *host);
     void setGetOptions(struct firebase_gcs_req_t *req, MB_String &header, bool hasParams);
@@ -213,6 +228,8 @@ private:
     bool sendRequest(FirebaseData *fbdo, struct firebase_gcs_req_t *req);
     bool gcs_connect(FirebaseData *fbdo);
     bool gcs_sendRequest(FirebaseData *fbdo, struct firebase_gcs_req_t *req);
+    bool completeRequest(FirebaseData *fbdo, struct firebase_gcs_req_t *req);
+    bool gcs_download(FirebaseData *fbdo, struct firebase_gcs_req_t *req);
     bool handleResponse(FirebaseData *fbdo, struct firebase_gcs_req_t *req);
     bool mUpload(FirebaseData *fbdo, MB_StringPtr bucketID, MB_StringPtr localFileName,
                  firebase_mem_storage_type storageType, firebase_gcs_upload_type uploadType, MB_StringPtr remoteFileName,
@@ -231,6 +248,16 @@ private:
     bool mRunResumableUpload();
     void mResumableUploadUpdate();
     void mRunResumableUploadTask();
+    void pushResumableTask(FirebaseData *fbdo, struct firebase_gcs_req_t *req, const MB_String &location, int chunkRange);
+    void pushResumableInitTask(FirebaseData *fbdo, struct firebase_gcs_req_t *req);
+    size_t resumableTaskCount();
+    bool fileCrc32c(struct firebase_gcs_req_t *req, uint32_t &crc);
+    void updateChunkSize(struct firebase_gcs_req_t *req, uint32_t rtt);
+    void loadResumeStates();
+    void saveResumeStates();
+    int findResumeState(struct firebase_gcs_req_t *req);
+    void setResumeState(struct firebase_gcs_req_t *req, const MB_String &location, size_t offset);
+    void removeResumeState(struct firebase_gcs_req_t *req);
 };
 
 #endif
@@ -659,6 +659,35 @@ size_t FirebaseJsonBase::mGetSerializedBufferLength(bool prettify)
     return MB_JSON_SerializedBufferLength(root, prettify);
 }
 
+static size_t fb_json_print_writer(const unsigned char *data, size_t len, void *arg)
+{
+    return reinterpret_cast<Print *>(arg)->write(data, len);
+}
+
+size_t FirebaseJsonBase::mPrintTo(Print *out, bool prettify, size_t chunkSize)
+{
+    if (!root || !out)
+        return 0;
+    return MB_JSON_PrintToWriter(root, prettify, chunkSize, fb_json_print_writer, out);
+}
+
+bool FirebaseJsonBase::mHasKey(MB_JSON *parent, const char *key)
+{
+    if (!parent || !key)
+        return false;
+
+    for (MB_JSON *e = parent->child; e != NULL; e = e->next)
+    {
+        if (e->string && strcmp(e->string, key) == 0)
+            return true;
+
+        if ((isObject(e) || isArray(e)) && mHasKey(e, key))
+            return true;
+    }
+
+    return false;
+}
+
 void FirebaseJsonBase::mSetFloatDigits(uint8_t digits)
 {
     floatDigits = digits;
@@ -1107,42 +1136,14 @@ void FirebaseJsonData::delP(void *ptr)
     void **p = (void **)ptr;
     if (*p)
     {
-        free(*p);
+        MB_Alloc::free(*p);
         *p = 0;
     }
 }
 
 void *FirebaseJsonData::newP(size_t len)
 {
-    void *p;
-    size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-    if (ESP.getPsramSize() > 0)
-        p = (void *)ps_malloc(newLen);
-    else
-        p = (void *)malloc(newLen);
-    if (!p)
-        return NULL;
-
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.setExternalHeap();
-#endif
-
-    p = (void *)malloc(newLen);
-    bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.resetHeap();
-#endif
-
-    if (!nn)
-        return NULL;
-
-#endif
-    memset(p, 0, newLen);
-    return p;
+    return MB_Alloc::alloc(getReservedLen(len), mb_alloc_sys_json, true);
 }
 
 void FirebaseJsonData::clear()
@@ -132,6 +132,11 @@
 #define MB_STRING_USE_PSRAM
 #endif
 
+// The size of chunk buffer used when serializing JSON directly to Print object
+#if !defined(FIREBASEJSON_PRINT_CHUNK_SIZE)
+#define FIREBASEJSON_PRINT_CHUNK_SIZE 256
+#endif
+
 #include "MB_String.h"
 
 using namespace mb_string;
@@ -218,66 +223,17 @@ static size_t getReservedLen(size_t len)
 
 static void *fb_js_malloc(size_t len)
 {
-    void *p;
-    size_t newLen = getReservedLen(len);
-
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-    if (ESP.getPsramSize() > 0)
-        p = (void *)ps_malloc(newLen);
-    else
-        p = (void *)malloc(newLen);
-    if (!p)
-        return NULL;
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.setExternalHeap();
-#endif
-
-    p = (void *)malloc(newLen);
-    bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.resetHeap();
-#endif
-
-    if (!nn)
-        return NULL;
-#endif
-    return p;
+    return MB_Alloc::alloc(getReservedLen(len), mb_alloc_sys_json);
 }
 
 static void fb_js_free(void *ptr)
 {
-    if (ptr)
-        free(ptr);
+    MB_Alloc::free(ptr);
 }
 
 static void *fb_js_realloc(void *ptr, size_t sz)
 {
-    size_t newLen = getReservedLen(sz);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-    if (ESP.getPsramSize() > 0)
-        ptr = (void *)ps_realloc(ptr, newLen);
-    else
-        ptr = (void *)realloc(ptr, newLen);
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.setExternalHeap();
-#endif
-
-    ptr = (void *)realloc(ptr, newLen);
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-    ESP.resetHeap();
-#endif
-
-#endif
-    if (!ptr)
-        return NULL;
-
-    return ptr;
+    return MB_Alloc::realloc(ptr, getReservedLen(sz), mb_alloc_sys_json);
 }
 
 static MB_JSON_Hooks MB_JSON_hooks __attribute__((used)) = {fb_js_malloc, fb_js_free, fb_js_realloc};
@@ -645,6 +601,8 @@ private:
     bool mRemove(const char *path);
     void mGetPath(MB_String &path, MB_VECTOR<MB_String> paths, int begin = 0, int end = -1);
     size_t mGetSerializedBufferLength(bool prettify);
+    size_t mPrintTo(Print *out, bool prettify, size_t chunkSize);
+    bool mHasKey(MB_JSON *parent, const char *key);
     void mSetFloatDigits(uint8_t digits);
     void mSetDoubleDigits(uint8_t digits);
     int mResponseCode();
@@ -823,20 +781,10 @@ protected:
     template <typename T>
     bool writeStream(T &out, bool prettify)
     {
-        bool ret = false;
-
         if (!root)
             return false;
 
-        char *p = prettify ? MB_JSON_Print(root) : MB_JSON_PrintUnformatted(root);
-        if (p)
-        {
-            ret = out.write((const uint8_t *)p, strlen(p)) == strlen(p);
-            MB_JSON_free(p);
-            return ret;
-        }
-
-        return ret;
+        return mPrintTo(&out, prettify, FIREBASEJSON_PRINT_CHUNK_SIZE) == mGetSerializedBufferLength(prettify);
     }
 
     void idle()
@@ -858,7 +806,7 @@ protected:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            MB_Alloc::free(*p);
             *p = 0;
         }
     }
@@ -877,35 +825,7 @@ protected:
 
     void *newP(size_t len)
     {
-        void *p;
-        size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-        if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
-        else
-            p = (void *)malloc(newLen);
-        if (!p)
-            return NULL;
-
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.setExternalHeap();
-#endif
-
-        p = (void *)malloc(newLen);
-        bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.resetHeap();
-#endif
-
-        if (!nn)
-            return NULL;
-
-#endif
-        memset(p, 0, newLen);
-        return p;
+        return MB_Alloc::alloc(getReservedLen(len), mb_alloc_sys_json, true);
     }
 
     void strcat_c(char *str, char c)
@@ -1942,6 +1862,25 @@ public:
      */
     size_t serializedBufferLength(bool prettify = false) { return mGetSerializedBufferLength(prettify); }
 
+    /**
+     * Write the serialized FirebaseJsonArray object to Print object in chunks without
+     * creating the whole serialized string in memory.
+     *
+     * @param out The Print object e.g. Serial, File, WiFi/Ethernet Client.
+     * @param prettify The text indentation and new line serialization option.
+     * @param chunkSize The size of chunk buffer in bytes.
+     * @return the number of bytes written, which equals serializedBufferLength on success.
+     */
+    size_t printTo(Print &out, bool prettify = false, size_t chunkSize = FIREBASEJSON_PRINT_CHUNK_SIZE) { return mPrintTo(&out, prettify, chunkSize); }
+
+    /**
+     * Check whether the object key exists at any depth of FirebaseJsonArray object.
+     *
+     * @param key The object key to find.
+     * @return boolean status of the key existence.
+     */
+    bool containsKey(const char *key) { return mHasKey(root, key); }
+
     /**
      * Clear all array in FirebaseJsonArray object.
      *
@@ -2615,6 +2554,25 @@ public:
      */
     size_t serializedBufferLength(bool prettify = false) { return mGetSerializedBufferLength(prettify); }
 
+    /**
+     * Write the serialized FirebaseJson object to Print object in chunks without
+     * creating the whole serialized string in memory.
+     *
+     * @param out The Print object e.g. Serial, File, WiFi/Ethernet Client.
+     * @param prettify The text indentation and new line serialization option.
+     * @param chunkSize The size of chunk buffer in bytes.
+     * @return the number of bytes written, which equals serializedBufferLength on success.
+     */
+    size_t printTo(Print &out, bool prettify = false, size_t chunkSize = FIREBASEJSON_PRINT_CHUNK_SIZE) { return mPrintTo(&out, prettify, chunkSize); }
+
+    /**
+     * Check whether the object key exists at any depth of FirebaseJson object.
+     *
+     * @param key The object key to find.
+     * @return boolean status of the key existence.
+     */
+    bool containsKey(const char *key) { return mHasKey(root, key); }
+
     /**
      * Set the precision for float to JSON object
      * @param digits The number of decimal places.
@@ -0,0 +1,558 @@
+/*
+ * The memory allocator with size-class routing and usage accounting, MB_Alloc v1.0.0
+ *
+ * Created October 19, 2026
+ *
+ * All blocks carry a small header that records the requested size, the owner subsystem
+ * and the memory region, which allows the per-subsystem accounting and budgets, and
+ * lets free() and realloc() return the block to where it was taken from.
+ *
+ * The blocks are routed by size,
+ * - blocks that are equal to or larger than the pool threshold are taken from the static pool (if assigned),
+ * - blocks that are equal to or larger than the PSRAM threshold are taken from PSRAM (if available),
+ * - other blocks are taken from the internal heap.
+ * The block falls back to the next region when the preferred region is exhausted.
+ *
+ * The usage is accounted and budgeted per subsystem (the kind of memory e.g. strings, JSON, TLS)
+ * rather than per service (RTDB, Firestore, FCM,...). The allocation sites are shared by all services
+ * and the same buffer is used by the different services e.g. a FirebaseJson object is built by the user
+ * and sent by any service, then there is no owner service that can be known at the allocation time.
+ * The TLS and payload subsystems are the large and per-connection memory which can be budgeted to
+ * limit what the services can hold.
+ *
+ * The allocations, the pool and the accounting are guarded by a mutex on ESP32 and RP2040 where the
+ * library runs in more than one task.
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MB_ALLOC_H
+#define MB_ALLOC_H
+
+#include <Arduino.h>
+
+#if defined(ESP8266) && defined(MMU_EXTERNAL_HEAP)
+#include <umm_malloc/umm_malloc.h>
+#include <umm_malloc/umm_heap_select.h>
+#define MB_ALLOC_ESP8266_EXTERNAL_HEAP
+#endif
+
+#if (defined(BOARD_HAS_PSRAM) && defined(ESP32)) || defined(MB_ALLOC_ESP8266_EXTERNAL_HEAP)
+#define MB_ALLOC_HAS_EXTERNAL_RAM
+#endif
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#elif defined(ARDUINO_ARCH_RP2040)
+#include <pico/mutex.h>
+#endif
+
+namespace mb_alloc
+{
+    enum mb_alloc_sys
+    {
+        mb_alloc_sys_string,  // MB_String buffers
+        mb_alloc_sys_json,    // FirebaseJson nodes and print buffers
+        mb_alloc_sys_buffer,  // transfer, chunk and codec buffers (MB_FS::newP)
+        mb_alloc_sys_tls,     // TLS I/O and handshake buffers
+        mb_alloc_sys_payload, // response payloads e.g. blob data
+        mb_alloc_sys_user,
+        mb_alloc_sys_max
+    };
+
+    enum mb_alloc_region
+    {
+        mb_alloc_region_heap,
+        mb_alloc_region_psram,
+        mb_alloc_region_pool
+    };
+
+    typedef struct mb_alloc_stats_t
+    {
+        // The bytes currently in use
+        size_t used = 0;
+        // The highest bytes in use since started or resetPeak
+        size_t peak = 0;
+        // The maximum bytes allowed, 0 for unlimited
+        size_t budget = 0;
+        // The number of blocks currently in use
+        uint32_t blocks = 0;
+        // The number of failed allocations (out of memory or over budget)
+        uint32_t failed = 0;
+    } MB_AllocStats;
+}
+
+using namespace mb_alloc;
+
+class MB_Alloc
+{
+public:
+    /**
+     * Allocate the memory block.
+     * @param len The size of block in bytes.
+     * @param sys The subsystem that owns the block.
+     * @param clear Set the block content to zero.
+     * @return The pointer to the block or NULL if out of memory or budget.
+     */
+    static void *alloc(size_t len, mb_alloc_sys sys, bool clear = false)
+    {
+        if (len == 0 || sys >= mb_alloc_sys_max)
+            return NULL;
+
+        guard_t guard;
+
+        if (!charge(sys, 0, len))
+            return NULL;
+
+        block_header_t *h = take(len);
+
+        if (!h)
+        {
+            uncharge(sys, len, true);
+            return NULL;
+        }
+
+        h->size = len;
+        h->sys = sys;
+        h->tag = tagOf(h);
+
+        if (clear)
+            memset(h + 1, 0, len);
+
+        return h + 1;
+    }
+
+    /**
+     * Resize the memory block that was allocated by alloc.
+     * @param ptr The pointer to the block or NULL to allocate the new block.
+     * @param len The new size of block in bytes.
+     * @param sys The subsystem that owns the block.
+     * @return The pointer to the resized block or NULL if out of memory or budget
+     * which the original block is left untouched.
+     */
+    static void *realloc(void *ptr, size_t len, mb_alloc_sys sys)
+    {
+        if (!ptr)
+            return alloc(len, sys);
+
+        if (len == 0)
+        {
+            free(ptr);
+            return NULL;
+        }
+
+        guard_t guard;
+
+        block_header_t *h = header(ptr);
+        if (!h)
+            return NULL;
+
+        size_t old = h->size;
+        mb_alloc_sys owner = (mb_alloc_sys)h->sys;
+
+        if (!charge(owner, old, len))
+            return NULL;
+
+        block_header_t *nh = NULL;
+
+        if (h->region == mb_alloc_region_pool)
+        {
+            if (len <= poolCapacity(h))
+                nh = h;
+            else if ((nh = take(len)) != NULL)
+            {
+                memcpy(nh + 1, h + 1, old);
+                poolRelease(h);
+            }
+        }
+        else
+            nh = resize(h, len);
+
+        if (!nh)
+        {
+            // restore the usage of original block
+            MB_AllocStats &st = state().stats[owner];
+            st.used = st.used - len + old;
+            st.failed++;
+            return NULL;
+        }
+
+        nh->size = len;
+        nh->sys = owner;
+        nh->tag = tagOf(nh);
+        return nh + 1;
+    }
+
+    /**
+     * Free the memory block that was allocated by alloc or realloc.
+     * @param ptr The pointer to the block.
+     */
+    static void free(void *ptr)
+    {
+        if (!ptr)
+            return;
+
+        guard_t guard;
+
+        block_header_t *h = header(ptr);
+        if (!h)
+            return;
+
+        uncharge((mb_alloc_sys)h->sys, h->size, false);
+        h->tag = 0;
+
+        if (h->region == mb_alloc_region_pool)
+            poolRelease(h);
+        else
+            ::free(h);
+    }
+
+    /**
+     * Set the maximum bytes that the subsystem can hold.
+     * @param sys The subsystem.
+     * @param budget The maximum bytes, 0 for unlimited.
+     */
+    static void setBudget(mb_alloc_sys sys, size_t budget)
+    {
+        guard_t guard;
+        if (sys < mb_alloc_sys_max)
+            state().stats[sys].budget = budget;
+    }
+
+    /**
+     * Route the blocks that are equal to or larger than the threshold to PSRAM (or ESP8266 external heap).
+     * @param threshold The size in bytes, 0 to route all blocks, (size_t)-1 to disable.
+     */
+    static void setPSRAMThreshold(size_t threshold)
+    {
+        guard_t guard;
+        state().psramThreshold = threshold;
+    }
+
+    /**
+     * Assign the preallocated static memory pool for the large blocks.
+     * @param pool The pointer to the pool memory that must outlive all blocks allocated from it.
+     * @param size The size of pool in bytes.
+     * @param threshold The minimum block size in bytes that is taken from the pool.
+     * @return The pool was assigned or not, the pool can be assigned only once.
+     */
+    static bool setPool(void *pool, size_t size, size_t threshold)
+    {
+        guard_t guard;
+        state_t &s = state();
+        if (s.pool || !pool || size < sizeof(block_header_t) * 2)
+            return false;
+
+        // align the pool start and size to the block header
+        uintptr_t p = (reinterpret_cast<uintptr_t>(pool) + sizeof(block_header_t) - 1) & ~(uintptr_t)(sizeof(block_header_t) - 1);
+        size -= p - reinterpret_cast<uintptr_t>(pool);
+        size &= ~(sizeof(block_header_t) - 1);
+
+        s.pool = reinterpret_cast<uint8_t *>(p);
+        s.poolSize = size;
+        s.poolThreshold = threshold;
+
+        block_header_t *h = reinterpret_cast<block_header_t *>(s.pool);
+        h->capacity = size - sizeof(block_header_t);
+        h->size = 0;
+        h->region = mb_alloc_region_pool;
+        h->tag = 0;
+        return true;
+    }
+
+    /**
+     * Get the usage of subsystem.
+     * @param sys The subsystem.
+     * @return The reference to the usage stats.
+     */
+    static const MB_AllocStats &stats(mb_alloc_sys sys) { return state().stats[sys < mb_alloc_sys_max ? sys : mb_alloc_sys_user]; }
+
+    /**
+     * Get the total bytes in use of all subsystems.
+     */
+    static size_t totalUsed()
+    {
+        guard_t guard;
+        size_t total = 0;
+        for (int i = 0; i < mb_alloc_sys_max; i++)
+            total += state().stats[i].used;
+        return total;
+    }
+
+    /**
+     * Reset the peak usage of all subsystems to their current usage.
+     */
+    static void resetPeak()
+    {
+        guard_t guard;
+        for (int i = 0; i < mb_alloc_sys_max; i++)
+            state().stats[i].peak = state().stats[i].used;
+    }
+
+private:
+    static const uint32_t tagKey = 0x4D42A10CUL;
+
+    // 16 bytes header keeps the 8-byte alignment of the block data
+    typedef struct block_header_t
+    {
+        // The requested size (allocated block) or 0 (free pool block)
+        uint32_t size;
+        // The pool block capacity in bytes (pool blocks only)
+        uint32_t capacity;
+        uint8_t sys;
+        uint8_t region;
+        uint16_t reserved;
+        // The block owner tag which is derived from the block address, 0 when freed
+        uint32_t tag;
+    } block_header_t;
+
+    typedef struct lock_t
+    {
+#if defined(ESP32)
+        StaticSemaphore_t buf;
+        SemaphoreHandle_t handle;
+        lock_t() { handle = xSemaphoreCreateRecursiveMutexStatic(&buf); }
+        void take() { xSemaphoreTakeRecursive(handle, portMAX_DELAY); }
+        void give() { xSemaphoreGiveRecursive(handle); }
+#elif defined(ARDUINO_ARCH_RP2040)
+        recursive_mutex_t mutex;
+        lock_t() { recursive_mutex_init(&mutex); }
+        void take() { recursive_mutex_enter_blocking(&mutex); }
+        void give() { recursive_mutex_exit(&mutex); }
+#else
+        void take() {}
+        void give() {}
+#endif
+    } lock_t;
+
+    typedef struct state_t
+    {
+        MB_AllocStats stats[mb_alloc_sys_max];
+#if defined(MB_ALLOC_HAS_EXTERNAL_RAM) && (defined(MB_STRING_USE_PSRAM) || defined(FIREBASE_USE_PSRAM))
+        size_t psramThreshold = 0;
+#else
+        size_t psramThreshold = (size_t)-1;
+#endif
+        uint8_t *pool = NULL;
+        size_t poolSize = 0;
+        size_t poolThreshold = (size_t)-1;
+        lock_t lock;
+    } state_t;
+
+    struct guard_t
+    {
+        guard_t() { state().lock.take(); }
+        ~guard_t() { state().lock.give(); }
+    };
+
+    static state_t &state()
+    {
+        static state_t s;
+        return s;
+    }
+
+    static uint32_t tagOf(block_header_t *h) { return (uint32_t)reinterpret_cast<uintptr_t>(h) ^ tagKey; }
+
+    static bool inPool(block_header_t *h)
+    {
+        state_t &s = state();
+        uint8_t *p = reinterpret_cast<uint8_t *>(h);
+        return s.pool && p >= s.pool && p + sizeof(block_header_t) <= s.pool + s.poolSize;
+    }
+
+    static block_header_t *header(void *ptr)
+    {
+        if (!ptr)
+            return NULL;
+        block_header_t *h = reinterpret_cast<block_header_t *>(ptr) - 1;
+
+        // the block that was not allocated here has no matched tag, the pool block should be in the pool
+        if (h->tag != tagOf(h) || h->region > mb_alloc_region_pool || h->sys >= mb_alloc_sys_max)
+            return NULL;
+        if (h->region == mb_alloc_region_pool && !inPool(h))
+            return NULL;
+        return h;
+    }
+
+    static bool charge(mb_alloc_sys sys, size_t old, size_t len)
+    {
+        MB_AllocStats &st = state().stats[sys];
+
+        if (len > old && st.budget > 0 && st.used - old + len > st.budget)
+        {
+            st.failed++;
+            return false;
+        }
+
+        st.used = st.used - old + len;
+        if (old == 0)
+            st.blocks++;
+        if (st.used > st.peak)
+            st.peak = st.used;
+        return true;
+    }
+
+    static void uncharge(mb_alloc_sys sys, size_t len, bool failed)
+    {
+        MB_AllocStats &st = state().stats[sys];
+        st.used -= len <= st.used ? len : st.used;
+        if (failed)
+            st.failed++;
+        else if (st.blocks > 0)
+            st.blocks--;
+    }
+
+    static bool externalAvailable()
+    {
+#if defined(BOARD_HAS_PSRAM) && defined(ESP32)
+        return ESP.getPsramSize() > 0;
+#elif defined(MB_ALLOC_ESP8266_EXTERNAL_HEAP)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void *heapAlloc(size_t len, bool &external)
+    {
+        void *p = NULL;
+#if defined(BOARD_HAS_PSRAM) && defined(ESP32)
+        if (external)
+            p = ps_malloc(len);
+#elif defined(MB_ALLOC_ESP8266_EXTERNAL_HEAP)
+        if (external)
+        {
+            ESP.setExternalHeap();
+            p = malloc(len);
+            ESP.resetHeap();
+        }
+#endif
+        if (!p)
+        {
+            external = false;
+            p = malloc(len);
+        }
+        return p;
+    }
+
+    static block_header_t *take(size_t len)
+    {
+        state_t &s = state();
+        size_t total = len + sizeof(block_header_t);
+
+        block_header_t *h = NULL;
+
+        if (s.pool && len >= s.poolThreshold)
+            h = poolTake(len);
+
+        if (!h)
+        {
+            bool external = len >= s.psramThreshold && externalAvailable();
+            h = reinterpret_cast<block_header_t *>(heapAlloc(total, external));
+            if (h)
+                h->region = external ? mb_alloc_region_psram : mb_alloc_region_heap;
+        }
+
+        return h;
+    }
+
+    static block_header_t *resize(block_header_t *h, size_t len)
+    {
+        size_t total = len + sizeof(block_header_t);
+        void *p = NULL;
+
+#if defined(BOARD_HAS_PSRAM) && defined(ESP32)
+        if (h->region == mb_alloc_region_psram)
+            p = ps_realloc(h, total);
+        else
+            p = ::realloc(h, total);
+#elif defined(MB_ALLOC_ESP8266_EXTERNAL_HEAP)
+        if (h->region == mb_alloc_region_psram)
+            ESP.setExternalHeap();
+        p = ::realloc(h, total);
+        if (h->region == mb_alloc_region_psram)
+            ESP.resetHeap();
+#else
+        p = ::realloc(h, total);
+#endif
+        return reinterpret_cast<block_header_t *>(p);
+    }
+
+    static size_t poolCapacity(block_header_t *h) { return h->capacity; }
+
+    static block_header_t *poolNext(block_header_t *h)
+    {
+        state_t &s = state();
+        uint8_t *n = reinterpret_cast<uint8_t *>(h + 1) + poolCapacity(h);
+        return n < s.pool + s.poolSize ? reinterpret_cast<block_header_t *>(n) : NULL;
+    }
+
+    static block_header_t *poolTake(size_t len)
+    {
+        // round up to the header size
+        size_t need = (len + sizeof(block_header_t) - 1) & ~(sizeof(block_header_t) - 1);
+
+        // first fit
+        for (block_header_t *h = reinterpret_cast<block_header_t *>(state().pool); h; h = poolNext(h))
+        {
+            if (h->tag == tagOf(h) || poolCapacity(h) < need)
+                continue;
+
+            size_t rest = poolCapacity(h) - need;
+
+            // split when the remaining space can hold another block
+            if (rest > sizeof(block_header_t))
+            {
+                h->capacity = need;
+                block_header_t *n = poolNext(h);
+                n->capacity = rest - sizeof(block_header_t);
+                n->size = 0;
+                n->region = mb_alloc_region_pool;
+                n->tag = 0;
+            }
+
+            h->region = mb_alloc_region_pool;
+            // mark it in use before the pool is coalesced e.g. when realloc releases the old block
+            h->tag = tagOf(h);
+            return h;
+        }
+
+        return NULL;
+    }
+
+    static void poolRelease(block_header_t *h)
+    {
+        h->tag = 0;
+        h->size = 0;
+
+        // coalesce the adjacent free blocks
+        for (block_header_t *b = reinterpret_cast<block_header_t *>(state().pool); b; b = poolNext(b))
+        {
+            block_header_t *n;
+            while (b->tag != tagOf(b) && (n = poolNext(b)) != NULL && n->tag != tagOf(n))
+                b->capacity = poolCapacity(b) + sizeof(block_header_t) + poolCapacity(n);
+        }
+    }
+};
+
+#endif
@@ -454,6 +454,9 @@ typedef struct
     MB_JSON_bool noalloc;
     MB_JSON_bool format; /* is this print a formatted print */
     MB_JSON_internal_hooks hooks;
+    MB_JSON_writer writer; /* when set, the buffer is flushed to the writer instead of growing */
+    void *writer_arg;
+    size_t written; /* number of bytes flushed to the writer */
 } MB_JSON_printbuffer;
 
 typedef struct
@@ -463,6 +466,29 @@ typedef struct
     MB_JSON_bool format;
 } MB_JSON_buffer_len_data_t;
 
+/* hand the pending bytes of a MB_JSON_printbuffer to its writer and rewind the buffer */
+static MB_JSON_bool MB_JSON_flush(MB_JSON_printbuffer *const p)
+{
+    if ((p == NULL) || (p->buffer == NULL) || (p->writer == NULL))
+    {
+        return false;
+    }
+
+    if (p->offset > 0)
+    {
+        if (p->writer(p->buffer, p->offset, p->writer_arg) != p->offset)
+        {
+            return false;
+        }
+        p->written += p->offset;
+        p->offset = 0;
+    }
+
+    p->buffer[0] = '\0';
+
+    return true;
+}
+
 /* realloc MB_JSON_printbuffer if necessary to have at least "needed" bytes more */
 static unsigned char *MB_JSON_ensure(MB_JSON_printbuffer *const p, size_t needed)
 {
@@ -486,6 +512,15 @@ static unsigned char *MB_JSON_ensure(MB_JSON_printbuffer *const p, size_t needed
         return NULL;
     }
 
+    if ((p->writer != NULL) && (needed + p->offset + 1 > p->length))
+    {
+        /* streaming print, send what we have so far before growing the buffer */
+        if (!MB_JSON_flush(p))
+        {
+            return NULL;
+        }
+    }
+
     needed += p->offset + 1;
     if (needed <= p->length)
     {
@@ -570,22 +605,12 @@ static MB_JSON_bool MB_JSON_compare_double(double a, double b)
     return (fabs(a - b) <= maxVal * DBL_EPSILON);
 }
 
-/* Render the number nicely from the given item into a string. */
-static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
+/* Print the number into number_buffer (at least 26 bytes) and return its length, or -1 on failure. */
+static int MB_JSON_format_number(double d, unsigned char *number_buffer)
 {
-    unsigned char *output_pointer = NULL;
-    double d = item->valuedouble;
     int length = 0;
-    size_t i = 0;
-    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
-    unsigned char decimal_point = MB_JSON_get_decimal_point();
     double test = 0.0;
 
-    if (output_buffer == NULL)
-    {
-        return false;
-    }
-
     /* This checks for NaN and Infinity */
     if (isnan(d) || isinf(d))
     {
@@ -605,7 +630,30 @@ static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_prin
     }
 
     /* sprintf failed or buffer overrun occurred */
-    if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
+    if ((length < 0) || (length > 25))
+    {
+        return -1;
+    }
+
+    return length;
+}
+
+/* Render the number nicely from the given item into a string. */
+static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    int length = 0;
+    size_t i = 0;
+    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
+    unsigned char decimal_point = MB_JSON_get_decimal_point();
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    length = MB_JSON_format_number(item->valuedouble, number_buffer);
+    if (length < 0)
     {
         return false;
     }
@@ -1406,6 +1454,52 @@ MB_JSON_PrintPreallocated(MB_JSON *item, char *buffer, const int length, const M
     return MB_JSON_print_value(item, &p);
 }
 
+MB_JSON_PUBLIC(size_t)
+MB_JSON_PrintToWriter(const MB_JSON *item, MB_JSON_bool format, size_t chunk_size, MB_JSON_writer writer, void *arg)
+{
+    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}, 0, 0, 0};
+    size_t written = 0;
+
+    if ((item == NULL) || (writer == NULL))
+    {
+        return 0;
+    }
+
+    if (chunk_size < 32)
+    {
+        chunk_size = 32;
+    }
+
+    p.buffer = (unsigned char *)MB_JSON_global_hooks.allocate(chunk_size);
+    if (!p.buffer)
+    {
+        return 0;
+    }
+
+    p.buffer[0] = '\0';
+    p.length = chunk_size;
+    p.format = format;
+    p.hooks = MB_JSON_global_hooks;
+    p.writer = writer;
+    p.writer_arg = arg;
+
+    if (MB_JSON_print_value(item, &p))
+    {
+        MB_JSON_update_offset(&p);
+        if (MB_JSON_flush(&p))
+        {
+            written = p.written;
+        }
+    }
+
+    if (p.buffer != NULL)
+    {
+        MB_JSON_global_hooks.deallocate(p.buffer);
+    }
+
+    return written;
+}
+
 /* Parser core - when encountering text, process appropriately. */
 static MB_JSON_bool MB_JSON_parse_value(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer)
 {
@@ -1478,6 +1572,19 @@ static MB_JSON_bool MB_JSON_get_value_buffer_length(const MB_JSON *const item, M
         buf_len->size += 4;
         return true;
 
+    case MB_JSON_Number:
+    {
+        unsigned char number_buffer[26] = {0};
+        int length = MB_JSON_format_number(item->valuedouble, number_buffer);
+        if (length < 0)
+        {
+            return false;
+        }
+
+        buf_len->size += (size_t)length;
+        return true;
+    }
+
     case MB_JSON_Raw:
     {
 
@@ -1979,13 +2086,13 @@ static MB_JSON_bool MB_JSON_get_object_buffer_length(const MB_JSON *const item,
     //'{' or "{\n"
     length = (size_t)(buf_len->format && current_item != NULL ? 2 : 1); 
 
+    buf_len->size += length;
+
     //do nothing for empty object
     if (current_item != NULL)
     {
         buf_len->depth++;
 
-        buf_len->size += length;
-
         while (current_item)
         {
             //'\t'
@@ -140,6 +140,9 @@ typedef struct MB_JSON_Hooks
 
 typedef int MB_JSON_bool;
 
+/* Output sink used by MB_JSON_PrintToWriter, returns the number of bytes accepted. */
+typedef size_t (*MB_JSON_writer)(const unsigned char *data, size_t len, void *arg);
+
 /* Limits how deeply nested arrays/objects can be before MB_JSON rejects to parse them.
  * This is to prevent stack overflows. */
 #ifndef MB_JSON_NESTING_LIMIT
@@ -173,6 +176,10 @@ MB_JSON_PUBLIC(char *) MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer,
 /* Render a MB_JSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
 /* NOTE: MB_JSON is not always 100% accurate in estimating how much memory it will use, so to be safe allocate 5 bytes more than you actually need */
 MB_JSON_PUBLIC(MB_JSON_bool) MB_JSON_PrintPreallocated(MB_JSON *item, char *buffer, const int length, const MB_JSON_bool format);
+/* Render a MB_JSON entity to text in chunks of chunk_size bytes which are passed to writer as they fill up, no full copy of the text is made. */
+/* Only a token longer than chunk_size (e.g. a long string value) will grow the chunk. Returns the number of bytes written, 0 on failure. */
+/* The output length can be obtained beforehand without allocation from MB_JSON_SerializedBufferLength. */
+MB_JSON_PUBLIC(size_t) MB_JSON_PrintToWriter(const MB_JSON *item, MB_JSON_bool format, size_t chunk_size, MB_JSON_writer writer, void *arg);
 /* Delete a MB_JSON entity and all subentities. */
 MB_JSON_PUBLIC(void) MB_JSON_Delete(MB_JSON *item);
 
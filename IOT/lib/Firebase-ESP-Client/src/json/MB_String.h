@@ -1,11 +1,23 @@
 
 /**
- * Mobizt's SRAM/PSRAM supported String, version 1.2.12
+ * Mobizt's SRAM/PSRAM supported String, version 1.2.15
  *
  * Created March 25, 2024
  *
  * Changes Log
  *
+ * v1.2.15
+ * - append(cstr, n) does not read past n bytes
+ *
+ * v1.2.14
+ * - allocate through MB_Alloc
+ *
+ * v1.2.13
+ * - add small string inline buffer (MB_STRING_SSO_SIZE)
+ * - geometric capacity growth on append
+ * - add move constructor and move assignment
+ * - fix shrinking realloc writes past the new buffer end
+ *
  * v1.2.12
  * - using std namespace
  * 
@@ -92,6 +104,7 @@
 #include <strings.h>
 #include <algorithm>
 #endif
+#include "MB_Alloc.h"
 
 #define MB_STRING_MAJOR 1
 #define MB_STRING_MINOR 2
@@ -103,6 +116,16 @@
 #define ESP8266_USE_EXTERNAL_HEAP
 #endif
 
+// The inline buffer size (including the null terminator) for short strings which
+// are stored inside the object without heap allocation, 0 to disable.
+#if !defined(MB_STRING_SSO_SIZE)
+#if defined(__AVR__) || defined(ESP8266_USE_EXTERNAL_HEAP)
+#define MB_STRING_SSO_SIZE 0
+#else
+#define MB_STRING_SSO_SIZE 16
+#endif
+#endif
+
 #if defined(ESP8266) || defined(ESP32)
 #define MBSTRING_FLASH_MCR FPSTR
 #elif defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT)
@@ -524,6 +547,11 @@ public:
         *this = value;
     }
 
+    MB_String(MB_String &&value) noexcept
+    {
+        move(value);
+    }
+
     MB_String(const __FlashStringHelper *str)
     {
         *this = str;
@@ -748,6 +776,12 @@ public:
         return *this;
     }
 
+    MB_String &operator=(MB_String &&rhs) noexcept
+    {
+        move(rhs);
+        return *this;
+    }
+
     MB_String &operator+=(const MB_String &rhs)
     {
         concat(rhs);
@@ -1017,7 +1051,7 @@ public:
         {
             memmove(buf, buf + p1, p2 - p1 + 1);
             buf[p2 - p1 + 1] = '\0';
-            _reserve(p2 - p1 + 1, true);
+            _compact();
         }
     }
 
@@ -1028,8 +1062,10 @@ public:
 
         size_t slen = length();
 
-        if (n > strlen(cstr))
-            n = strlen(cstr);
+        // stop at the null terminator within n without reading past n
+        const char *end = reinterpret_cast<const char *>(memchr(cstr, 0, n));
+        if (end)
+            n = end - cstr;
 
         if (_reserve(slen + n, false))
         {
@@ -1103,7 +1139,12 @@ public:
 
     void swap(MB_String &rhs)
     {
-        rhs.clear();
+        if (this == &rhs)
+            return;
+        MB_String temp;
+        temp.move(rhs);
+        rhs.move(*this);
+        move(temp);
     }
 
     void shrink_to_fit()
@@ -1119,7 +1160,7 @@ public:
             size_t slen = length();
             if (slen > 0)
                 buf[slen - 1] = '\0';
-            _reserve(slen, true);
+            _compact();
         }
     }
 
@@ -1175,7 +1216,7 @@ public:
 
         buf[index + rightLen] = '\0';
 
-        _reserve(length(), true);
+        _compact();
     }
 
     size_t length() const
@@ -1216,14 +1257,11 @@ public:
     {
         if (len == 0)
             len = 4;
-        ESP.setExternalHeap();
-        if (buf)
-            buf = (char *)realloc(buf, len);
-        else
-            buf = (char *)malloc(len);
-        ESP.resetHeap();
+        char *p = (char *)MB_Alloc::realloc(buf, len, mb_alloc_sys_string);
+        if (p)
+            buf = p;
 
-        if (buf)
+        if (p)
         {
             bufLen = len;
             memset(buf, 0, len);
@@ -1580,35 +1618,7 @@ private:
 
     void *newP(size_t len)
     {
-        void *p;
-        size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-        if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
-        else
-            p = (void *)malloc(newLen);
-        if (!p)
-            return NULL;
-
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.setExternalHeap();
-#endif
-
-        p = (void *)malloc(newLen);
-        bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.resetHeap();
-#endif
-
-        if (!nn)
-            return NULL;
-
-#endif
-        memset(p, 0, newLen);
-        return p;
+        return MB_Alloc::alloc(getReservedLen(len), mb_alloc_sys_string, true);
     }
 
     void delP(void *ptr)
@@ -1616,7 +1626,7 @@ private:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            MB_Alloc::free(*p);
             *p = 0;
         }
     }
@@ -1689,25 +1699,29 @@ private:
         concat(cstr, strlen(cstr));
     }
 
+    bool onHeap() const
+    {
+        return buf && buf != sso;
+    }
+
     void move(MB_String &rhs)
     {
-        if (buf)
+        if (this == &rhs)
+            return;
+
+        allocate(0, false);
+
+        if (rhs.onHeap())
+            buf = rhs.buf;
+        else if (rhs.buf)
         {
-            if (bufLen >= rhs.bufLen)
-            {
-                strcpy(buf, rhs.buf);
-                bufLen = rhs.bufLen;
-                rhs.bufLen = 0;
-                return;
-            }
-            else
-            {
-                free(buf);
-            }
+            memcpy(sso, rhs.sso, rhs.bufLen);
+            buf = sso;
         }
-        buf = rhs.buf;
+
         bufLen = rhs.bufLen;
         rhs.buf = NULL;
+        rhs.bufLen = 0;
     }
 
     void allocate(size_t len, bool shrink)
@@ -1715,61 +1729,59 @@ private:
 
         if (len == 0)
         {
-            if (buf)
-                free(buf);
+            if (onHeap())
+                MB_Alloc::free(buf);
             buf = NULL;
             bufLen = 0;
             return;
         }
 
-        if (len > bufLen || shrink)
-        {
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-            ESP.setExternalHeap();
-#endif
+        if (len <= bufLen && !shrink)
+            return;
 
-            if (shrink || (bufLen > 0 && buf))
-            {
-                int slen = length();
+        size_t slen = length();
+        if (slen >= len)
+            slen = len - 1;
 
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-                if (ESP.getPsramSize() > 0)
-                    buf = (char *)ps_realloc(buf, len);
-                else
-                    buf = (char *)realloc(buf, len);
-#else
-                buf = (char *)realloc(buf, len);
-#endif
-                if (buf)
-                {
-                    buf[slen] = '\0';
-                    bufLen = len;
-                }
-            }
-            else
+        // Short string, keep it in (or bring it back to) the inline buffer.
+        if (len <= ssoLen && (shrink || !onHeap()))
+        {
+            if (onHeap())
             {
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-                if (ESP.getPsramSize() > 0)
-                    buf = (char *)ps_malloc(len);
-                else
-                    buf = (char *)malloc(len);
-#else
-                buf = (char *)malloc(len);
-#endif
-                if (buf)
-                {
-                    buf[0] = '\0';
-                    bufLen = len;
-                }
+                memcpy(sso, buf, slen);
+                MB_Alloc::free(buf);
             }
+            buf = sso;
+            buf[slen] = '\0';
+            bufLen = ssoLen;
+            return;
+        }
 
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-            ESP.resetHeap();
-#endif
+        // Grow geometrically (1.5x) to amortize the repeated appends.
+        if (!shrink && bufLen > 0 && len < bufLen + bufLen / 2)
+            len = getReservedLen(bufLen + bufLen / 2 - 1);
+
+        char *p = (char *)(onHeap() ? MB_Alloc::realloc(buf, len, mb_alloc_sys_string) : MB_Alloc::alloc(len, mb_alloc_sys_string));
+
+        if (p)
+        {
+            if (buf == sso)
+                memcpy(p, sso, slen);
+            buf = p;
+            buf[slen] = '\0';
+            bufLen = len;
         }
     }
 
+    // Release the excess capacity left behind by erase, trim and pop_back
+    // only when it is more than half of the buffer.
+    void _compact()
+    {
+        size_t newlen = getReservedLen(length());
+        if (newlen <= ssoLen || newlen * 2 < bufLen)
+            allocate(newlen, true);
+    }
+
     MB_String &copy(const char *cstr, size_t length)
     {
 
@@ -2036,8 +2048,10 @@ private:
     }
 #endif
 
+    static const size_t ssoLen = MB_STRING_SSO_SIZE;
     char *buf = NULL;
     size_t bufLen = 0;
+    char sso[MB_STRING_SSO_SIZE > 0 ? MB_STRING_SSO_SIZE : 1];
 };
 
 inline MB_String operator+(const MB_String &lhs, const MB_String &rhs)
@@ -2060,13 +2074,13 @@ inline MB_String operator+(MB_String &&lhs, const MB_String &rhs)
 inline MB_String operator+(MB_String &lhs, MB_String &&rhs)
 {
     lhs += rhs;
-    return std::move(lhs);
+    return lhs;
 }
 
 inline MB_String operator+(MB_String &lhs, char rhs)
 {
     lhs += rhs;
-    return std::move(lhs);
+    return lhs;
 }
 
 inline MB_String operator+(char lhs, MB_String &rhs)
@@ -1,5 +1,5 @@
 /**
- * The MB_FS, filesystems wrapper class v1.0.17
+ * The MB_FS, filesystems wrapper class v1.0.18
  *
  * This wrapper class is for SD and Flash filesystems interface which supports SdFat (//https://github.com/greiman/SdFat)
  *
@@ -745,6 +745,36 @@ public:
 #endif
         }
 
+#endif
+        return false;
+    }
+
+    // Rename the closed file, the existing file of new name will be replaced.
+    bool rename(const MB_String &from, const MB_String &to, mbfs_file_type type)
+    {
+        if (!checkStorageReady(type) || !existed(from, type))
+            return false;
+
+        // some filesystems do not replace the existing file
+        if (existed(to, type) && !remove(to, type))
+            return false;
+
+#if defined(MBFS_FLASH_FS)
+        if (type == mbfs_flash)
+            return MBFS_FLASH_FS.rename(from.c_str(), to.c_str());
+#endif
+#if defined(MBFS_SD_FS)
+        if (type == mbfs_sd)
+        {
+#if defined(MBFS_ESP32_SDFAT_ENABLED) || defined(MBFS_SDFAT_ENABLED)
+            MBFS_SD_FILE file;
+            bool ret = file.open(from.c_str(), O_RDWR) && file.rename(to.c_str());
+            file.close();
+            return ret;
+#elif defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO)
+            return MBFS_SD_FS.rename(from.c_str(), to.c_str());
+#endif
+        }
 #endif
         return false;
     }
@@ -803,7 +833,7 @@ public:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            MB_Alloc::free(*p);
             *p = 0;
         }
     }
@@ -811,38 +841,7 @@ public:
     // Allocate memory
     void *newP(size_t len, bool clear = true)
     {
-        void *p;
-        size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
-
-        if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
-        else
-            p = (void *)malloc(newLen);
-
-        if (!p)
-            return NULL;
-
-#else
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.setExternalHeap();
-#endif
-
-        p = (void *)malloc(newLen);
-        bool nn = p ? true : false;
-
-#if defined(ESP8266_USE_EXTERNAL_HEAP)
-        ESP.resetHeap();
-#endif
-
-        if (!nn)
-            return NULL;
-
-#endif
-        if (clear)
-            memset(p, 0, newLen);
-        return p;
+        return MB_Alloc::alloc(getReservedLen(len), mb_alloc_sys_buffer, clear);
     }
 
     size_t getReservedLen(size_t len)
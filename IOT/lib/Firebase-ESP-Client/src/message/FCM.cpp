@@ -83,6 +83,158 @@ bool FB_CM::send(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg)
     return ret;
 }
 
+bool FB_CM::sendAll(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg, const char *targets[], size_t numTargets,
+                    FCM_HTTPv1_Result *results, uint8_t pipeline)
+{
+    Core.tokenReady();
+
+    if (Core.getTokenType() != token_type_oauth2_access_token)
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_OAUTH2_REQUIRED;
+        return false;
+    }
+
+    if (pipeline < 1)
+        pipeline = 1;
+    else if (pipeline > fcm_max_pipeline)
+        pipeline = fcm_max_pipeline;
+
+    fbdo->tcpClient.setSPIEthernet(_spi_ethernet_module);
+
+    int ret = beginRequest(fbdo);
+    if (ret < 1)
+        return ret == 0;
+
+    for (size_t i = 0; results && i < numTargets; i++)
+    {
+        results[i].code = 0;
+        results[i].name.clear();
+        results[i].error.clear();
+    }
+
+    // build the message without target once, the target of each request is inserted
+    // at the beginning of the message object
+    MB_String token = msg->token, topic = msg->topic, condition = msg->condition;
+    msg->token.clear();
+    msg->topic.clear();
+    msg->condition.clear();
+    fcm_prepareV1Payload(msg);
+    msg->token = token;
+    msg->topic = topic;
+    msg->condition = condition;
+
+    MB_String head, tail;
+    int p = raw.find('{', 1);
+    if (p != (int)MB_String::npos)
+    {
+        head = raw.substr(0, p + 1);
+        tail = raw.substr(p + 1);
+    }
+    else
+    {
+        // the message has no field
+        head += '{';
+        head += '"';
+        head += firebase_fcm_pgm_str_68; // "message"
+        head += '"';
+        head += ':';
+        head += '{';
+        tail += '}';
+        tail += '}';
+    }
+    raw.clear();
+
+    fcm_connect(fbdo, firebase_fcm_msg_mode_httpv1);
+    fbdo->session.con_mode = firebase_con_mode_fcm;
+    // the same as fcm_send
+    fbdo->tcpClient.setCACert(nullptr);
+
+    MB_String header, request;
+    fcm_prepareV1Header(header);
+
+    size_t sent = 0, done = 0, failed = 0;
+    bool sendFailed = false;
+
+    while (done < numTargets)
+    {
+        // keep the requests in flight up to the pipeline size
+        while (!sendFailed && sent < numTargets && sent - done < pipeline)
+        {
+            fcm_prepareV1Request(request, header, head, tail, targets[sent]);
+            sendFailed = fbdo->tcpSend(request.c_str()) != (int)request.length();
+            request.clear();
+
+            if (sendFailed)
+            {
+                if (fbdo->session.response.code > 0)
+                    fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_SEND_REQUEST_FAILED;
+                break;
+            }
+
+            sent++;
+        }
+
+        // the request can't be sent
+        if (sent == done)
+            break;
+
+        bool keepAlive = true;
+        fbdo->session.fcm.payload.clear();
+        fbdo->session.response.code = FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+
+        bool ok = handleResponse(fbdo, pipeline > 1, &keepAlive);
+        int code = fbdo->session.response.code;
+
+        if (!ok || code < 0)
+            failed++;
+
+        if (results)
+            fcm_getV1Result(fbdo, &results[done]);
+
+        done++;
+
+        if (code < 0)
+        {
+            // the requests in flight may be processed, they are not sent again
+            for (; done < sent; done++)
+            {
+                failed++;
+                if (results)
+                    results[done].code = code;
+            }
+        }
+
+        // the server does not read the requests after the closed connection response, send them again
+        if (done < numTargets &&
+            (code < 0 || !keepAlive || (sendFailed && done == sent) || !fbdo->tcpClient.connected()))
+        {
+            sent = done;
+            sendFailed = false;
+            fbdo->closeSession();
+            if (!fbdo->reconnect())
+                break;
+
+            // the access token may be refreshed
+            fcm_connect(fbdo, firebase_fcm_msg_mode_httpv1);
+            header.clear();
+            fcm_prepareV1Header(header);
+        }
+
+        FBUtils::idle();
+    }
+
+    // the targets that were not sent
+    failed += numTargets - done;
+
+    fbdo->session.fcm.payload.clear();
+    Core.internal.fb_processing = false;
+
+    if (failed > 0)
+        fbdo->closeSession();
+
+    return failed == 0;
+}
+
 bool FB_CM::mSubscribeTopic(FirebaseData *fbdo, MB_StringPtr topic, const char *IID[], size_t numToken)
 {
 
@@ -372,6 +524,67 @@ void FB_CM::fcm_prepareLegacyPayload(FCM_Legacy_HTTP_Message *msg)
     json.toString(raw);
 }
 
+void FB_CM::fcm_prepareV1Header(MB_String &header)
+{
+    Core.hh.addRequestHeaderFirst(header, http_post);
+    Core.uh.addGAPIv1Path(header);
+    header += Core.config->service_account.data.project_id;
+    header += firebase_fcm_pgm_str_4; // "/messages:send"
+    Core.hh.addRequestHeaderLast(header);
+
+    Core.hh.addGAPIsHostHeader(header, firebase_fcm_pgm_str_1 /* "fcm" */);
+    Core.hh.addAuthHeaderFirst(header, token_type_oauth2_access_token);
+    header += Core.getToken();
+    Core.hh.addNewLine(header);
+    Core.hh.addUAHeader(header);
+    Core.hh.addContentTypeHeader(header, firebase_pgm_str_62 /* "application/json" */);
+    Core.hh.addConnectionHeader(header, true);
+}
+
+void FB_CM::fcm_prepareV1Request(MB_String &request, const MB_String &header, const MB_String &head,
+                                 const MB_String &tail, const char *target)
+{
+    bool isTopic = strncmp(target, pgm2Str(firebase_fcm_pgm_str_36 /* "/topics/" */), strlen_P(firebase_fcm_pgm_str_36)) == 0;
+
+    MB_String body = head;
+    body += '"';
+    body += isTopic ? firebase_fcm_pgm_str_41 /* "topic" */ : firebase_pgm_str_18 /* "token" */;
+    body += '"';
+    body += ':';
+    body += '"';
+    body += isTopic ? target + strlen_P(firebase_fcm_pgm_str_36) : target;
+    body += '"';
+    if (tail[0] != '}')
+        body += ',';
+    body += tail;
+
+    request = header;
+    Core.hh.addContentLengthHeader(request, body.length());
+    Core.hh.addNewLine(request);
+    request += body;
+}
+
+void FB_CM::fcm_getV1Result(FirebaseData *fbdo, FCM_HTTPv1_Result *result)
+{
+    result->code = fbdo->session.response.code;
+    result->name.clear();
+    result->error.clear();
+
+    if (fbdo->session.fcm.payload.length() == 0 || fbdo->session.fcm.payload[0] != '{')
+        return;
+
+    fbdo->initJson();
+    Core.jh.setData(fbdo->session.jsonPtr, fbdo->session.fcm.payload, false);
+
+    if (Core.jh.parse(fbdo->session.jsonPtr, fbdo->session.dataPtr, firebase_pgm_str_66 /* "name" */))
+        result->name = fbdo->session.dataPtr->to<const char *>();
+    else if (Core.jh.parse(fbdo->session.jsonPtr, fbdo->session.dataPtr, firebase_fcm_pgm_str_73 /* "error/details/[0]/errorCode" */) ||
+             Core.jh.parse(fbdo->session.jsonPtr, fbdo->session.dataPtr, firebase_fcm_pgm_str_72 /* "error/status" */))
+        result->error = fbdo->session.dataPtr->to<const char *>();
+
+    fbdo->clearJson();
+}
+
 void FB_CM::fcm_preparSubscriptionPayload(const char *topic, const char *IID[], size_t numToken)
 {
     MB_String s;
@@ -852,7 +1065,7 @@ bool FB_CM::fcm_send(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char
     {
         // Core.getTokenType() is required as Core.config is not set in fcm legacy
         if (Core.getTokenType() != token_type_undefined)
-            if (!Core.tokenReady())
+            if (!Core.tokenReady(true))
             {
                 Core.internal.fb_processing = false;
                 return false;
@@ -893,7 +1106,7 @@ bool FB_CM::waitResponse(FirebaseData *fbdo)
     return handleResponse(fbdo);
 }
 
-bool FB_CM::handleResponse(FirebaseData *fbdo)
+bool FB_CM::handleResponse(FirebaseData *fbdo, bool pipelined, bool *keepAlive)
 {
     if (!fbdo->reconnect())
         return false;
@@ -915,6 +1128,15 @@ bool FB_CM::handleResponse(FirebaseData *fbdo)
         if (!fbdo->readResponse(&fbdo->session.fcm.payload, tcpHandler, response) && !response.isChunkedEnc)
             break;
 
+        // the next response follows, stop at the end of this response without flushing
+        if (pipelined)
+        {
+            if (response.isChunkedEnc ? tcpHandler.bufferAvailable < 0
+                                      : tcpHandler.headerEnded && tcpHandler.payloadRead >= response.contentLen)
+                break;
+            continue;
+        }
+
         // Last chunk?
         if (Core.ut.isChunkComplete(&tcpHandler, &response, complete))
             break;
@@ -922,9 +1144,12 @@ bool FB_CM::handleResponse(FirebaseData *fbdo)
 
     // To make sure all chunks read and
     // ready to send next request
-    if (response.isChunkedEnc)
+    if (response.isChunkedEnc && !pipelined)
         fbdo->tcpClient.flush();
 
+    if (keepAlive)
+        *keepAlive = !Core.sh.compare(response.connection, 0, firebase_fcm_pgm_str_74 /* "close" */, true);
+
     // parse the payload for error
     fbdo->getError(fbdo->session.fcm.payload, tcpHandler, response, false);
 
@@ -948,33 +1173,43 @@ void FB_CM::rescon(FirebaseData *fbdo, const char *host)
     fbdo->session.con_mode = firebase_con_mode_fcm;
 }
 
-bool FB_CM::handleFCMRequest(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *payload)
+int FB_CM::beginRequest(FirebaseData *fbdo)
 {
-    fbdo->tcpClient.setSPIEthernet(_spi_ethernet_module);
-
     fbdo->session.http_code = 0;
 
     if (!fbdo->reconnect())
-        return false;
+        return -1;
 
     if (!Core.waitIdle(fbdo->session.response.code))
-        return false;
+        return -1;
 
 #if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
     if (fbdo->session.rtdb.pause)
-        return true;
+        return 0;
 #endif
     if (fbdo->session.long_running_task > 0)
     {
         fbdo->session.response.code = FIREBASE_ERROR_LONG_RUNNING_TASK;
-        return false;
+        return -1;
     }
 
     if (Core.internal.fb_processing)
-        return false;
+        return -1;
 
     Core.internal.fb_processing = true;
 
+    return 1;
+}
+
+bool FB_CM::handleFCMRequest(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *payload)
+{
+    fbdo->tcpClient.setSPIEthernet(_spi_ethernet_module);
+
+    // 0 when the session was paused
+    int ret = beginRequest(fbdo);
+    if (ret < 1)
+        return ret == 0;
+
     fcm_connect(fbdo, mode);
 
     fbdo->session.con_mode = firebase_con_mode_fcm;
@@ -145,6 +145,24 @@ public:
    */
   bool send(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg);
 
+  /** Send the same Firebase Cloud Messaging message to many devices or topics using the FCM HTTP v1 API.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param msg The pointer to the message template which is the FCM_HTTPv1_JSON_Message type data,
+   * its token, topic and condition are replaced by each target.
+   * @param targets The registration tokens or topics array, the topic starts with "/topics/".
+   * @param numTargets The size of targets array.
+   * @param results Optional. The FCM_HTTPv1_Result array of numTargets items for the result of each target.
+   * @param pipeline Optional. The number of requests (1 - 8) that were sent before their responses were read.
+   * @return Boolean type status indicates all messages were sent.
+   *
+   * @note The message is built once and the requests are sent through the same keep-alive connection.
+   * The result code is the HTTP status code or the negative TCP error code, and 0 for the message that was not sent.
+   * The message that its response was lost is not sent again.
+   */
+  bool sendAll(FirebaseData *fbdo, FCM_HTTPv1_JSON_Message *msg, const char *targets[], size_t numTargets,
+               FCM_HTTPv1_Result *results = nullptr, uint8_t pipeline = 1);
+
   /** Subscribe the devices to the topic.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -210,14 +228,19 @@ public:
 
 private:
   bool handleFCMRequest(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *payload);
+  int beginRequest(FirebaseData *fbdo);
   bool waitResponse(FirebaseData *fbdo);
-  bool handleResponse(FirebaseData *fbdo);
+  bool handleResponse(FirebaseData *fbdo, bool pipelined = false, bool *keepAlive = nullptr);
   void rescon(FirebaseData *fbdo, const char *host);
   void fcm_connect(FirebaseData *fbdo, firebase_fcm_msg_mode mode);
   bool fcm_send(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *msg);
   bool sendHeader(FirebaseData *fbdo, firebase_fcm_msg_mode mode, const char *payload);
   void fcm_prepareLegacyPayload(FCM_Legacy_HTTP_Message *msg);
   void fcm_prepareV1Payload(FCM_HTTPv1_JSON_Message *msg);
+  void fcm_prepareV1Header(MB_String &header);
+  void fcm_prepareV1Request(MB_String &request, const MB_String &header, const MB_String &head,
+                            const MB_String &tail, const char *target);
+  void fcm_getV1Result(FirebaseData *fbdo, FCM_HTTPv1_Result *result);
   void fcm_preparSubscriptionPayload(const char *topic, const char *IID[], size_t numToken);
   void fcm_preparAPNsRegistPayload(const char *application, bool sandbox, const char *APNs[], size_t numToken);
 
@@ -232,6 +255,8 @@ private:
   MB_String server_key;
   MB_String raw;
   uint16_t port = FIREBASE_PORT;
+  // the maximum requests that were sent before their responses were read
+  const uint8_t fcm_max_pipeline = 8;
   SPI_ETH_Module *_spi_ethernet_module = NULL;
 };
 
@@ -792,6 +792,8 @@ void FB_RTDB::removeMultiPathStreamCallback(FirebaseData *fbdo)
 
     fbdo->_multiPathDataCallback = NULL;
     fbdo->_timeoutCallback = NULL;
+    fbdo->session.rtdb.stream_queue.events.clear();
+    clearMultiPathStreamChildren(fbdo);
     fbdo->setSession(true, false);
 
 #if defined(ESP32)
@@ -880,6 +882,8 @@ void FB_RTDB::mRunStream()
 
                 readStream(fbdo);
 
+                dispatchStreamQueue(fbdo);
+
                 if (fbdo->streamTimeout() && fbdo->_timeoutCallback)
                     fbdo->sendStreamToCB(fbdo->session.response.code);
             }
@@ -887,11 +891,411 @@ void FB_RTDB::mRunStream()
     }
 }
 
+void FB_RTDB::setStreamQueue(FirebaseData *fbdo, uint8_t size, firebase_stream_coalesce_mode mode, uint8_t dispatchCount)
+{
+    firebase_stream_queue_info_t &queue = fbdo->session.rtdb.stream_queue;
+    queue.max_size = size;
+    queue.mode = mode;
+    queue.dispatch_count = dispatchCount > 0 ? dispatchCount : 1;
+
+    while (queue.events.size() > size)
+        queue.events.erase(queue.events.begin());
+}
+
+uint32_t FB_RTDB::getStreamQueueDropped(FirebaseData *fbdo)
+{
+    return fbdo->session.rtdb.stream_queue.dropped;
+}
+
+uint32_t FB_RTDB::getStreamQueueCoalesced(FirebaseData *fbdo)
+{
+    return fbdo->session.rtdb.stream_queue.coalesced;
+}
+
+void FB_RTDB::setResponseCache(FirebaseData *fbdo, uint8_t maxEntries, size_t maxBytes,
+                               firebase_mem_storage_type storageType)
+{
+    firebase_rtdb_cache_info_t &cache = fbdo->session.rtdb.cache;
+
+    if (maxEntries == 0 || storageType != cache.storage_type)
+        clearResponseCache(fbdo);
+
+    cache.max_entries = maxEntries;
+    cache.max_bytes = maxBytes;
+    cache.storage_type = storageType;
+
+    while (cache.entries.size() > 0 && (cache.entries.size() > maxEntries || cache.bytes > maxBytes))
+        removeCacheEntry(fbdo, 0);
+}
+
+uint32_t FB_RTDB::getResponseCacheHits(FirebaseData *fbdo)
+{
+    return fbdo->session.rtdb.cache.hits;
+}
+
+uint32_t FB_RTDB::getResponseCacheMisses(FirebaseData *fbdo)
+{
+    return fbdo->session.rtdb.cache.misses;
+}
+
+uint32_t FB_RTDB::getResponseCacheSavedBytes(FirebaseData *fbdo)
+{
+    return fbdo->session.rtdb.cache.saved_bytes;
+}
+
 void FB_RTDB::setMaxRetry(FirebaseData *fbdo, uint8_t num)
 {
     fbdo->session.rtdb.max_retry = num;
 }
 
+void FB_RTDB::beginBatch(FirebaseData *fbdo, RTDBBatch *batch)
+{
+    if (!batch)
+        return;
+
+    batch->_rtdb = this;
+    batch->_fbdo = fbdo;
+}
+
+bool FB_RTDB::mFlushBatch(FirebaseData *fbdo, RTDBBatch *batch)
+{
+    if (batch->_paths.size() == 0)
+        return true;
+
+    MB_String payload, path = firebase_pgm_str_1; // "/"
+    batch->getPayload(payload);
+
+    bool ret = buildRequest(fbdo, rtdb_update_nocontent, toStringPtr(path), toStringPtr(payload),
+                            d_json, _NO_SUB_TYPE, _NO_REF, _NO_QUERY, _NO_PRIORITY, toStringPtr(_NO_ETAG),
+                            _NO_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
+
+    payload.clear();
+
+    // the multi-location update is atomic, all paths in the batch share the same result
+    if (batch->_resultCallback)
+    {
+        RTDB_BatchResultInfo info;
+        info.success = ret;
+        info.httpCode = fbdo->session.response.code;
+        if (!ret)
+            info.errorMsg = fbdo->errorReason().c_str();
+
+        for (size_t i = 0; i < batch->_paths.size(); i++)
+        {
+            info.path = batch->_paths[i];
+            batch->_resultCallback(info);
+        }
+    }
+
+    // keep the writes that were not reached the server for the next flush
+    if (ret || fbdo->session.response.code > 0)
+        batch->clear();
+    else
+        batch->_firstMs = millis();
+
+    return ret;
+}
+
+void FB_RTDB::beginAsync(RTDBAsyncPool *pool)
+{
+    if (pool)
+        pool->_rtdb = this;
+}
+
+firebase_rtdb_async_status FB_RTDB::mSendAsync(FirebaseData *fbdo, struct firebase_rtdb_async_request_t *item,
+                                               RTDB_AsyncResultInfo &info, bool pipelined)
+{
+    // keep the request in the queue until the token and network are ready
+    if (!Core.config || !fbdo->tokenReady() || !fbdo->reconnect())
+        return firebase_rtdb_async_status_queued;
+
+    // the new session can't be created until the responses of the sent requests were read
+    if (pipelined && (!fbdo->tcpClient.connected() ||
+                      isNewSessionRequired(fbdo, Core.config->database_url.c_str(), &item->req)))
+        return firebase_rtdb_async_status_queued;
+
+    // the new session connects and does the TLS handshake here, the loop is blocked until it was done
+    if (handleRequest(fbdo, &item->req))
+        return firebase_rtdb_async_status_sent;
+
+    fbdo->closeSession();
+    setAsyncResult(fbdo, item, info, false);
+
+    return firebase_rtdb_async_status_error;
+}
+
+bool FB_RTDB::mCompleteAsync(FirebaseData *fbdo, struct firebase_rtdb_async_request_t *item, RTDB_AsyncResultInfo &info,
+                             bool &keepAlive)
+{
+    bool available = fbdo->tcpClient.available() > 0;
+
+    if (!available && fbdo->tcpClient.connected() && millis() - item->sentMillis < Core.config->timeout.serverResponse)
+        return false;
+
+    bool ret = false;
+
+    if (available)
+    {
+        // the session was set for the last sent request, restore it for the pipelined response
+        fbdo->session.rtdb.path = item->req.path;
+        fbdo->session.rtdb.req_method = item->req.method;
+        fbdo->session.rtdb.req_data_type = item->req.data.type;
+        fbdo->session.rtdb.data_mismatch = false;
+        fbdo->session.rtdb.resp_etag.clear();
+        // the entries may be replaced by the responses of the requests that were pipelined ahead
+        matchCachedRequest(fbdo, &item->req);
+
+        // the whole response is read once its first bytes were available
+        ret = waitResponse(fbdo, &item->req);
+    }
+    else
+        fbdo->session.response.code = fbdo->tcpClient.connected() ? FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT
+                                                                  : FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+
+    // the 304 response of the request to send again was read completely, the connection is still usable
+    bool resend = available && item->req.resend;
+
+    if (!ret && !resend)
+        fbdo->closeSession();
+
+    // the chunked payload reading flushes the remaining data of the next responses
+    keepAlive = (ret || resend) && fbdo->tcpClient.connected() && !fbdo->session.chunked_encoding &&
+                fbdo->session.rtdb.http_resp_conn_type != firebase_http_connection_type_close;
+
+    setAsyncResult(fbdo, item, info, ret);
+
+    return true;
+}
+
+void FB_RTDB::mAbortAsync(FirebaseData *fbdo)
+{
+    fbdo->closeSession();
+}
+
+void FB_RTDB::setAsyncResult(FirebaseData *fbdo, struct firebase_rtdb_async_request_t *item, RTDB_AsyncResultInfo &info,
+                             bool ret)
+{
+    info.status = ret ? firebase_rtdb_async_status_complete : firebase_rtdb_async_status_error;
+    info.httpCode = fbdo->session.response.code;
+
+    if (ret)
+    {
+        fbdo->session.rtdb.data_available = fbdo->session.rtdb.raw.length() > 0;
+        info.dataType = fbdo->session.rtdb.resp_data_type;
+        info.data = item->req.method == http_post ? fbdo->session.rtdb.push_name : fbdo->session.rtdb.raw;
+    }
+    else
+        info.errorMsg = fbdo->errorReason().c_str();
+}
+
+bool FB_RTDB::isCacheableRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
+{
+    QueryFilter *query = req->data.address.query > 0 ? addrTo<QueryFilter *>(req->data.address.query) : nullptr;
+
+    // the server does not send ETag for the query
+    return fbdo->session.rtdb.cache.max_entries > 0 && req->method == http_get && !req->async &&
+           req->data.type != d_blob && req->data.type != d_file && req->data.type != d_file_ota &&
+           req->filename.length() == 0 && (!query || query->_orderBy.length() == 0);
+}
+
+void FB_RTDB::prepareCachedRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
+{
+    firebase_rtdb_cache_info_t &cache = fbdo->session.rtdb.cache;
+    cache.revalidate = -1;
+
+    if (!isCacheableRequest(fbdo, req))
+        return;
+
+    for (size_t i = 0; i < cache.entries.size(); i++)
+    {
+        if (strcmp(cache.entries[i].path.c_str(), req->path.c_str()) == 0)
+        {
+            cache.revalidate = i;
+            break;
+        }
+    }
+}
+
+void FB_RTDB::matchCachedRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
+{
+    firebase_rtdb_cache_info_t &cache = fbdo->session.rtdb.cache;
+    cache.revalidate = -1;
+
+    if (req->revalidate_etag.length() == 0)
+        return;
+
+    // the entry that was revalidated when the request was sent
+    for (size_t i = 0; i < cache.entries.size(); i++)
+    {
+        if (strcmp(cache.entries[i].path.c_str(), req->path.c_str()) == 0 &&
+            strcmp(cache.entries[i].etag.c_str(), req->revalidate_etag.c_str()) == 0)
+        {
+            cache.revalidate = i;
+            break;
+        }
+    }
+}
+
+bool FB_RTDB::readCachedResponse(FirebaseData *fbdo, struct server_response_data_t &response, MB_String &payload)
+{
+    firebase_rtdb_cache_info_t &cache = fbdo->session.rtdb.cache;
+
+    if (cache.revalidate < 0 || cache.revalidate >= (int)cache.entries.size())
+        return false;
+
+    size_t index = cache.revalidate;
+    cache.revalidate = -1;
+
+    if (cache.storage_type == mem_storage_type_undefined)
+        payload = cache.entries[index].payload;
+    else
+    {
+        MB_String filename;
+        cacheFileName(filename, cache.entries[index].file_id);
+
+        int size = Core.mbfs.open(filename, mbfs_type cache.storage_type, mb_fs_open_mode_read);
+        bool ret = size == (int)cache.entries[index].size;
+
+        if (ret)
+        {
+            char *buf = reinterpret_cast<char *>(Core.mbfs.newP(size + 1));
+            ret = Core.mbfs.read(mbfs_type cache.storage_type, reinterpret_cast<uint8_t *>(buf), size) == size;
+            if (ret)
+                payload = buf;
+            Core.mbfs.delP(&buf);
+        }
+
+        if (size >= 0)
+            Core.mbfs.close(mbfs_type cache.storage_type);
+
+        // the entry is removed and downloaded again with the request without If-None-Match
+        if (!ret)
+        {
+            removeCacheEntry(fbdo, index);
+            return false;
+        }
+    }
+
+    response.httpCode = FIREBASE_ERROR_HTTP_CODE_OK;
+    response.dataType = cache.entries[index].data_type;
+    response.payloadLen = cache.entries[index].size;
+    response.noContent = false;
+    fbdo->session.rtdb.resp_etag = cache.entries[index].etag;
+    fbdo->session.response.code = FIREBASE_ERROR_HTTP_CODE_OK;
+
+    cache.hits++;
+    cache.saved_bytes += cache.entries[index].size;
+
+    // the most recently used entry is the last
+    if (index + 1 < cache.entries.size())
+    {
+        firebase_rtdb_cache_entry_t entry = cache.entries[index];
+        cache.entries.erase(cache.entries.begin() + index);
+        cache.entries.push_back(entry);
+    }
+
+    return true;
+}
+
+void FB_RTDB::storeCachedResponse(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req,
+                                  struct server_response_data_t &response, const MB_String &payload)
+{
+    firebase_rtdb_cache_info_t &cache = fbdo->session.rtdb.cache;
+
+    cache.revalidate = -1;
+
+    if (response.isEvent || fbdo->session.response.code != FIREBASE_ERROR_HTTP_CODE_OK ||
+        !isCacheableRequest(fbdo, req))
+        return;
+
+    cache.misses++;
+
+    // the outdated entry, it may be the one stored by the pipelined request ahead
+    for (size_t i = cache.entries.size(); i-- > 0;)
+    {
+        if (strcmp(cache.entries[i].path.c_str(), req->path.c_str()) == 0)
+            removeCacheEntry(fbdo, i);
+    }
+
+    if (response.etag.length() == 0 || payload.length() == 0 || payload.length() > cache.max_bytes ||
+        response.dataType == d_blob || response.dataType == d_file || response.dataType == d_file_ota)
+        return;
+
+    while (cache.entries.size() > 0 &&
+           (cache.entries.size() >= cache.max_entries || cache.bytes + payload.length() > cache.max_bytes))
+        removeCacheEntry(fbdo, 0);
+
+    firebase_rtdb_cache_entry_t entry;
+    entry.path = req->path;
+    entry.etag = response.etag;
+    entry.data_type = response.dataType;
+    entry.size = payload.length();
+
+    if (cache.storage_type == mem_storage_type_undefined)
+        entry.payload = payload;
+    else
+    {
+        // the file id that is not used by other entries
+        bool used = true;
+        while (used)
+        {
+            entry.file_id = cache.next_file_id++;
+            used = false;
+            for (size_t i = 0; i < cache.entries.size() && !used; i++)
+                used = cache.entries[i].file_id == entry.file_id;
+        }
+
+        MB_String filename;
+        cacheFileName(filename, entry.file_id);
+
+        if (Core.mbfs.open(filename, mbfs_type cache.storage_type, mb_fs_open_mode_write) < 0)
+            return;
+
+        bool ret = Core.mbfs.write(mbfs_type cache.storage_type, (uint8_t *)payload.c_str(),
+                                   payload.length()) == (int)payload.length();
+        Core.mbfs.close(mbfs_type cache.storage_type);
+
+        if (!ret)
+        {
+            Core.mbfs.remove(filename, mbfs_type cache.storage_type);
+            return;
+        }
+    }
+
+    cache.bytes += entry.size;
+    cache.entries.push_back(entry);
+}
+
+void FB_RTDB::removeCacheEntry(FirebaseData *fbdo, size_t index)
+{
+    firebase_rtdb_cache_info_t &cache = fbdo->session.rtdb.cache;
+
+    if (cache.storage_type != mem_storage_type_undefined)
+    {
+        MB_String filename;
+        cacheFileName(filename, cache.entries[index].file_id);
+        Core.mbfs.remove(filename, mbfs_type cache.storage_type);
+    }
+
+    cache.bytes -= cache.entries[index].size;
+    cache.entries.erase(cache.entries.begin() + index);
+}
+
+void FB_RTDB::clearResponseCache(FirebaseData *fbdo)
+{
+    while (fbdo->session.rtdb.cache.entries.size() > 0)
+        removeCacheEntry(fbdo, 0);
+
+    fbdo->session.rtdb.cache.revalidate = -1;
+}
+
+void FB_RTDB::cacheFileName(MB_String &filename, uint16_t id)
+{
+    filename = firebase_rtdb_pgm_str_43; // "/fb_rc_"
+    filename += id;
+    filename += firebase_rtdb_pgm_str_44; // ".tmp"
+}
+
 void FB_RTDB::setBlobRef(FirebaseData *fbdo, int addr)
 {
     if (fbdo->session.rtdb.blob && fbdo->session.rtdb.isBlobPtr)
@@ -1140,12 +1544,173 @@ void FB_RTDB::setMaxErrorQueue(FirebaseData *fbdo, uint8_t num)
     }
 }
 
-bool FB_RTDB::mSaveErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType)
+static uint16_t fb_queue_crc(uint16_t crc, const uint8_t *buf, size_t len)
 {
+    // CRC-16/CCITT
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)buf[i] << 8;
+        for (uint8_t b = 0; b < 8; b++)
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
 
+static void fb_queue_put(uint8_t *buf, size_t &pos, uint32_t v, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+        buf[pos++] = (v >> (8 * i)) & 0xff;
+}
+
+static uint32_t fb_queue_get(const uint8_t *buf, size_t &pos, uint8_t len)
+{
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < len; i++)
+        v |= (uint32_t)buf[pos++] << (8 * i);
+    return v;
+}
+
+static void fb_queue_put_str(uint8_t *buf, size_t &pos, const MB_String &str)
+{
+    fb_queue_put(buf, pos, str.length(), 4);
+    memcpy(buf + pos, str.c_str(), str.length());
+    pos += str.length();
+}
+
+static bool fb_queue_get_str(const uint8_t *buf, size_t &pos, size_t end, MB_String &str)
+{
+    if (pos + 4 > end)
+        return false;
+    size_t len = fb_queue_get(buf, pos, 4);
+    if (len > end - pos)
+        return false;
+    str.clear();
+    str.append(reinterpret_cast<const char *>(buf + pos), len);
+    pos += len;
+    return true;
+}
+
+static bool fb_queue_has_id(const MB_VECTOR<uint32_t> &ids, uint32_t id)
+{
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        if (ids[i] == id)
+            return true;
+    }
+    return false;
+}
+
+/* The error queue file is a 12 bytes header (magic, length of the compacted part and its item count, CRC)
+ * followed by the records of kind (1), payload length (4), payload and CRC (2).
+ * The item payload starts with its queue ID, the tombstone payload is the queue ID of the removed item.
+ * Saving appends the changes only, the whole file is rewritten when the garbage or the appended records
+ * grow beyond the limits. The rewritten file is written to "<filename>.tmp" and renamed to replace the
+ * queue file, the temp file is read instead when the queue file is missing or invalid.
+ */
+bool FB_RTDB::mSaveErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType)
+{
     MB_String _filename = filename;
 
-    int ret = Core.mbfs.open(_filename, mbfs_type storageType, mb_fs_open_mode_write);
+    // the live queue IDs in file
+    MB_VECTOR<uint32_t> ids;
+    uint32_t records = 0, appended = 0;
+    bool valid = false;
+
+    int size = Core.mbfs.open(_filename, mbfs_type storageType, mb_fs_open_mode_read);
+
+    if (size >= FIREBASE_ERROR_QUEUE_HEADER_SIZE)
+    {
+        uint32_t baseLen = 0;
+        uint16_t count = 0;
+
+        if (readQueueHeader(storageType, baseLen, count) && baseLen <= (uint32_t)size)
+        {
+            uint32_t pos = FIREBASE_ERROR_QUEUE_HEADER_SIZE;
+            uint8_t kind = 0;
+            QueueItem item;
+
+            while (true)
+            {
+                uint32_t start = pos;
+                if (!readQueueRecord(storageType, pos, size, kind, item, false))
+                    break;
+
+                FBUtils::idle();
+                records++;
+
+                if (start >= baseLen)
+                    appended++;
+
+                if (kind == FIREBASE_ERROR_QUEUE_RECORD_ITEM)
+                    ids.push_back(item.qID);
+                else
+                {
+                    for (size_t i = 0; i < ids.size(); i++)
+                    {
+                        if (ids[i] == item.qID)
+                        {
+                            ids.erase(ids.begin() + i);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // a torn record at the end from an interrupted write needs the rewrite
+            valid = pos == (uint32_t)size;
+        }
+    }
+
+    if (size >= 0)
+        Core.mbfs.close(mbfs_type storageType);
+
+    size_t total = fbdo->_qMan.size();
+    MB_VECTOR<uint32_t> queued;
+    uint32_t added = 0, removed = 0;
+
+    for (size_t i = 0; i < total && fbdo->_qMan._queueCollection; i++)
+    {
+        uint32_t id = fbdo->_qMan._queueCollection->at(i).qID;
+        queued.push_back(id);
+        if (!fb_queue_has_id(ids, id))
+            added++;
+    }
+
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        if (!fb_queue_has_id(queued, ids[i]))
+            removed++;
+    }
+
+    if (valid && added == 0 && removed == 0)
+        return true;
+
+    bool compact = !valid || records + added + removed - total > total ||
+                   appended + added + removed > FIREBASE_ERROR_QUEUE_MAX_APPENDED;
+
+    if (compact)
+    {
+        MB_String tmpName = _filename;
+        tmpName += ".tmp";
+
+        // the queue file is replaced only after the new file was completely written
+        if (!writeCompactedQueue(fbdo, tmpName, storageType))
+        {
+            Core.mbfs.remove(tmpName, mbfs_type storageType);
+            return false;
+        }
+
+        if (Core.mbfs.rename(tmpName, _filename, mbfs_type storageType))
+            return true;
+
+        // the filesystem that cannot rename, rewrite the queue file in place
+        bool success = writeCompactedQueue(fbdo, _filename, storageType);
+        if (success)
+            Core.mbfs.remove(tmpName, mbfs_type storageType);
+        return success;
+    }
+
+    int ret = Core.mbfs.open(_filename, mbfs_type storageType, mb_fs_open_mode_append);
 
     if (ret < 0)
     {
@@ -1153,35 +1718,50 @@ bool FB_RTDB::mSaveErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebas
         return false;
     }
 
-    // Close file and open later.
-    Core.mbfs.close(mbfs_type storageType);
+    bool success = true;
+    QueueItem tombstone;
 
-    if ((storageType == mem_storage_type_flash || storageType == mem_storage_type_sd) &&
-        !Core.mbfs.ready(mbfs_type storageType))
-        return false;
+    for (size_t i = 0; i < ids.size() && success; i++)
+    {
+        if (!fb_queue_has_id(queued, ids[i]))
+        {
+            tombstone.qID = ids[i];
+            success = writeQueueRecord(storageType, FIREBASE_ERROR_QUEUE_RECORD_TOMBSTONE, tombstone);
+        }
+    }
 
-    FirebaseJsonArray arr;
+    for (size_t i = 0; i < total && success; i++)
+    {
+        if (!fb_queue_has_id(ids, queued[i]))
+            success = writeQueueRecord(storageType, FIREBASE_ERROR_QUEUE_RECORD_ITEM, fbdo->_qMan._queueCollection->at(i));
+    }
 
-    // required for ESP32 core 2.0.x
-    Core.mbfs.open(_filename, mbfs_type storageType, mb_fs_open_mode_write);
+    Core.mbfs.close(mbfs_type storageType);
+    return success;
+}
 
-    for (uint8_t i = 0; i < fbdo->_qMan.size(); i++)
-    {
-        if (!fbdo->_qMan._queueCollection)
-            continue;
+bool FB_RTDB::writeCompactedQueue(FirebaseData *fbdo, const MB_String &filename, firebase_mem_storage_type storageType)
+{
+    int ret = Core.mbfs.open(filename, mbfs_type storageType, mb_fs_open_mode_write);
 
-        QueueItem item = fbdo->_qMan._queueCollection->at(i);
-        arr.clear();
-        arr.add((uint8_t)item.dataType, (uint8_t)item.subType, (uint8_t)item.method,
-                (uint8_t)item.storageType, (uint8_t)item.async);
-        arr.add(item.address.din, item.address.dout, item.address.query,
-                item.address.priority, item.blobSize);
-        arr.add(item.path, item.payload, item.etag, item.filename);
-        Core.mbfs.write(mbfs_type storageType, (uint8_t *)arr.raw(), strlen(arr.raw()));
+    if (ret < 0)
+    {
+        fbdo->session.response.code = ret;
+        return false;
     }
 
+    size_t total = fbdo->_qMan._queueCollection ? fbdo->_qMan.size() : 0;
+    uint32_t baseLen = FIREBASE_ERROR_QUEUE_HEADER_SIZE;
+    for (size_t i = 0; i < total; i++)
+        baseLen += queueRecordSize(FIREBASE_ERROR_QUEUE_RECORD_ITEM, fbdo->_qMan._queueCollection->at(i));
+
+    bool success = writeQueueHeader(storageType, baseLen, total);
+
+    for (size_t i = 0; i < total && success; i++)
+        success = writeQueueRecord(storageType, FIREBASE_ERROR_QUEUE_RECORD_ITEM, fbdo->_qMan._queueCollection->at(i));
+
     Core.mbfs.close(mbfs_type storageType);
-    return true;
+    return success;
 }
 
 bool FB_RTDB::mRestoreErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType)
@@ -1202,230 +1782,245 @@ bool FB_RTDB::mDeleteStorageFile(MB_StringPtr filename, firebase_mem_storage_typ
 uint8_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, MB_StringPtr filename,
                                 firebase_mem_storage_type storageType, uint8_t mode)
 {
-    uint8_t count = 0;
     MB_String _filename = filename;
+    MB_String tmpName = _filename;
+    tmpName += ".tmp";
 
-    int ret = Core.mbfs.open(_filename, mbfs_type storageType, mb_fs_open_mode_read);
+    int size = -1;
+    uint32_t baseLen = 0;
+    uint16_t baseCount = 0;
+    bool valid = false;
 
-    if (ret < 0)
+    // the temp file of the interrupted compaction when the queue file is missing or invalid
+    for (uint8_t i = 0; i < 2 && !valid; i++)
     {
-        fbdo->session.response.code = ret;
-        return 0;
+        if (i > 0 && !Core.mbfs.existed(tmpName, mbfs_type storageType))
+            break;
+
+        size = Core.mbfs.open(i == 0 ? _filename : tmpName, mbfs_type storageType, mb_fs_open_mode_read);
+
+        if (size < 0)
+            continue;
+
+        valid = size >= FIREBASE_ERROR_QUEUE_HEADER_SIZE && readQueueHeader(storageType, baseLen, baseCount) &&
+                baseLen <= (uint32_t)size;
+
+        if (!valid)
+            Core.mbfs.close(mbfs_type storageType);
     }
 
-    if (!Core.mbfs.available(mbfs_type storageType) || Core.mbfs.size(mbfs_type storageType) < 4)
+    if (!valid)
     {
-        Core.mbfs.close(mbfs_type storageType);
+        if (size < 0)
+            fbdo->session.response.code = size;
         return 0;
     }
 
+    int count = 0;
+    uint8_t kind = 0;
     QueueItem item;
 
-#if defined(MBFS_ESP32_SDFAT_ENABLED)
-
-    if (storageType == mem_storage_type_flash)
+    if (mode == 0)
     {
-#if defined(MBFS_FLASH_FS)
-        fs::File file = Core.mbfs.getFlashFile();
-        count = readQueueFile(fbdo, file, item, mode);
-#endif
+        // the header holds the item count of the compacted part, only the appended records are read
+        uint32_t pos = baseLen;
+        count = baseCount;
+        while (readQueueRecord(storageType, pos, size, kind, item, false))
+            count += kind == FIREBASE_ERROR_QUEUE_RECORD_ITEM ? 1 : -1;
     }
-    else if (storageType == mem_storage_type_sd)
+    else
     {
-#if defined(MBFS_SD_FS) && defined(CARD_TYPE_SD)
-        MBFS_SD_FILE file = Core.mbfs.getSDFile();
-        count = readQueueFileSdFat(fbdo, file, item, mode);
-#endif
-    }
+        MB_VECTOR<QueueItem> items;
+        uint32_t pos = FIREBASE_ERROR_QUEUE_HEADER_SIZE;
 
-#else
+        while (readQueueRecord(storageType, pos, size, kind, item, true))
+        {
+            FBUtils::idle();
 
-    if (storageType == mem_storage_type_flash)
-    {
-#if defined(MBFS_FLASH_FS)
-        fs::File file = Core.mbfs.getFlashFile();
-        count = readQueueFile(fbdo, file, item, mode);
-#endif
-    }
-    else if (storageType == mem_storage_type_sd)
-    {
-#if defined(MBFS_SD_FS) && defined(CARD_TYPE_SD)
-        MBFS_SD_FILE file = Core.mbfs.getSDFile();
-        count = readQueueFile(fbdo, file, item, mode);
-#endif
+            if (kind == FIREBASE_ERROR_QUEUE_RECORD_ITEM)
+                items.push_back(item);
+            else
+            {
+                for (size_t i = 0; i < items.size(); i++)
+                {
+                    if (items[i].qID == item.qID)
+                    {
+                        items.erase(items.begin() + i);
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!fbdo->_qMan._queueCollection)
+            fbdo->_qMan._queueCollection = new MB_VECTOR<struct QueueItem>();
+
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            bool existed = false;
+            for (size_t j = 0; j < fbdo->_qMan.size() && !existed; j++)
+                existed = fbdo->_qMan._queueCollection->at(j).qID == items[i].qID;
+
+            if (!existed)
+                fbdo->_qMan._queueCollection->push_back(items[i]);
+        }
+
+        count = items.size();
     }
 
-#endif
+    Core.mbfs.close(mbfs_type storageType);
+
+    if (count < 0)
+        count = 0;
 
-    return count;
+    return count > 255 ? 255 : count;
 }
 
-#if (defined(MBFS_FLASH_FS) || defined(MBFS_SD_FS)) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
-uint8_t FB_RTDB::readQueueFile(FirebaseData *fbdo, fs::File &file, QueueItem &item, uint8_t mode)
+bool FB_RTDB::readQueueHeader(firebase_mem_storage_type storageType, uint32_t &baseLen, uint16_t &count)
 {
+    uint8_t buf[FIREBASE_ERROR_QUEUE_HEADER_SIZE];
+    size_t pos = 0;
 
-    uint8_t count = 0;
-    FirebaseJsonArray arr;
-    FirebaseJsonData result;
+    if (!Core.mbfs.seek(mbfs_type storageType, 0) ||
+        Core.mbfs.read(mbfs_type storageType, buf, sizeof(buf)) != (int)sizeof(buf))
+        return false;
 
-    while (file.available())
-    {
-        FBUtils::idle();
-        if (arr.readFrom(file))
-        {
-            if (mode == 1)
-            {
-                for (size_t i = 0; i < arr.size(); i++)
-                {
-                    FBUtils::idle();
-                    arr.get(result, i);
-                    if (result.success)
-                    {
-                        switch (i)
-                        {
-                        case 0:
-                            item.dataType = (firebase_data_type)result.to<int>();
-                            break;
-                        case 1:
-                            item.subType = result.to<int>();
-                            break;
-                        case 2:
-                            item.method = (firebase_request_method)result.to<int>();
-                            break;
-                        case 3:
-                            item.storageType = (firebase_mem_storage_type)result.to<int>();
-                            break;
-                        case 4:
-                            item.async = (bool)result.to<int>();
-                            break;
-                        case 5:
-                            item.address.din = result.to<int>();
-                            break;
-                        case 6:
-                            item.address.dout = result.to<int>();
-                            break;
-                        case 7:
-                            item.address.query = result.to<int>();
-                            break;
-                        case 8:
-                            item.address.priority = result.to<int>();
-                            break;
-                        case 9:
-                            item.blobSize = result.to<int>();
-                            break;
-                        case 10:
-                            item.path = result.to<MB_String>();
-                            break;
-                        case 11:
-                            item.payload = result.to<MB_String>();
-                            break;
-                        case 12:
-                            item.etag = result.to<MB_String>();
-                            break;
-                        case 13:
-                            item.filename = result.to<MB_String>();
-                            break;
-                        default:
-                            break;
-                        }
-                    }
-                }
-                if (!fbdo->_qMan._queueCollection)
-                    fbdo->_qMan._queueCollection = new MB_VECTOR<struct QueueItem>();
+    if (fb_queue_get(buf, pos, 4) != FIREBASE_ERROR_QUEUE_FILE_MAGIC)
+        return false;
 
-                fbdo->_qMan._queueCollection->push_back(item);
-            }
-            count++;
-        }
+    baseLen = fb_queue_get(buf, pos, 4);
+    count = fb_queue_get(buf, pos, 2);
+
+    return fb_queue_get(buf, pos, 2) == fb_queue_crc(0xffff, buf, 10);
+}
+
+bool FB_RTDB::writeQueueHeader(firebase_mem_storage_type storageType, uint32_t baseLen, uint16_t count)
+{
+    uint8_t buf[FIREBASE_ERROR_QUEUE_HEADER_SIZE];
+    size_t pos = 0;
+    fb_queue_put(buf, pos, FIREBASE_ERROR_QUEUE_FILE_MAGIC, 4);
+    fb_queue_put(buf, pos, baseLen, 4);
+    fb_queue_put(buf, pos, count, 2);
+    fb_queue_put(buf, pos, fb_queue_crc(0xffff, buf, pos), 2);
+    return Core.mbfs.write(mbfs_type storageType, buf, pos) == (int)pos;
+}
+
+size_t FB_RTDB::queueRecordSize(uint8_t kind, const QueueItem &item)
+{
+    // kind, length, queue ID and CRC
+    size_t len = 1 + 4 + 4 + 2;
+
+    // 5 bytes and 5 integers of the item, 4 strings with 4 bytes length
+    if (kind == FIREBASE_ERROR_QUEUE_RECORD_ITEM)
+        len += 5 + 5 * 4 + 4 * 4 + item.path.length() + item.payload.length() +
+               item.etag.length() + item.filename.length();
+
+    return len;
+}
+
+bool FB_RTDB::writeQueueRecord(firebase_mem_storage_type storageType, uint8_t kind, const QueueItem &item)
+{
+    size_t len = queueRecordSize(kind, item);
+    uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(len));
+    if (!buf)
+        return false;
+
+    size_t pos = 0;
+    buf[pos++] = kind;
+    fb_queue_put(buf, pos, len - 7, 4);
+    fb_queue_put(buf, pos, item.qID, 4);
+
+    if (kind == FIREBASE_ERROR_QUEUE_RECORD_ITEM)
+    {
+        buf[pos++] = (uint8_t)item.dataType;
+        buf[pos++] = (uint8_t)item.subType;
+        buf[pos++] = (uint8_t)item.method;
+        buf[pos++] = (uint8_t)item.storageType;
+        buf[pos++] = (uint8_t)item.async;
+        fb_queue_put(buf, pos, item.address.din, 4);
+        fb_queue_put(buf, pos, item.address.dout, 4);
+        fb_queue_put(buf, pos, item.address.query, 4);
+        fb_queue_put(buf, pos, item.address.priority, 4);
+        fb_queue_put(buf, pos, item.blobSize, 4);
+        fb_queue_put_str(buf, pos, item.path);
+        fb_queue_put_str(buf, pos, item.payload);
+        fb_queue_put_str(buf, pos, item.etag);
+        fb_queue_put_str(buf, pos, item.filename);
     }
 
-    return count;
+    fb_queue_put(buf, pos, fb_queue_crc(0xffff, buf, pos), 2);
+
+    bool ret = Core.mbfs.write(mbfs_type storageType, buf, pos) == (int)pos;
+    Core.mbfs.delP(&buf);
+    return ret;
 }
-#endif
 
-#if defined(MBFS_ESP32_SDFAT_ENABLED)
-uint8_t FB_RTDB::readQueueFileSdFat(FirebaseData *fbdo, MBFS_SD_FILE &file, QueueItem &item, uint8_t mode)
+bool FB_RTDB::readQueueRecord(firebase_mem_storage_type storageType, uint32_t &pos, uint32_t size, uint8_t &kind,
+                              QueueItem &item, bool full)
 {
-    uint8_t count = 0;
-    FirebaseJsonArray arr;
-    FirebaseJsonData result;
+    uint8_t head[9];
+    size_t ofs = 0;
+
+    if (pos + sizeof(head) + 2 > size || !Core.mbfs.seek(mbfs_type storageType, pos) ||
+        Core.mbfs.read(mbfs_type storageType, head, sizeof(head)) != (int)sizeof(head))
+        return false;
+
+    kind = head[ofs++];
+    uint32_t len = fb_queue_get(head, ofs, 4);
+    uint32_t end = pos + 5 + len + 2;
+
+    if ((kind != FIREBASE_ERROR_QUEUE_RECORD_ITEM && kind != FIREBASE_ERROR_QUEUE_RECORD_TOMBSTONE) ||
+        len < 4 || end > size || end < pos)
+        return false;
+
+    item.qID = fb_queue_get(head, ofs, 4);
 
-    while (file.available())
+    if (full)
     {
-        FBUtils::idle();
-        if (arr.readFrom(file))
+        uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(end - pos));
+        if (!buf)
+            return false;
+
+        memcpy(buf, head, sizeof(head));
+        size_t rest = end - pos - sizeof(head);
+        bool ret = Core.mbfs.read(mbfs_type storageType, buf + sizeof(head), rest) == (int)rest;
+
+        size_t crcPos = end - pos - 2;
+        ret = ret && fb_queue_get(buf, crcPos, 2) == fb_queue_crc(0xffff, buf, end - pos - 2);
+
+        if (ret && kind == FIREBASE_ERROR_QUEUE_RECORD_ITEM)
         {
-            if (mode == 1)
+            size_t dataEnd = end - pos - 2;
+            ret = dataEnd >= ofs + 5 + 5 * 4;
+            if (ret)
             {
-                for (size_t i = 0; i < arr.size(); i++)
-                {
-                    FBUtils::idle();
-                    arr.get(result, i);
-                    if (result.success)
-                    {
-                        switch (i)
-                        {
-                        case 0:
-                            item.dataType = (firebase_data_type)result.to<int>();
-                            break;
-                        case 1:
-                            item.subType = result.to<int>();
-                            break;
-                        case 2:
-                            item.method = (firebase_request_method)result.to<int>();
-                            break;
-                        case 3:
-                            item.storageType = (firebase_mem_storage_type)result.to<int>();
-                            break;
-                        case 4:
-                            item.async = (bool)result.to<int>();
-                            break;
-                        case 5:
-                            item.address.din = result.to<int>();
-                            break;
-                        case 6:
-                            item.address.dout = result.to<int>();
-                            break;
-                        case 7:
-                            item.address.query = result.to<int>();
-                            break;
-                        case 8:
-                            item.address.priority = result.to<int>();
-                            break;
-                        case 9:
-                            item.blobSize = result.to<int>();
-                            break;
-                        case 10:
-                            item.path = result.to<MB_String>();
-                            break;
-                        case 11:
-                            item.payload = result.to<MB_String>();
-                            break;
-                        case 12:
-                            item.etag = result.to<MB_String>();
-                            break;
-                        case 13:
-                            item.filename = result.to<MB_String>();
-                            break;
-                        default:
-                            break;
-                        }
-                    }
-                }
-                if (!fbdo->_qMan._queueCollection)
-                    fbdo->_qMan._queueCollection = new MB_VECTOR<struct QueueItem>();
-
-                fbdo->_qMan._queueCollection->push_back(item);
+                item.dataType = (firebase_data_type)buf[ofs++];
+                item.subType = buf[ofs++];
+                item.method = (firebase_request_method)buf[ofs++];
+                item.storageType = (firebase_mem_storage_type)buf[ofs++];
+                item.async = buf[ofs++];
+                item.address.din = fb_queue_get(buf, ofs, 4);
+                item.address.dout = fb_queue_get(buf, ofs, 4);
+                item.address.query = fb_queue_get(buf, ofs, 4);
+                item.address.priority = fb_queue_get(buf, ofs, 4);
+                item.blobSize = fb_queue_get(buf, ofs, 4);
+                ret = fb_queue_get_str(buf, ofs, dataEnd, item.path) &&
+                      fb_queue_get_str(buf, ofs, dataEnd, item.payload) &&
+                      fb_queue_get_str(buf, ofs, dataEnd, item.etag) &&
+                      fb_queue_get_str(buf, ofs, dataEnd, item.filename);
             }
-            count++;
         }
+
+        Core.mbfs.delP(&buf);
+
+        if (!ret)
+            return false;
     }
 
-    return count;
+    pos = end;
+    return true;
 }
 
-#endif
-
 bool FB_RTDB::isErrorQueueFull(FirebaseData *fbdo)
 {
     if (fbdo->_qMan._maxQueue > 0)
@@ -1610,11 +2205,7 @@ void FB_RTDB::rescon(FirebaseData *fbdo, const char *host, firebase_rtdb_request
                                                      ? true
                                                      : false;
 
-    if (fbdo->session.cert_updated || millis() - fbdo->session.last_conn_ms > fbdo->session.conn_timeout ||
-        fbdo->session.rtdb.stream_path_changed ||
-        (req->method == rtdb_stream && fbdo->session.con_mode != firebase_con_mode_rtdb_stream) ||
-        (req->method != rtdb_stream && fbdo->session.con_mode == firebase_con_mode_rtdb_stream) ||
-        strcmp(host, fbdo->session.host.c_str()) != 0)
+    if (isNewSessionRequired(fbdo, host, req))
     {
         fbdo->session.last_conn_ms = millis();
         fbdo->closeSession();
@@ -1628,6 +2219,15 @@ void FB_RTDB::rescon(FirebaseData *fbdo, const char *host, firebase_rtdb_request
         fbdo->session.rtdb.stream_resume_millis = 0;
 }
 
+bool FB_RTDB::isNewSessionRequired(FirebaseData *fbdo, const char *host, firebase_rtdb_request_info_t *req)
+{
+    return fbdo->session.cert_updated || millis() - fbdo->session.last_conn_ms > fbdo->session.conn_timeout ||
+           fbdo->session.rtdb.stream_path_changed ||
+           (req->method == rtdb_stream && fbdo->session.con_mode != firebase_con_mode_rtdb_stream) ||
+           (req->method != rtdb_stream && fbdo->session.con_mode == firebase_con_mode_rtdb_stream) ||
+           strcmp(host, fbdo->session.host.c_str()) != 0;
+}
+
 bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req)
 {
     FBUtils::idle();
@@ -1669,8 +2269,13 @@ bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_inf
     if (req->async)
         fbdo->session.rtdb.async_count++;
 
+    prepareCachedRequest(fbdo, req);
+
     if (sendRequest(fbdo, req))
     {
+        // the response will be read by the async pool
+        if (req->deferred)
+            return true;
 
         if (req->method == rtdb_stream)
         {
@@ -1884,7 +2489,7 @@ int FB_RTDB::preRequestCheck(FirebaseData *fbdo, struct firebase_rtdb_request_in
         code = FIREBASE_ERROR_UNINITIALIZED;
     else if (fbdo->session.rtdb.pause)
         code = FIREBASE_ERROR_USER_PAUSE;
-    else if (!fbdo->tokenReady())
+    else if (!fbdo->tokenReady(true))
         code = FIREBASE_ERROR_TOKEN_NOT_READY;
     else if (req->path.length() == 0 ||
              (Core.config->database_url.length() == 0 && Core.config->host.length() == 0) ||
@@ -2020,7 +2625,7 @@ bool FB_RTDB::sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_
     {
         FirebaseJson *json = addrTo<FirebaseJson *>(req->data.address.din);
         if (json)
-            fbdo->tcpSend(json->raw());
+            fbdo->tcpSend(json, bufSize);
     }
     else if (req->payload.length() > 0 || (req->data.type == d_array && req->data.address.din > 0))
     {
@@ -2035,7 +2640,7 @@ bool FB_RTDB::sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_
         {
             FirebaseJsonArray *arr = addrTo<FirebaseJsonArray *>(req->data.address.din);
             if (arr)
-                fbdo->tcpSend(arr->raw());
+                fbdo->tcpSend(arr, bufSize);
 
             if (fbdo->session.response.code < 0)
                 return false;
@@ -2173,32 +2778,34 @@ bool FB_RTDB::encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_St
 
     reportUploadProgress(fbdo, req, total);
 
-    firebase_base64_io_t<uint8_t> out;
-    out.outC = &fbdo->tcpClient;
-    out.bufLen = bufSize;
-    uint8_t *outBuf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(out.bufLen));
-    out.outT = outBuf;
+    // the file is read in multiple of 3 bytes then each read is encoded to the whole base64 quanta
+    size_t readLen = bufSize >= 4 ? bufSize / 4 * 3 : 3;
+    firebase_base64_stream_t st;
+    uint8_t *outBuf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(readLen / 3 * 4));
+    uint8_t *data = reinterpret_cast<uint8_t *>(Core.mbfs.newP(readLen));
     unsigned char *base64EncBuf = Core.bh.creatBase64EncBuffer(&Core.mbfs, false);
-    uint8_t *data = reinterpret_cast<uint8_t *>(Core.mbfs.newP(3));
 
     while (Core.mbfs.available(mbfs_type storageType))
     {
-        // read 3 bytes from stream
-        int read = Core.mbfs.read(mbfs_type storageType, data, 3);
-        if (read)
-        {
-            if (!Core.bh.encode<uint8_t>(&Core.mbfs, base64EncBuf, data, read, out, read != 3 /* write remaining */))
-                break;
-            total += read;
-            reportUploadProgress(fbdo, req, total);
-        }
-        else
+        int read = Core.mbfs.read(mbfs_type storageType, data, readLen);
+        if (read <= 0)
             break;
+
+        size_t len = Core.bh.encodeUpdate(base64EncBuf, st, data, read, outBuf);
+        if (len > 0 && fbdo->tcpClient.write(outBuf, len) != len)
+            break;
+
+        total += read;
+        reportUploadProgress(fbdo, req, total);
     }
 
     // remainig data to wrire? write it
-    if (size == total && out.bufWrite > 0)
-        Core.bh.writeOutput(&Core.mbfs, out);
+    if (size == total)
+    {
+        size_t len = Core.bh.encodeFinal(base64EncBuf, st, outBuf);
+        if (len > 0 && fbdo->tcpClient.write(outBuf, len) != len)
+            total = 0;
+    }
 
     Core.mbfs.delP(&data);
     Core.mbfs.delP(&base64EncBuf);
@@ -2328,11 +2935,11 @@ waits:
             if (response.contentType.find(pgm2Str(firebase_rtdb_pgm_str_9 /* "text/event-stream" */)) != MB_String::npos)
                 fbdo->session.rtdb.new_stream = false; // reset new stream connection status
 
-            // check connection types
+            // check connection types, the persistent connection is the default of HTTP/1.1
             fbdo->session.rtdb.http_resp_conn_type = Core.sh.compare(response.connection,
-                                                                     0, firebase_pgm_str_15 /* "keep-alive" */)
-                                                         ? firebase_http_connection_type_keep_alive
-                                                         : firebase_http_connection_type_close;
+                                                                     0, firebase_rtdb_pgm_str_45 /* "close" */, true)
+                                                         ? firebase_http_connection_type_close
+                                                         : firebase_http_connection_type_keep_alive;
 
             // store download size for file function
             if (req->method == rtdb_backup)
@@ -2345,6 +2952,13 @@ waits:
             }
 
             fbdo->session.rtdb.resp_etag = response.etag;
+
+            // the response has no payload, the next pipelined response may follow
+            if (req->deferred && !response.isChunkedEnc && response.contentLen == 0)
+            {
+                complete = true;
+                goto skip;
+            }
         }
         // not http header received, stream payload received?
         else if (!tcpHandler.isHeader && tcpHandler.header.length() > 0)
@@ -2513,7 +3127,35 @@ skip:
     if (response.isChunkedEnc)
         fbdo->tcpClient.flush();
 
-    endDownload(fbdo, req, tcpHandler, response);
+    endDownload(fbdo, req, tcpHandler, response);
+
+    // the node was not modified since it was cached?
+    if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NOT_MODIFIED)
+    {
+        bool revalidated = fbdo->session.rtdb.cache.revalidate >= 0;
+
+        if (readCachedResponse(fbdo, response, payload))
+        {
+            tcpHandler.error.code = 0;
+            fbdo->session.error.clear();
+        }
+        else if (req->deferred)
+        {
+            // the responses of the pipelined requests follow on this connection,
+            // the request is not sent from here, the async pool sends it again
+            req->resend = true;
+        }
+        else if (revalidated)
+        {
+            // the cached payload could not be read, the revalidation was cancelled,
+            // request the node again without If-None-Match
+            if (!sendRequest(fbdo, req))
+                return false;
+            return handleResponse(fbdo, req);
+        }
+    }
+    else if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK)
+        storeCachedResponse(fbdo, req, response, payload);
 
     parsePayload(fbdo, req, response, payload);
 
@@ -2752,6 +3394,18 @@ void FB_RTDB::sendCB(FirebaseData *fbdo)
     if (!fbdo->streamAvailable())
         return;
 
+    // the queued events will be sent to callback after the stream was read
+    if (fbdo->session.rtdb.stream_queue.max_size > 0)
+    {
+        queueStreamEvent(fbdo);
+        return;
+    }
+
+    deliverCB(fbdo);
+}
+
+void FB_RTDB::deliverCB(FirebaseData *fbdo)
+{
     // to allow other subsequence request which can be occurred in the user stream
     // callback
     Core.internal.fb_processing = false;
@@ -2806,6 +3460,13 @@ void FB_RTDB::sendCB(FirebaseData *fbdo)
     }
     else if (fbdo->_multiPathDataCallback)
     {
+        if (fbdo->_multiPathNodes.size() > 0)
+        {
+            dispatchMultiPathStream(fbdo);
+            fbdo->session.rtdb.data_available = false;
+            return;
+        }
+
         FIREBASE_MP_STREAM_CLASS s;
         s.begin(&fbdo->session.rtdb.stream);
         s.sif->data_type = fbdo->session.rtdb.resp_data_type;
@@ -2835,35 +3496,561 @@ void FB_RTDB::sendCB(FirebaseData *fbdo)
     }
 }
 
-void FB_RTDB::splitStreamPayload(const MB_String &payloads, MB_VECTOR<MB_String> &payload)
+void FB_RTDB::mAddMultiPathStreamChild(FirebaseData *fbdo, MB_StringPtr childPath,
+                                       FirebaseData::MultiPathStreamEventCallback callback)
 {
-    int ofs = 0;
-    int pos1 = 0, pos2 = 0, pos3 = 0;
+    MB_String path = childPath;
+    Core.ut.makePath(path);
+
+    // node 0 is the parent path
+    if (fbdo->_multiPathNodes.size() == 0)
+    {
+        firebase_stream_path_node_t root;
+        fbdo->_multiPathNodes.push_back(root);
+    }
 
-    while (pos1 > -1)
+    int node = 0;
+    const char *p = path.c_str();
+
+    while (*p)
     {
-        if (Core.sh.find(payloads, firebase_rtdb_pgm_str_12 /* "event: " */, false, ofs, pos1))
+        while (*p == '/')
+            p++;
+
+        if (!*p)
+            break;
+
+        const char *end = strchr(p, '/');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+
+        int child = findPathNode(fbdo, node, p, len);
+
+        if (child < 0)
         {
-            ofs = pos1 + 1;
-            if (Core.sh.find(payloads, firebase_rtdb_pgm_str_13 /* "data: " */, false, ofs, pos2))
+            firebase_stream_path_node_t n;
+            n.name.append(p, len);
+            child = fbdo->_multiPathNodes.size();
+            fbdo->_multiPathNodes.push_back(n);
+
+            // keep the siblings in the subscription order
+            int last = fbdo->_multiPathNodes[node].child;
+            if (last < 0)
+                fbdo->_multiPathNodes[node].child = child;
+            else
             {
-                ofs = pos2 + 1;
-                if (Core.sh.find(payloads, firebase_pgm_str_12 /* "\n" */, false, ofs, pos3))
-                    ofs = pos3 + 1;
-                else
-                    pos3 = payloads.length();
+                while (fbdo->_multiPathNodes[last].next > -1)
+                    last = fbdo->_multiPathNodes[last].next;
+                fbdo->_multiPathNodes[last].next = child;
+            }
+        }
+
+        node = child;
+        p += len;
+    }
+
+    if (fbdo->_multiPathNodes[node].sub < 0)
+    {
+        fbdo->_multiPathNodes[node].sub = fbdo->_multiPathChildCallbacks.size();
+        fbdo->_multiPathChildCallbacks.push_back(callback);
+    }
+    else
+        fbdo->_multiPathChildCallbacks[fbdo->_multiPathNodes[node].sub] = callback;
+
+    fbdo->_multiPathNodes[node].path = path;
+    fbdo->_multiPathVersion++;
+}
+
+void FB_RTDB::clearMultiPathStreamChildren(FirebaseData *fbdo)
+{
+    fbdo->_multiPathNodes.clear();
+    fbdo->_multiPathChildCallbacks.clear();
+    fbdo->_multiPathVersion++;
+}
+
+int FB_RTDB::findPathNode(FirebaseData *fbdo, int parent, const char *name, size_t len)
+{
+    // the subscriptions may be cleared from the callback
+    if (parent >= (int)fbdo->_multiPathNodes.size())
+        return -1;
+
+    for (int c = fbdo->_multiPathNodes[parent].child; c > -1; c = fbdo->_multiPathNodes[c].next)
+    {
+        if (fbdo->_multiPathNodes[c].name.length() == len &&
+            strncmp(fbdo->_multiPathNodes[c].name.c_str(), name, len) == 0)
+            return c;
+    }
+    return -1;
+}
+
+void FB_RTDB::dispatchMultiPathStream(FirebaseData *fbdo)
+{
+    uint16_t version = fbdo->_multiPathVersion;
+
+    // the subscribers on the event path, the changed data is under their paths
+    int node = 0;
+    if (fbdo->_multiPathNodes[node].sub > -1 && !sendMultiPathCB(fbdo, node, nullptr, version))
+        return;
+
+    MB_String path = fbdo->session.rtdb.path;
+    const char *p = path.c_str();
+
+    while (*p)
+    {
+        while (*p == '/')
+            p++;
+
+        if (!*p)
+            break;
+
+        const char *end = strchr(p, '/');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+
+        node = findPathNode(fbdo, node, p, len);
+
+        // no subscriber under this path
+        if (node < 0)
+            return;
+
+        if (fbdo->_multiPathNodes[node].sub > -1 && !sendMultiPathCB(fbdo, node, nullptr, version))
+            return;
+
+        p += len;
+    }
+
+    bool isPatch = Core.sh.compare(fbdo->session.rtdb.event_type, 0, firebase_pgm_str_17 /* "patch" */);
+    bool isPut = Core.sh.compare(fbdo->session.rtdb.event_type, 0, firebase_pgm_str_16 /* "put" */);
+
+    if ((!isPatch && !isPut) || fbdo->_multiPathNodes[node].child < 0)
+        return;
+
+    // the subscribers under the event path get their parts of the event data,
+    // the primitive or null data is not parsed to JSON object and all of them get null
+    MB_JSON *json = MB_JSON_Parse(fbdo->session.rtdb.raw.c_str());
+
+    if (isPut)
+        dispatchMultiPathChildren(fbdo, node, json, version);
+    else if (json && MB_JSON_IsObject(json))
+    {
+        for (MB_JSON *item = json->child; item; item = item->next)
+        {
+            if (!dispatchMultiPathPatch(fbdo, node, item->string, item, version))
+                break;
+        }
+    }
+
+    if (json)
+        MB_JSON_Delete(json);
+}
+
+bool FB_RTDB::dispatchMultiPathChildren(FirebaseData *fbdo, int node, MB_JSON *item, uint16_t version)
+{
+    for (int c = fbdo->_multiPathNodes[node].child; c > -1; c = fbdo->_multiPathNodes[c].next)
+    {
+        const char *name = fbdo->_multiPathNodes[c].name.c_str();
+        MB_JSON *e = nullptr;
+
+        if (item && MB_JSON_IsArray(item))
+        {
+            if (isdigit(name[0]))
+                e = MB_JSON_GetArrayItem(item, atoi(name));
+        }
+        else if (item && MB_JSON_IsObject(item))
+            e = MB_JSON_GetObjectItemCaseSensitive(item, name);
+
+        // the data was replaced, the subscriber of the child that no longer exists gets null
+        if (fbdo->_multiPathNodes[c].sub > -1)
+        {
+            MB_JSON *nullItem = e ? nullptr : MB_JSON_CreateNull();
+            bool ret = sendMultiPathCB(fbdo, c, e ? e : nullItem, version);
+            if (nullItem)
+                MB_JSON_Delete(nullItem);
+            if (!ret)
+                return false;
+        }
+
+        if (fbdo->_multiPathNodes[c].child > -1 && !dispatchMultiPathChildren(fbdo, c, e, version))
+            return false;
+    }
+
+    return true;
+}
+
+bool FB_RTDB::dispatchMultiPathPatch(FirebaseData *fbdo, int node, const char *key, MB_JSON *value, uint16_t version)
+{
+    // the patch key is the path of changed node relative to the event path e.g. "a/b"
+    const char *p = key;
+    bool found = false;
+
+    while (p && *p)
+    {
+        while (*p == '/')
+            p++;
+
+        if (!*p)
+            break;
+
+        const char *end = strchr(p, '/');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+
+        node = findPathNode(fbdo, node, p, len);
+
+        // no subscriber under this path
+        if (node < 0)
+            return true;
+
+        found = true;
+        p += len;
+        while (*p == '/')
+            p++;
+
+        if (fbdo->_multiPathNodes[node].sub > -1)
+        {
+            if (*p)
+            {
+                // the subscriber above the changed node gets the patch of its own path
+                MB_JSON *part = MB_JSON_CreateObject();
+                MB_JSON_AddItemReferenceToObject(part, p, value);
+                bool ret = sendMultiPathCB(fbdo, node, part, version);
+                MB_JSON_Delete(part);
+                if (!ret)
+                    return false;
+            }
+            else if (!sendMultiPathCB(fbdo, node, value, version))
+                return false;
+        }
+    }
+
+    // the patched value replaces the data under the changed node
+    if (found && fbdo->_multiPathNodes[node].child > -1)
+        return dispatchMultiPathChildren(fbdo, node, value, version);
+
+    return true;
+}
+
+bool FB_RTDB::sendMultiPathCB(FirebaseData *fbdo, int node, MB_JSON *item, uint16_t version)
+{
+    FIREBASE_MP_STREAM_CLASS s;
+    s.begin(&fbdo->session.rtdb.stream);
+    s.dispatched = true;
+    s.childPath = fbdo->_multiPathNodes[node].path;
+    s.sif->data_type = fbdo->session.rtdb.resp_data_type;
+    s.sif->path = fbdo->session.rtdb.path;
+    s.sif->data_type_str = fbdo->getDataType(s.sif->data_type);
+    s.sif->event_type_str = fbdo->session.rtdb.event_type;
+    s.sif->payload_length = fbdo->session.payload_length;
+    s.sif->max_payload_length = fbdo->session.max_payload_length;
+    s.eventType = fbdo->session.rtdb.event_type.c_str();
+
+    if (item)
+    {
+        firebase_data_type type = d_null;
+        if (MB_JSON_IsObject(item))
+            type = d_json;
+        else if (MB_JSON_IsArray(item))
+            type = d_array;
+        else if (MB_JSON_IsString(item))
+            type = d_string;
+        else if (MB_JSON_IsBool(item))
+            type = d_boolean;
+
+        if (MB_JSON_IsString(item))
+            s.value = item->valuestring;
+        else
+        {
+            char *out = MB_JSON_PrintUnformatted(item);
+            s.value = out;
+            MB_JSON_free(out);
+        }
+
+        if (MB_JSON_IsNumber(item) || MB_JSON_IsRaw(item))
+        {
+            if (strchr(s.value.c_str(), '.'))
+                type = s.value.length() <= 7 ? d_float : d_double;
+            else
+                type = d_integer;
+        }
+
+        s.type = fbdo->getDataType(type).c_str();
+        s.dataPath = fbdo->_multiPathNodes[node].path.c_str();
+    }
+    else
+    {
+        s.value = fbdo->session.rtdb.raw.c_str();
+        s.type = s.sif->data_type_str.c_str();
+        s.dataPath = fbdo->session.rtdb.path.c_str();
+    }
+
+    FirebaseData::MultiPathStreamEventCallback cb = fbdo->_multiPathChildCallbacks[fbdo->_multiPathNodes[node].sub];
+    if (!cb)
+        cb = fbdo->_multiPathDataCallback;
+
+    if (cb)
+        cb(s);
+
+    s.empty();
+
+    // the subscriptions were changed from the callback, the node indexes are no longer valid
+    return fbdo->_multiPathVersion == version;
+}
+
+void FB_RTDB::queueStreamEvent(FirebaseData *fbdo)
+{
+    firebase_stream_queue_info_t &queue = fbdo->session.rtdb.stream_queue;
+
+    firebase_stream_event_t event;
+    event.data_type = fbdo->session.rtdb.resp_data_type;
+    event.event_type = fbdo->session.rtdb.event_type;
+    event.path = fbdo->session.rtdb.path;
+    event.data = fbdo->session.rtdb.raw;
+
+    if (event.data_type == d_blob && fbdo->session.rtdb.blob)
+        event.blob.swap(*fbdo->session.rtdb.blob);
+
+    bool isPatch = Core.sh.compare(event.event_type, 0, firebase_pgm_str_17 /* "patch" */);
+    bool isData = isPatch || Core.sh.compare(event.event_type, 0, firebase_pgm_str_16 /* "put" */);
+
+    if (isData && queue.mode != firebase_stream_coalesce_none)
+    {
+        // search from the latest, the patch is applied on top of the latest queued event
+        for (int i = (int)queue.events.size() - 1; i >= 0; i--)
+        {
+            firebase_stream_event_t &queued = queue.events[i];
+
+            if (strcmp(queued.path.c_str(), event.path.c_str()) != 0 ||
+                (!Core.sh.compare(queued.event_type, 0, firebase_pgm_str_16 /* "put" */) &&
+                 !Core.sh.compare(queued.event_type, 0, firebase_pgm_str_17 /* "patch" */)))
+                continue;
+
+            if (isPatch)
+            {
+                // patch changes only the children in its data, the queued event is kept unless the
+                // patch can be applied to it
+                if (queue.mode != firebase_stream_coalesce_merge_patch ||
+                    (queued.data_type != d_json && !Core.sh.compare(queued.event_type, 0, firebase_pgm_str_16 /* "put" */)) ||
+                    event.data_type != d_json || !mergeStreamJson(queued.data, event.data))
+                    break;
+
+                event.data = queued.data;
+                event.data_type = d_json;
+                event.event_type = queued.event_type;
+                queue.events.erase(queue.events.begin() + i);
+                queue.coalesced++;
+                break;
+            }
+
+            // put replaces all data at its path, the queued put and patch events are no longer needed
+            queue.events.erase(queue.events.begin() + i);
+            queue.coalesced++;
+        }
+    }
+
+    if (queue.events.size() >= queue.max_size)
+    {
+        size_t i = 0;
+        while (i < queue.events.size() - 1 &&
+               !Core.sh.compare(queue.events[i].event_type, 0, firebase_pgm_str_16 /* "put" */) &&
+               !Core.sh.compare(queue.events[i].event_type, 0, firebase_pgm_str_17 /* "patch" */))
+            i++;
+
+        queue.events.erase(queue.events.begin() + i);
+        queue.dropped++;
+    }
+
+    queue.events.push_back(event);
+}
+
+bool FB_RTDB::mergeStreamJson(MB_String &dest, const MB_String &src)
+{
+    MB_JSON *d = MB_JSON_Parse(dest.c_str());
+    MB_JSON *p = MB_JSON_Parse(src.c_str());
+    bool ret = false;
+
+    if (p && MB_JSON_IsObject(p))
+    {
+        // the patch to primitive, array or null data makes it the object
+        if (!d || !MB_JSON_IsObject(d))
+        {
+            if (d)
+                MB_JSON_Delete(d);
+            d = MB_JSON_CreateObject();
+        }
+
+        MB_JSON *item = p->child;
+        while (item)
+        {
+            MB_JSON *next = item->next;
+            MB_JSON_DetachItemViaPointer(p, item);
+            setStreamJsonPath(d, item->string, item);
+            item = next;
+        }
+
+        char *out = MB_JSON_PrintUnformatted(d);
+        if (out)
+        {
+            dest = out;
+            MB_JSON_free(out);
+            ret = true;
+        }
+    }
+
+    if (d)
+        MB_JSON_Delete(d);
+    if (p)
+        MB_JSON_Delete(p);
+
+    return ret;
+}
+
+void FB_RTDB::setStreamJsonPath(MB_JSON *obj, const char *path, MB_JSON *value)
+{
+    // the patch key can be the relative path e.g. "a/b/c", set the value at that path,
+    // the null value removes the node as the database does
+    MB_VECTOR<MB_String> keys;
+    Core.sh.splitTk(path, keys, "/");
+
+    bool remove = MB_JSON_IsNull(value);
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        MB_JSON *child = MB_JSON_GetObjectItemCaseSensitive(obj, keys[i].c_str());
+
+        if (i + 1 == keys.size())
+        {
+            if (remove)
+            {
+                if (child)
+                    MB_JSON_DeleteItemFromObjectCaseSensitive(obj, keys[i].c_str());
+                MB_JSON_Delete(value);
+            }
+            else if (child)
+                MB_JSON_ReplaceItemInObjectCaseSensitive(obj, keys[i].c_str(), value);
+            else
+                MB_JSON_AddItemToObject(obj, keys[i].c_str(), value);
+            return;
+        }
+
+        if (!child || !MB_JSON_IsObject(child))
+        {
+            if (remove)
+            {
+                MB_JSON_Delete(value);
+                return;
+            }
+
+            MB_JSON *node = MB_JSON_CreateObject();
+            if (child)
+                MB_JSON_ReplaceItemInObjectCaseSensitive(obj, keys[i].c_str(), node);
+            else
+                MB_JSON_AddItemToObject(obj, keys[i].c_str(), node);
+            child = node;
+        }
+
+        obj = child;
+    }
+
+    // empty key
+    MB_JSON_Delete(value);
+}
+
+void FB_RTDB::dispatchStreamQueue(FirebaseData *fbdo)
+{
+    firebase_stream_queue_info_t &queue = fbdo->session.rtdb.stream_queue;
+
+    if (queue.events.size() == 0)
+        return;
+
+    if (!fbdo->_dataAvailableCallback && !fbdo->_multiPathDataCallback)
+    {
+        queue.events.clear();
+        return;
+    }
+
+    // keep the state of the last read event which the next event will be compared with
+    firebase_data_type dataType = fbdo->session.rtdb.resp_data_type;
+    MB_String eventType = fbdo->session.rtdb.event_type;
+    MB_String path = fbdo->session.rtdb.path;
+    MB_String raw = fbdo->session.rtdb.raw;
+
+    for (uint8_t n = 0; n < queue.dispatch_count && queue.events.size() > 0; n++)
+    {
+        firebase_stream_event_t &event = queue.events[0];
+
+        fbdo->session.rtdb.resp_data_type = event.data_type;
+        fbdo->session.rtdb.event_type = event.event_type;
+        fbdo->session.rtdb.path = event.path;
+        fbdo->session.rtdb.raw = event.data;
+
+        if (event.data_type == d_blob)
+        {
+            if (!fbdo->session.rtdb.blob)
+            {
+                fbdo->session.rtdb.isBlobPtr = true;
+                fbdo->session.rtdb.blob = new MB_VECTOR<uint8_t>();
+            }
+            fbdo->session.rtdb.blob->swap(event.blob);
+        }
+
+        queue.events.erase(queue.events.begin());
+
+        deliverCB(fbdo);
+    }
+
+    fbdo->session.rtdb.resp_data_type = dataType;
+    fbdo->session.rtdb.event_type = eventType;
+    fbdo->session.rtdb.path = path;
+    fbdo->session.rtdb.raw = raw;
+}
 
-                payload.push_back(payloads.substr(pos1, pos3 - pos1));
+bool FB_RTDB::parseStreamPayloads(FirebaseData *fbdo, const MB_String &payloads)
+{
+    // The stream data contains multiple event records when children data changed simultaneously.
+    // Scan it once line by line and dispatch each event/data pair in place.
+    const char *buf = payloads.c_str();
+    int len = payloads.length();
+    int elen = strlen_P(firebase_rtdb_pgm_str_12 /* "event: " */);
+    int dlen = strlen_P(firebase_rtdb_pgm_str_13 /* "data: " */);
+    const char *type = NULL;
+    int typeLen = 0;
+    bool validJson = false;
+    int pos = 0;
+
+    while (pos < len)
+    {
+        const char *nl = reinterpret_cast<const char *>(memchr(buf + pos, '\n', len - pos));
+        int end = nl ? nl - buf : len;
+        const char *line = buf + pos;
+        int lineLen = end - pos;
+
+        if (lineLen > 0 && line[lineLen - 1] == '\r')
+            lineLen--;
+
+        if (Core.hh.findSpan(line, lineLen, 0, firebase_rtdb_pgm_str_12 /* "event: " */) == 0)
+        {
+            type = line + elen;
+            typeLen = lineLen - elen;
+        }
+        else if (type && Core.hh.findSpan(line, lineLen, 0, firebase_rtdb_pgm_str_13 /* "data: " */) == 0)
+        {
+            if (Core.ut.validJS(line + dlen, lineLen - dlen))
+            {
+                validJson = true;
+                parseStreamPayload(fbdo, type, typeLen, line + dlen, lineLen - dlen);
+                sendCB(fbdo);
             }
+            type = NULL;
         }
+
+        pos = end + 1;
     }
+
+    return validJson;
 }
 
-void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
+void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const char *type, int typeLen, const char *data, int dataLen)
 {
     struct server_response_data_t response;
 
-    Core.hh.parseRespPayload(&Core.sh, payload, response, false);
+    Core.hh.parseStreamEvent(type, typeLen, data, dataLen, response);
 
     fbdo->session.rtdb.resp_data_type = response.dataType;
     fbdo->session.content_length = response.payloadLen;
@@ -2881,7 +4068,7 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
         }
 
         fbdo->session.rtdb.raw.clear();
-        Core.bh.decodeToArray<uint8_t>(&Core.mbfs, payload.c_str() + response.payloadOfs, *fbdo->session.rtdb.blob);
+        Core.bh.decodeToArray<uint8_t>(&Core.mbfs, data + response.payloadOfs, response.payloadLen, *fbdo->session.rtdb.blob);
     }
     else if (fbdo->session.rtdb.resp_data_type == d_file)
     {
@@ -2893,7 +4080,7 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
         Core.sh.compare(response.eventType, 0, firebase_pgm_str_17 /* "patch" */))
     {
 
-        handlePayload(fbdo, response, payload);
+        handlePayload(fbdo, response, response.eventData);
 
         // Any stream update?
         // based on BLOB or file event data changes (no old data available for comparision or inconvenient for large data)
@@ -2938,7 +4125,7 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const MB_String &payload)
 }
 
 void FB_RTDB::parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req,
-                           struct server_response_data_t &response, MB_String payload)
+                           struct server_response_data_t &response, MB_String &payload)
 {
     // parse the payload
     if (payload.length() > 0)
@@ -2946,35 +4133,8 @@ void FB_RTDB::parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req
         // stream data?
         if (response.isEvent)
         {
-            int pos = 0, ofs = 0, jsonCount = 0;
-            bool validJson = false;
-
-            // counting the occurences of JSON sets
-            while (pos > -1)
-            {
-                if (Core.sh.find(payload, firebase_rtdb_pgm_str_12 /* "event: " */, false, ofs, pos))
-                {
-                    ofs = pos + 1;
-                    jsonCount++;
-                }
-            }
-
-            // we need to spit the tream data if stream data contains multiple sets of JSON
-            // that happens in case simultaneously children data changes.
-            // {json1}{json..}{json n}
-            // Then we pase each JSON and send to callback function.
-            MB_VECTOR<MB_String> payloadList;
-            splitStreamPayload(payload, payloadList);
-            for (size_t i = 0; i < payloadList.size(); i++)
-            {
-                if (Core.ut.validJS(payloadList[i].c_str()))
-                {
-                    validJson = true;
-                    parseStreamPayload(fbdo, payloadList[i].c_str());
-                    sendCB(fbdo);
-                }
-            }
-            payloadList.clear(); // clear payload after splitting
+            // each event record is parsed and sent to callback function
+            bool validJson = parseStreamPayloads(fbdo, payload);
             payload.clear();
 
             if (validJson)
@@ -3012,7 +4172,7 @@ void FB_RTDB::parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req
                     fbdo->session.rtdb.resp_data_type != d_file &&
                     fbdo->session.rtdb.resp_data_type != d_file_ota)
                 {
-                    handlePayload(fbdo, response, payload.c_str());
+                    handlePayload(fbdo, response, payload);
 
                     if (fbdo->session.rtdb.priority_val_flag)
                         fbdo->session.rtdb.path =
@@ -3101,12 +4261,12 @@ int FB_RTDB::getPayloadLen(firebase_rtdb_request_info_t *req)
             else if (req->data.type == d_json)
             {
                 FirebaseJson *json = addrTo<FirebaseJson *>(req->data.address.din);
-                len = strlen(json->raw());
+                len = json->serializedBufferLength();
             }
             else if (req->data.type == d_array)
             {
                 FirebaseJsonArray *arr = addrTo<FirebaseJsonArray *>(req->data.address.din);
-                len = req->pre_payload.length() + strlen(arr->raw()) + req->post_payload.length();
+                len = req->pre_payload.length() + arr->serializedBufferLength() + req->post_payload.length();
             }
         }
         else if (req->payload.length() > 0)
@@ -3167,8 +4327,7 @@ bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request
     {
         int p;
         if (req->data.address.din > 0 && req->data.type == d_json)
-            hasServerValue = Core.sh.find(addrTo<FirebaseJson *>(req->data.address.din)->raw(),
-                                          firebase_rtdb_pgm_str_17 /* "\".sv\"" */, false, 0, p);
+            hasServerValue = addrTo<FirebaseJson *>(req->data.address.din)->containsKey(pgm2Str(firebase_rtdb_pgm_str_41 /* ".sv" */));
         else
             hasServerValue = Core.sh.find(req->payload, firebase_rtdb_pgm_str_17 /* "\".sv\"" */, false, 0, p);
     }
@@ -3183,7 +4342,8 @@ bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request
     Core.ut.makePath(req->path);
     header += req->path;
 
-    if (req->method == http_patch || req->method == rtdb_update_nocontent)
+    // the root path already ends with "/"
+    if ((req->method == http_patch || req->method == rtdb_update_nocontent) && req->path.length() > 1)
         header += firebase_pgm_str_1; // "/"
 
     bool appendAuth = false;
@@ -3300,6 +4460,16 @@ bool FB_RTDB::sendRequestHeader(FirebaseData *fbdo, struct firebase_rtdb_request
         Core.hh.addNewLine(header);
     }
 
+    req->revalidate_etag.clear();
+    if (fbdo->session.rtdb.cache.revalidate >= 0 && req->method == http_get)
+    {
+        // kept for matching the entry when the response is read later
+        req->revalidate_etag = fbdo->session.rtdb.cache.entries[fbdo->session.rtdb.cache.revalidate].etag;
+        header += firebase_rtdb_pgm_str_42; // "If-None-Match: "
+        header += req->revalidate_etag;
+        Core.hh.addNewLine(header);
+    }
+
     if (fbdo->session.classic_request && http_method != http_get && http_method != http_post && http_method != http_patch)
     {
         header += firebase_rtdb_pgm_str_36; // "X-HTTP-Method-Override: "
@@ -3352,6 +4522,7 @@ void FB_RTDB::removeStreamCallback(FirebaseData *fbdo)
 
     fbdo->_dataAvailableCallback = NULL;
     fbdo->_timeoutCallback = NULL;
+    fbdo->session.rtdb.stream_queue.events.clear();
 
     if (Core.internal.sessions.size() == 0)
     {
@@ -38,6 +38,8 @@
 #include "./FB_Utils.h"
 #include "./session/FB_Session.h"
 #include "QueueInfo.h"
+#include "RTDBBatch.h"
+#include "RTDBAsyncPool.h"
 #include "./stream/FB_MP_Stream.h"
 #include "./stream/FB_Stream.h"
 
@@ -53,6 +55,8 @@ class FB_RTDB
 {
 
   friend class FIREBASE_CLASS;
+  friend class RTDBBatch;
+  friend class RTDBAsyncPool;
 
 #if defined(ENABLE_ERROR_QUEUE) || defined(FIREBASE_ENABLE_ERROR_QUEUE)
 #if !defined(ESP32) && !defined(ESP8266) && !defined(MB_ARDUINO_PICO)
@@ -1586,6 +1590,27 @@ public:
                         _IS_ASYNC, _NO_QUEUE, _NO_BLOB_SIZE, toStringPtr(_NO_FILE));
   }
 
+  /** Assign the Firebase Data Object used to send the batched writes of the RTDBBatch object.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param batch The pointer to RTDBBatch object.
+   *
+   * @note The batched writes are sent as a single multi-location update (silent patch) at the root node,
+   * the update is atomic then all writes in the batch are either succeeded or failed together.
+   * The Firebase Data Object should not be used for stream.
+   */
+  void beginBatch(FirebaseData *fbdo, RTDBBatch *batch);
+
+  /** Assign the RTDBAsyncPool object to send its requests.
+   *
+   * @param pool The pointer to RTDBAsyncPool object.
+   *
+   * @note The requests of the pool are sent and their responses are read in RTDBAsyncPool.run() without blocking,
+   * one request is sent at a time through each Firebase Data Object that was added to the pool
+   * unless the pipelining was enabled with RTDBAsyncPool.setPipeline.
+   */
+  void beginAsync(RTDBAsyncPool *pool);
+
   /** Read generic type of value at the defined node.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -2238,6 +2263,38 @@ public:
                                   FirebaseData::StreamTimeoutCallback timeoutCallback = NULL);
 #endif
 
+  /** Subscribe the child path of the multiple paths stream.
+   * The stream event is sent only to the subscribers of the changed paths, with the child value
+   * already extracted from the event data.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param childPath The child path relative to the parent path of beginMultiPathStream.
+   * @param callback The Callback function for this child path (optional).
+   * The multiPathDataCallback of setMultiPathStreamCallback will be used when not assigned.
+   *
+   * @note setMultiPathStreamCallback is still required to run the stream.
+   *
+   * In the callback, [MultiPathStreamData object].dataPath, [MultiPathStreamData object].value and
+   * [MultiPathStreamData object].type are already set, and [MultiPathStreamData object].get returns true
+   * only for the subscribed child path.
+   *
+   * The value is null when the put event replaced the parent node and the child no longer exists.
+   * The subscriber above the node changed by the patch event gets the patch data of its own path.
+   *
+   * The subscriptions can be added or cleared in the callback, the remaining subscribers of that event are skipped.
+   */
+  template <typename T = const char *>
+  void addMultiPathStreamChild(FirebaseData *fbdo, T childPath, FirebaseData::MultiPathStreamEventCallback callback = NULL)
+  {
+    mAddMultiPathStreamChild(fbdo, toStringPtr(childPath), callback);
+  }
+
+  /** Remove all child path subscriptions of the multiple paths stream.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   */
+  void clearMultiPathStreamChildren(FirebaseData *fbdo);
+
   /** Remove stream callback functions.
    *
    * @param fbdo The pointer to Firebase Data Object.
@@ -2250,6 +2307,71 @@ public:
    */
   void removeMultiPathStreamCallback(FirebaseData *fbdo);
 
+  /** Set the stream event queue between the stream reading and the stream callbacks.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param size The maximum queued events (0 - 255), 0 to call the stream callback while reading the stream (default).
+   * @param mode The enum of firebase_stream_coalesce_mode for the events of the same path e.g.
+   * firebase_stream_coalesce_none, firebase_stream_coalesce_keep_latest and firebase_stream_coalesce_merge_patch.
+   * @param dispatchCount The maximum events sent to the stream callback in each stream loop (1 - 255).
+   *
+   * @note The stream data is read before the queued events are sent to the stream callback, a slow callback will not
+   * cause the stream to time out. When the queue is full, the oldest put or patch event is dropped.
+   */
+  void setStreamQueue(FirebaseData *fbdo, uint8_t size,
+                      firebase_stream_coalesce_mode mode = firebase_stream_coalesce_none, uint8_t dispatchCount = 1);
+
+  /** Get the number of stream events dropped because the stream event queue was full.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return The number of dropped events.
+   */
+  uint32_t getStreamQueueDropped(FirebaseData *fbdo);
+
+  /** Get the number of stream events that were replaced or merged by the later event of the same path.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return The number of coalesced events.
+   */
+  uint32_t getStreamQueueCoalesced(FirebaseData *fbdo);
+
+  /** Enable the response cache of the get functions.
+   *
+   * The cached node is revalidated with its ETag (If-None-Match) and the payload is not downloaded again when
+   * the server responds with 304 Not Modified.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param maxEntries The maximum number of the cached nodes (0 - 255), 0 to disable and clear the cache.
+   * @param maxBytes Optional. The maximum total size of the cached payloads.
+   * @param storageType Optional. The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd
+   * to keep the cached payloads in files, the default mem_storage_type_undefined keeps them in RAM.
+   *
+   * @note Only the get functions without query, blob and file data are cached.
+   */
+  void setResponseCache(FirebaseData *fbdo, uint8_t maxEntries, size_t maxBytes = FIREBASE_RTDB_CACHE_DEFAULT_BYTES,
+                        firebase_mem_storage_type storageType = mem_storage_type_undefined);
+
+  /** Get the number of the get requests that were served from the response cache.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return The number of cache hits.
+   */
+  uint32_t getResponseCacheHits(FirebaseData *fbdo);
+
+  /** Get the number of the cacheable get requests that the payload was downloaded.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return The number of cache misses.
+   */
+  uint32_t getResponseCacheMisses(FirebaseData *fbdo);
+
+  /** Get the total size of the payloads that were served from the response cache instead of downloading.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return The number of saved bytes.
+   */
+  uint32_t getResponseCacheSavedBytes(FirebaseData *fbdo);
+
   /** Run stream manually.
    * To manually triggering the stream callback function, this should call repeatedly in loop().
    */
@@ -2593,6 +2715,7 @@ public:
 
 private:
   void rescon(FirebaseData *fbdo, const char *host, firebase_rtdb_request_info_t *req);
+  bool isNewSessionRequired(FirebaseData *fbdo, const char *host, firebase_rtdb_request_info_t *req);
   void clearDataStatus(FirebaseData *fbdo);
   bool handleRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
   bool sendRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
@@ -2606,12 +2729,29 @@ private:
   int openFile(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, mb_fs_open_mode mode, bool closeSession = false);
   void waitRxReady(FirebaseData *fbdo, unsigned long &dataTime);
   void parsePayload(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, struct server_response_data_t &response,
-                    MB_String payload);
+                    MB_String &payload);
   void handlePayload(FirebaseData *fbdo, struct server_response_data_t &response, const MB_String &payload);
   bool processRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
   bool encodeFileToClient(FirebaseData *fbdo, size_t bufSize, const MB_String &filePath,
                           firebase_mem_storage_type storageType, struct firebase_rtdb_request_info_t *req);
   void setPtrValue(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
+  bool mFlushBatch(FirebaseData *fbdo, RTDBBatch *batch);
+  firebase_rtdb_async_status mSendAsync(FirebaseData *fbdo, struct firebase_rtdb_async_request_t *item,
+                                        RTDB_AsyncResultInfo &info, bool pipelined);
+  bool mCompleteAsync(FirebaseData *fbdo, struct firebase_rtdb_async_request_t *item, RTDB_AsyncResultInfo &info,
+                      bool &keepAlive);
+  void mAbortAsync(FirebaseData *fbdo);
+  void setAsyncResult(FirebaseData *fbdo, struct firebase_rtdb_async_request_t *item, RTDB_AsyncResultInfo &info,
+                      bool ret);
+  bool isCacheableRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
+  void prepareCachedRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
+  void matchCachedRequest(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req);
+  bool readCachedResponse(FirebaseData *fbdo, struct server_response_data_t &response, MB_String &payload);
+  void storeCachedResponse(FirebaseData *fbdo, struct firebase_rtdb_request_info_t *req,
+                           struct server_response_data_t &response, const MB_String &payload);
+  void removeCacheEntry(FirebaseData *fbdo, size_t index);
+  void clearResponseCache(FirebaseData *fbdo);
+  void cacheFileName(MB_String &filename, uint16_t id);
   bool buildRequest(FirebaseData *fbdo, firebase_request_method method, MB_StringPtr path, MB_StringPtr payload,
                     firebase_data_type type, int subtype, uint32_t value_addr, uint32_t query_addr, uint32_t priority_addr,
                     MB_StringPtr etag, bool async, bool queue, size_t blob_size, MB_StringPtr filename,
@@ -2658,8 +2798,19 @@ private:
   int handleRedirect(FirebaseData *fbdo, firebase_rtdb_request_info_t *req, struct firebase_tcp_response_handler_t &tcpHandler,
                      struct server_response_data_t &response);
   void sendCB(FirebaseData *fbdo);
-  void splitStreamPayload(const MB_String &payloads, MB_VECTOR<MB_String> &payload);
-  void parseStreamPayload(FirebaseData *fbdo, const MB_String &payload);
+  void deliverCB(FirebaseData *fbdo);
+  void mAddMultiPathStreamChild(FirebaseData *fbdo, MB_StringPtr childPath, FirebaseData::MultiPathStreamEventCallback callback);
+  int findPathNode(FirebaseData *fbdo, int parent, const char *name, size_t len);
+  void dispatchMultiPathStream(FirebaseData *fbdo);
+  bool dispatchMultiPathChildren(FirebaseData *fbdo, int node, MB_JSON *item, uint16_t version);
+  bool dispatchMultiPathPatch(FirebaseData *fbdo, int node, const char *key, MB_JSON *value, uint16_t version);
+  bool sendMultiPathCB(FirebaseData *fbdo, int node, MB_JSON *item, uint16_t version);
+  void queueStreamEvent(FirebaseData *fbdo);
+  void dispatchStreamQueue(FirebaseData *fbdo);
+  bool mergeStreamJson(MB_String &dest, const MB_String &src);
+  void setStreamJsonPath(MB_JSON *obj, const char *path, MB_JSON *value);
+  bool parseStreamPayloads(FirebaseData *fbdo, const MB_String &payloads);
+  void parseStreamPayload(FirebaseData *fbdo, const char *type, int typeLen, const char *data, int dataLen);
   void storeToken(MB_String &atok, const char *databaseSecret);
   void restoreToken(MB_String &atok, firebase_auth_token_type tk);
   bool mSetQueryIndex(FirebaseData *fbdo, MB_StringPtr path, MB_StringPtr node, MB_StringPtr databaseSecret);
@@ -2688,12 +2839,13 @@ private:
 #endif
 
   uint8_t openErrorQueue(FirebaseData *fbdo, MB_StringPtr filename, firebase_mem_storage_type storageType, uint8_t mode);
-#if (defined(MBFS_FLASH_FS) || defined(MBFS_SD_FS)) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
-  uint8_t readQueueFile(FirebaseData *fbdo, fs::File &file, QueueItem &item, uint8_t mode);
-#endif
-#if defined(MBFS_ESP32_SDFAT_ENABLED)
-  uint8_t readQueueFileSdFat(FirebaseData *fbdo, MBFS_SD_FILE &file, QueueItem &item, uint8_t mode);
-#endif
+  bool readQueueHeader(firebase_mem_storage_type storageType, uint32_t &baseLen, uint16_t &count);
+  bool writeCompactedQueue(FirebaseData *fbdo, const MB_String &filename, firebase_mem_storage_type storageType);
+  bool writeQueueHeader(firebase_mem_storage_type storageType, uint32_t baseLen, uint16_t count);
+  bool readQueueRecord(firebase_mem_storage_type storageType, uint32_t &pos, uint32_t size, uint8_t &kind,
+                       QueueItem &item, bool full);
+  bool writeQueueRecord(firebase_mem_storage_type storageType, uint8_t kind, const QueueItem &item);
+  size_t queueRecordSize(uint8_t kind, const QueueItem &item);
 
 #endif
 
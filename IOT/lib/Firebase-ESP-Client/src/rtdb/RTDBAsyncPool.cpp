@@ -0,0 +1,346 @@
+/**
+ * Google's Firebase RTDBAsyncPool class, RTDBAsyncPool.cpp version 1.0.0
+ *
+ * Created October 19, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_RTDB_ASYNC_POOL_CPP
+#define FIREBASE_RTDB_ASYNC_POOL_CPP
+
+#include "RTDBAsyncPool.h"
+#include "FB_RTDB.h"
+
+RTDBAsyncPool::RTDBAsyncPool()
+{
+}
+
+RTDBAsyncPool::~RTDBAsyncPool()
+{
+    clear();
+}
+
+bool RTDBAsyncPool::addConnection(FirebaseData *fbdo)
+{
+    // the connection index is stored in int8_t
+    if (!fbdo || _conns.size() >= 127)
+        return false;
+
+    for (size_t i = 0; i < _conns.size(); i++)
+    {
+        if (_conns[i] == fbdo)
+            return false;
+    }
+
+    _conns.push_back(fbdo);
+    _serial.push_back(0);
+    return true;
+}
+
+void RTDBAsyncPool::setMaxQueue(uint8_t size)
+{
+    _maxQueue = size > 0 ? size : 1;
+}
+
+void RTDBAsyncPool::setPipeline(uint8_t depth)
+{
+    _pipeline = depth > FIREBASE_RTDB_ASYNC_MAX_PIPELINE ? FIREBASE_RTDB_ASYNC_MAX_PIPELINE : (depth > 0 ? depth : 1);
+
+    for (size_t i = 0; i < _serial.size(); i++)
+        _serial[i] = 0;
+}
+
+firebase_rtdb_async_status RTDBAsyncPool::status(uint32_t id)
+{
+    for (size_t i = 0; i < _requests.size(); i++)
+    {
+        if (_requests[i].id == id)
+            return _requests[i].conn < 0 ? firebase_rtdb_async_status_queued : firebase_rtdb_async_status_sent;
+    }
+
+    for (size_t i = 0; i < _results.size(); i++)
+    {
+        if (_results[i].id == id)
+            return _results[i].status;
+    }
+
+    return firebase_rtdb_async_status_unknown;
+}
+
+bool RTDBAsyncPool::getResult(uint32_t id, RTDB_AsyncResultInfo &info)
+{
+    for (size_t i = 0; i < _results.size(); i++)
+    {
+        if (_results[i].id == id)
+        {
+            info = _results[i];
+            _results.erase(_results.begin() + i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RTDBAsyncPool::run()
+{
+    if (!_rtdb)
+        return;
+
+    // complete the sent requests in which their responses are available, in the order they were sent
+    for (size_t c = 0; c < _conns.size(); c++)
+    {
+        int head = headIndex(c);
+
+        while (head >= 0)
+        {
+            RTDB_AsyncResultInfo info;
+            bool keepAlive = false;
+
+            if (!_rtdb->mCompleteAsync(_conns[c], &_requests[head], info, keepAlive))
+                break;
+
+            // the cached payload of 304 response was lost, send the request again without If-None-Match
+            if (_requests[head].req.resend)
+            {
+                _requests[head].req.resend = false;
+                _requests[head].conn = -1;
+            }
+            else
+                complete(head, info);
+
+            // the remaining pipelined requests will not be answered through this connection
+            if (!keepAlive && sentCount(c) > 0)
+            {
+                _rtdb->mAbortAsync(_conns[c]);
+                requeue(c);
+            }
+
+            head = headIndex(c);
+        }
+    }
+
+    // send the queued requests through the available connections
+    size_t i = 0;
+    while (i < _requests.size())
+    {
+        if (_requests[i].conn >= 0)
+        {
+            i++;
+            continue;
+        }
+
+        int8_t conn = selectConnection(_requests[i]);
+        if (conn < 0)
+            break;
+
+        bool pipelined = sentCount(conn) > 0;
+
+        RTDB_AsyncResultInfo info;
+        firebase_rtdb_async_status ret = _rtdb->mSendAsync(_conns[conn], &_requests[i], info, pipelined);
+
+        if (ret == firebase_rtdb_async_status_sent)
+        {
+            _requests[i].conn = conn;
+            _requests[i].sentMillis = millis();
+            _requests[i].seq = ++_seq;
+            i++;
+        }
+        else if (ret == firebase_rtdb_async_status_error)
+        {
+            // the session was closed, send all requests of this connection again one at a time
+            if (pipelined)
+                requeue(conn);
+            else
+                complete(i, info);
+        }
+        // the token or network is not ready, keep the requests queued
+        else
+            break;
+    }
+}
+
+void RTDBAsyncPool::clear()
+{
+    for (size_t i = 0; i < _requests.size(); i++)
+    {
+        // the response of the aborted request should not be read by the next request
+        if (_rtdb && _requests[i].conn >= 0)
+            _rtdb->mAbortAsync(_conns[_requests[i].conn]);
+    }
+
+    _requests.clear();
+    _results.clear();
+}
+
+uint32_t RTDBAsyncPool::addRequest(firebase_request_method method, MB_StringPtr path, MB_String *payload,
+                                   RTDB_AsyncResultCallback callback)
+{
+    if (_requests.size() >= _maxQueue)
+        return 0;
+
+    struct firebase_rtdb_async_request_t item;
+
+    // 0 is invalid id
+    if (++_nextId == 0)
+        _nextId++;
+
+    item.id = _nextId;
+    item.callback = callback;
+    item.req.path = path;
+    Core.ut.makePath(item.req.path);
+    item.req.method = method;
+    item.req.deferred = true;
+
+    if (payload)
+    {
+        // the JSON value text is sent as it is
+        item.req.data.type = d_json;
+        item.req.payload = *payload;
+    }
+    else
+        item.req.data.type = d_any;
+
+    _requests.push_back(item);
+
+    return item.id;
+}
+
+void RTDBAsyncPool::complete(size_t index, RTDB_AsyncResultInfo &info)
+{
+    RTDB_AsyncResultCallback callback = _requests[index].callback;
+
+    info.id = _requests[index].id;
+    info.path = _requests[index].req.path;
+
+    _requests.erase(_requests.begin() + index);
+
+    if (callback)
+    {
+        callback(info);
+        return;
+    }
+
+    if (_results.size() >= _maxQueue)
+        _results.erase(_results.begin());
+
+    _results.push_back(info);
+}
+
+int8_t RTDBAsyncPool::selectConnection(const struct firebase_rtdb_async_request_t &item)
+{
+    int8_t conn = -1;
+    size_t min = 0;
+
+    for (size_t c = 0; c < _conns.size(); c++)
+    {
+        size_t count = sentCount(c);
+
+        // the requests of the failed connection are sent again, then only the idempotent requests
+        // can share the connection, the push and update are sent to the idle connection only
+        if (count > 0 && (count >= _pipeline || _serial[c] || !isIdempotent(item.req.method) || hasNonIdempotent(c)))
+            continue;
+
+        if (conn < 0 || count < min)
+        {
+            conn = c;
+            min = count;
+        }
+    }
+
+    return conn;
+}
+
+bool RTDBAsyncPool::hasNonIdempotent(int8_t conn)
+{
+    for (size_t i = 0; i < _requests.size(); i++)
+    {
+        if (_requests[i].conn == conn && !isIdempotent(_requests[i].req.method))
+            return true;
+    }
+    return false;
+}
+
+size_t RTDBAsyncPool::sentCount(int8_t conn)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < _requests.size(); i++)
+    {
+        if (_requests[i].conn == conn)
+            count++;
+    }
+    return count;
+}
+
+int RTDBAsyncPool::headIndex(int8_t conn)
+{
+    int head = -1;
+    for (size_t i = 0; i < _requests.size(); i++)
+    {
+        if (_requests[i].conn == conn && (head < 0 || _requests[i].seq < _requests[head].seq))
+            head = i;
+    }
+    return head;
+}
+
+void RTDBAsyncPool::requeue(int8_t conn)
+{
+    size_t i = 0;
+    while (i < _requests.size())
+    {
+        if (_requests[i].conn != conn)
+        {
+            i++;
+            continue;
+        }
+
+        // the push or update may be already applied by the server, sending it again could duplicate it
+        if (!isIdempotent(_requests[i].req.method))
+        {
+            RTDB_AsyncResultInfo info;
+            info.status = firebase_rtdb_async_status_error;
+            info.httpCode = FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+            Core.errorToString(info.httpCode, info.errorMsg);
+            complete(i, info);
+            continue;
+        }
+
+        _requests[i].conn = -1;
+        i++;
+    }
+
+    _serial[conn] = 1;
+}
+
+bool RTDBAsyncPool::isIdempotent(firebase_request_method method)
+{
+    return method == http_get || method == http_put || method == http_delete;
+}
+
+#endif
+
+#endif // ENABLE
@@ -0,0 +1,268 @@
+
+/**
+ * Google's Firebase RTDBAsyncPool class, RTDBAsyncPool.h version 1.0.0
+ *
+ * Created October 19, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_RTDB_ASYNC_POOL_H
+#define FIREBASE_RTDB_ASYNC_POOL_H
+#include <Arduino.h>
+#include "./FB_Utils.h"
+#include "./core/FirebaseCore.h"
+
+using namespace mb_string;
+
+class FB_RTDB;
+class FirebaseData;
+
+/* Sends the requests without waiting for their responses and completes them through the callback or poll,
+ * the requests are distributed over the pool of Firebase Data Objects.
+ * The server connection, TLS handshake and request writing are still blocking, as the reading of the response
+ * payload once its first bytes are available */
+class RTDBAsyncPool
+{
+    friend class FB_RTDB;
+
+public:
+    RTDBAsyncPool();
+    ~RTDBAsyncPool();
+
+    /** Add the Firebase Data Object to the pool of connections.
+     *
+     * @param fbdo The pointer to Firebase Data Object.
+     * @return Boolean value, indicates the connection was added.
+     *
+     * @note The Firebase Data Object in the pool should not be used for other requests or stream.
+     */
+    bool addConnection(FirebaseData *fbdo);
+
+    /** Set the maximum number of the queued requests and the kept results (1 - 255).
+     *
+     * @param size The maximum number of the queued requests and the kept results.
+     *
+     * @note When the results are full, the oldest result is removed.
+     */
+    void setMaxQueue(uint8_t size);
+
+    /** Set the number of requests that can be sent back to back through each connection
+     * before their responses were read (HTTP/1.1 pipelining).
+     *
+     * @param depth The number of the pipelined requests (1 - 8), 1 for sending one request at a time.
+     *
+     * @note Only the idempotent requests (get, set and delete) are pipelined, the update and push requests
+     * are sent when there is no other request in flight on the connection and no request is sent behind them.
+     * The responses are matched to the requests in the order they were sent.
+     * When the server closes the connection, sends the chunked response or the response was failed,
+     * the pipelined requests that were not answered are sent again and the connection falls back to send
+     * one request at a time until the pipeline depth was set again. The unanswered update or push is
+     * completed with firebase_rtdb_async_status_error instead, it may have been applied by the server.
+     */
+    void setPipeline(uint8_t depth);
+
+    /** Queue the request to read the value at the defined node.
+     *
+     * @param path The path to the node.
+     * @param callback The optional callback function that accepts RTDB_AsyncResultInfo data.
+     * @return The request id or 0 if the request can't be queued.
+     */
+    template <typename T = const char *>
+    uint32_t get(T path, RTDB_AsyncResultCallback callback = NULL)
+    {
+        return addRequest(http_get, toStringPtr(path), nullptr, callback);
+    }
+
+    /** Queue the request to set the value at the defined node.
+     *
+     * @param path The path to the node.
+     * @param value The integer, float, double, boolean, string, FirebaseJson* or FirebaseJsonArray* value to set.
+     * @param callback The optional callback function that accepts RTDB_AsyncResultInfo data.
+     * @return The request id or 0 if the request can't be queued.
+     */
+    template <typename T1 = const char *, typename T2 = int>
+    uint32_t set(T1 path, T2 value, RTDB_AsyncResultCallback callback = NULL)
+    {
+        MB_String payload;
+        return makeValue(payload, value) ? addRequest(http_put, toStringPtr(path), &payload, callback) : 0;
+    }
+
+    /** Queue the request to update the child nodes of the defined node.
+     *
+     * @param path The path to the node in which child nodes will be updated.
+     * @param json The pointer to FirebaseJson object used for the update.
+     * @param callback The optional callback function that accepts RTDB_AsyncResultInfo data.
+     * @return The request id or 0 if the request can't be queued.
+     */
+    template <typename T = const char *>
+    uint32_t update(T path, FirebaseJson *json, RTDB_AsyncResultCallback callback = NULL)
+    {
+        MB_String payload;
+        return makeValue(payload, json) ? addRequest(http_patch, toStringPtr(path), &payload, callback) : 0;
+    }
+
+    /** Queue the request to append the value to the defined node.
+     *
+     * @param path The path to the node.
+     * @param value The integer, float, double, boolean, string, FirebaseJson* or FirebaseJsonArray* value to push.
+     * @param callback The optional callback function that accepts RTDB_AsyncResultInfo data.
+     * @return The request id or 0 if the request can't be queued.
+     *
+     * @note The push key of the new node is the data of the result.
+     */
+    template <typename T1 = const char *, typename T2 = int>
+    uint32_t push(T1 path, T2 value, RTDB_AsyncResultCallback callback = NULL)
+    {
+        MB_String payload;
+        return makeValue(payload, value) ? addRequest(http_post, toStringPtr(path), &payload, callback) : 0;
+    }
+
+    /** Queue the request to delete the defined node.
+     *
+     * @param path The path to the node to be deleted.
+     * @param callback The optional callback function that accepts RTDB_AsyncResultInfo data.
+     * @return The request id or 0 if the request can't be queued.
+     */
+    template <typename T = const char *>
+    uint32_t deleteNode(T path, RTDB_AsyncResultCallback callback = NULL)
+    {
+        return addRequest(http_delete, toStringPtr(path), nullptr, callback);
+    }
+
+    /** Get the status of the request.
+     *
+     * @param id The request id.
+     * @return The firebase_rtdb_async_status enum value.
+     *
+     * @note The status of the request in which its result was read or removed is firebase_rtdb_async_status_unknown.
+     */
+    firebase_rtdb_async_status status(uint32_t id);
+
+    /** Get the result of the completed request.
+     *
+     * @param id The request id.
+     * @param info The RTDB_AsyncResultInfo data to get the result.
+     * @return Boolean value, indicates the result is available.
+     *
+     * @note The result is removed from the pool after it was read.
+     * The result of the request that was queued with the callback function is not kept.
+     */
+    bool getResult(uint32_t id, RTDB_AsyncResultInfo &info);
+
+    /** Get the number of the queued and sent requests.
+     *
+     * @return The number of the requests that are not complete.
+     */
+    size_t pending() { return _requests.size(); }
+
+    /** Send the queued requests and read the available responses, this should call repeatedly in loop().
+     *
+     * @note This does not wait for the response that is not yet available.
+     * It blocks while the connection is opened (DNS, TCP connect and TLS handshake, up to the socket connection
+     * timeout), while the request is written and while the whole response is read after its first bytes
+     * were available (up to the server response timeout).
+     */
+    void run();
+
+    /** Remove all queued requests and results, the sent requests are aborted.
+     */
+    void clear();
+
+private:
+    FB_RTDB *_rtdb = nullptr;
+    MB_VECTOR<FirebaseData *> _conns;
+    // the connections that fell back to send one request at a time
+    MB_VECTOR<uint8_t> _serial;
+    MB_VECTOR<struct firebase_rtdb_async_request_t> _requests;
+    MB_VECTOR<RTDB_AsyncResultInfo> _results;
+    uint8_t _maxQueue = FIREBASE_RTDB_ASYNC_DEFAULT_QUEUE;
+    uint8_t _pipeline = 1;
+    uint32_t _nextId = 0;
+    uint32_t _seq = 0;
+
+    uint32_t addRequest(firebase_request_method method, MB_StringPtr path, MB_String *payload, RTDB_AsyncResultCallback callback);
+    void complete(size_t index, RTDB_AsyncResultInfo &info);
+    int8_t selectConnection(const struct firebase_rtdb_async_request_t &item);
+    size_t sentCount(int8_t conn);
+    bool hasNonIdempotent(int8_t conn);
+    int headIndex(int8_t conn);
+    void requeue(int8_t conn);
+    bool isIdempotent(firebase_request_method method);
+
+    template <typename T>
+    auto makeValue(MB_String &out, T value) -> typename mb_string::enable_if<is_num_int<T>::value || mb_string::is_bool<T>::value, bool>::type
+    {
+        out = toStringPtr(value, -1);
+        return true;
+    }
+
+    template <typename T>
+    auto makeValue(MB_String &out, T value) -> typename mb_string::enable_if<mb_string::is_same<T, float>::value, bool>::type
+    {
+        out = toStringPtr(value, getPrec(false));
+        return true;
+    }
+
+    template <typename T>
+    auto makeValue(MB_String &out, T value) -> typename mb_string::enable_if<mb_string::is_same<T, double>::value, bool>::type
+    {
+        out = toStringPtr(value, getPrec(true));
+        return true;
+    }
+
+    template <typename T>
+    auto makeValue(MB_String &out, T value) -> typename mb_string::enable_if<mb_string::is_string<T>::value, bool>::type
+    {
+        Core.jh.appendQuoted(out, MB_String(toStringPtr(value)).c_str());
+        return true;
+    }
+
+    bool makeValue(MB_String &out, FirebaseJson *json)
+    {
+        if (json)
+            out = json->raw();
+        return json != nullptr;
+    }
+
+    bool makeValue(MB_String &out, FirebaseJsonArray *arr)
+    {
+        if (arr)
+            out = arr->raw();
+        return arr != nullptr;
+    }
+
+    int getPrec(bool dbl)
+    {
+        if (Core.getCfg())
+            return dbl ? Core.internal.fb_double_digits : Core.internal.fb_float_digits;
+        return dbl ? 9 : 5;
+    }
+};
+
+#endif
+
+#endif // ENABLE
@@ -0,0 +1,299 @@
+/**
+ * Google's Firebase RTDBBatch class, RTDBBatch.cpp version 1.0.0
+ *
+ * Created October 19, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_RTDB_BATCH_CPP
+#define FIREBASE_RTDB_BATCH_CPP
+
+#include "RTDBBatch.h"
+#include "FB_RTDB.h"
+
+RTDBBatch::RTDBBatch()
+{
+}
+
+RTDBBatch::~RTDBBatch()
+{
+    clear();
+}
+
+void RTDBBatch::setMaxSize(uint8_t size)
+{
+    _maxSize = size > 0 ? size : 1;
+}
+
+void RTDBBatch::setWindow(uint32_t ms)
+{
+    _window = ms;
+}
+
+void RTDBBatch::setResultCallback(RTDB_BatchResultCallback callback)
+{
+    _resultCallback = callback;
+}
+
+bool RTDBBatch::flush()
+{
+    if (!_rtdb || !_fbdo)
+        return false;
+
+    return _rtdb->mFlushBatch(_fbdo, this);
+}
+
+void RTDBBatch::run()
+{
+    if (windowElapsed())
+        flush();
+}
+
+void RTDBBatch::clear()
+{
+    _paths.clear();
+    _values.clear();
+}
+
+bool RTDBBatch::mSet(MB_StringPtr path, MB_StringPtr value, bool isString)
+{
+    MB_String _path = path, _value;
+
+    if (isString)
+        Core.jh.appendQuoted(_value, MB_String(value).c_str());
+    else
+        _value = value;
+
+    return addValue(_path, _value);
+}
+
+bool RTDBBatch::mUpdate(MB_StringPtr path, const char *raw)
+{
+    MB_JSON *json = MB_JSON_Parse(raw);
+
+    if (!json || !MB_JSON_IsObject(json))
+    {
+        if (json)
+            MB_JSON_Delete(json);
+        return false;
+    }
+
+    MB_String _path = path;
+    makePath(_path);
+
+    bool ret = true;
+    MB_JSON *item = json->child;
+
+    // the update of the child nodes is the set of each child node
+    while (item && ret)
+    {
+        MB_String childPath = _path;
+        if (childPath.length() > 1)
+            childPath += '/';
+        childPath += item->string;
+
+        char *out = MB_JSON_PrintUnformatted(item);
+        if (out)
+        {
+            ret = addValue(childPath, out);
+            MB_JSON_free(out);
+        }
+
+        item = item->next;
+    }
+
+    MB_JSON_Delete(json);
+
+    return ret;
+}
+
+bool RTDBBatch::addValue(MB_String &path, const MB_String &value)
+{
+    makePath(path);
+
+    // the root node can't be a location of the multi-location update
+    if (path.length() < 2 || value.length() == 0)
+        return false;
+
+    if (windowElapsed())
+        flush();
+
+    for (size_t i = 0; i < _paths.size(); i++)
+    {
+        if (strcmp(_paths[i].c_str(), path.c_str()) == 0)
+        {
+            _values[i] = value;
+            return true;
+        }
+
+        if (isParentPath(_paths[i], path))
+            return mergeValue(_values[i], path.c_str() + _paths[i].length() + 1, value);
+    }
+
+    // the batched writes to the child nodes are replaced by this write
+    for (size_t i = _paths.size(); i > 0; i--)
+    {
+        if (isParentPath(path, _paths[i - 1]))
+            removeAt(i - 1);
+    }
+
+    if (_paths.size() >= _maxSize)
+    {
+        flush();
+
+        // the batch is still full from the connection issue
+        if (_paths.size() >= _maxSize)
+            return false;
+    }
+
+    if (_paths.size() == 0)
+        _firstMs = millis();
+
+    _paths.push_back(path);
+    _values.push_back(value);
+
+    if (_paths.size() >= _maxSize)
+        flush();
+
+    return true;
+}
+
+bool RTDBBatch::mergeValue(MB_String &dest, const char *relPath, const MB_String &value)
+{
+    MB_JSON *item = MB_JSON_Parse(value.c_str());
+    if (!item)
+        return false;
+
+    MB_JSON *root = MB_JSON_Parse(dest.c_str());
+
+    // the primitive value is replaced by the object that holds the child node
+    if (!root || !MB_JSON_IsObject(root))
+    {
+        if (root)
+            MB_JSON_Delete(root);
+        root = MB_JSON_CreateObject();
+    }
+
+    MB_JSON *parent = root;
+    MB_String key;
+    const char *p = relPath;
+
+    while (item)
+    {
+        const char *e = strchr(p, '/');
+        size_t len = e ? (size_t)(e - p) : strlen(p);
+
+        key.clear();
+        key.append(p, len);
+
+        if (!e)
+        {
+            if (MB_JSON_GetObjectItemCaseSensitive(parent, key.c_str()))
+                MB_JSON_ReplaceItemInObjectCaseSensitive(parent, key.c_str(), item);
+            else
+                MB_JSON_AddItemToObject(parent, key.c_str(), item);
+            item = nullptr;
+        }
+        else
+        {
+            if (len > 0)
+            {
+                MB_JSON *child = MB_JSON_GetObjectItemCaseSensitive(parent, key.c_str());
+                if (!child || !MB_JSON_IsObject(child))
+                {
+                    MB_JSON *obj = MB_JSON_CreateObject();
+                    if (child)
+                        MB_JSON_ReplaceItemInObjectCaseSensitive(parent, key.c_str(), obj);
+                    else
+                        MB_JSON_AddItemToObject(parent, key.c_str(), obj);
+                    child = obj;
+                }
+                parent = child;
+            }
+            p = e + 1;
+        }
+    }
+
+    bool ret = false;
+    char *out = MB_JSON_PrintUnformatted(root);
+    if (out)
+    {
+        dest = out;
+        MB_JSON_free(out);
+        ret = true;
+    }
+
+    MB_JSON_Delete(root);
+
+    return ret;
+}
+
+bool RTDBBatch::isParentPath(const MB_String &parent, const MB_String &child)
+{
+    size_t len = parent.length();
+    return child.length() > len && child[len] == '/' && strncmp(child.c_str(), parent.c_str(), len) == 0;
+}
+
+bool RTDBBatch::windowElapsed()
+{
+    return _window > 0 && _paths.size() > 0 && millis() - _firstMs >= _window;
+}
+
+void RTDBBatch::makePath(MB_String &path)
+{
+    Core.ut.makePath(path);
+
+    while (path.length() > 1 && path[path.length() - 1] == '/')
+        path.pop_back();
+}
+
+void RTDBBatch::getPayload(MB_String &payload)
+{
+    // {"path/to/node1":value1,"path/to/node2":value2}
+    payload = '{';
+
+    for (size_t i = 0; i < _paths.size(); i++)
+    {
+        if (i > 0)
+            payload += ',';
+        Core.jh.appendQuoted(payload, _paths[i].c_str() + 1);
+        payload += ':';
+        payload += _values[i];
+    }
+
+    payload += '}';
+}
+
+void RTDBBatch::removeAt(size_t index)
+{
+    _paths.erase(_paths.begin() + index);
+    _values.erase(_values.begin() + index);
+}
+
+#endif
+
+#endif // ENABLE
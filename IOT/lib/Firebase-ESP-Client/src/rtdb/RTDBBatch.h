@@ -0,0 +1,176 @@
+
+/**
+ * Google's Firebase RTDBBatch class, RTDBBatch.h version 1.0.0
+ *
+ * Created October 19, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2023 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "./FirebaseFS.h"
+
+#if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
+
+#ifndef FIREBASE_RTDB_BATCH_H
+#define FIREBASE_RTDB_BATCH_H
+#include <Arduino.h>
+#include "./FB_Utils.h"
+#include "./core/FirebaseCore.h"
+
+using namespace mb_string;
+
+class FB_RTDB;
+class FirebaseData;
+
+/* Collects the set and update writes and sends them as a single multi-location update (PATCH) at the root */
+class RTDBBatch
+{
+    friend class FB_RTDB;
+
+public:
+    RTDBBatch();
+    ~RTDBBatch();
+
+    /** Set the number of the batched writes that triggers the flush (1 - 255).
+     *
+     * @param size The maximum number of the batched writes.
+     */
+    void setMaxSize(uint8_t size);
+
+    /** Set the time window in milliseconds after the first batched write that triggers the flush.
+     *
+     * @param ms The time window in milliseconds or 0 to flush by size or flush() only.
+     *
+     * @note The time window is checked in set, update and run.
+     */
+    void setWindow(uint32_t ms);
+
+    /** Set the callback function that receives the result of each batched write when the batch was flushed.
+     *
+     * @param callback The callback function that accepts RTDB_BatchResultInfo data.
+     */
+    void setResultCallback(RTDB_BatchResultCallback callback);
+
+    /** Add the value to be set at the defined node to the batch.
+     *
+     * @param path The path to the node.
+     * @param value The integer, float, double, boolean or string value to set.
+     * @return Boolean value, indicates the value was added to the batch.
+     *
+     * @note The later write to the same node replaces the earlier one,
+     * the write to the child node of the node that is already in the batch is merged into its value
+     * and the write to the parent node replaces the batched writes to its child nodes.
+     */
+    template <typename T1 = const char *, typename T2 = int>
+    auto set(T1 path, T2 value) -> typename mb_string::enable_if<is_num_int<T2>::value || mb_string::is_bool<T2>::value, bool>::type
+    {
+        return mSet(toStringPtr(path), toStringPtr(value, -1), false);
+    }
+
+    template <typename T1 = const char *, typename T2 = float>
+    auto set(T1 path, T2 value) -> typename mb_string::enable_if<mb_string::is_same<T2, float>::value, bool>::type
+    {
+        return mSet(toStringPtr(path), toStringPtr(value, getPrec(false)), false);
+    }
+
+    template <typename T1 = const char *, typename T2 = double>
+    auto set(T1 path, T2 value) -> typename mb_string::enable_if<mb_string::is_same<T2, double>::value, bool>::type
+    {
+        return mSet(toStringPtr(path), toStringPtr(value, getPrec(true)), false);
+    }
+
+    template <typename T1 = const char *, typename T2 = const char *>
+    auto set(T1 path, T2 value) -> typename mb_string::enable_if<mb_string::is_string<T2>::value, bool>::type
+    {
+        return mSet(toStringPtr(path), toStringPtr(value), true);
+    }
+
+    template <typename T = const char *>
+    bool set(T path, FirebaseJson *json) { return json ? mSet(toStringPtr(path), toStringPtr(json->raw()), false) : false; }
+
+    template <typename T = const char *>
+    bool set(T path, FirebaseJsonArray *arr) { return arr ? mSet(toStringPtr(path), toStringPtr(arr->raw()), false) : false; }
+
+    /** Add the update (patch) of the child nodes of the defined node to the batch.
+     *
+     * @param path The path to the node in which child nodes will be updated.
+     * @param json The pointer to FirebaseJson object used for the update.
+     * @return Boolean value, indicates the child nodes were added to the batch.
+     */
+    template <typename T = const char *>
+    bool update(T path, FirebaseJson *json) { return json ? mUpdate(toStringPtr(path), json->raw()) : false; }
+
+    /** Send the batched writes.
+     *
+     * @return Boolean value, indicates the success of the operation.
+     *
+     * @note The batch should be assigned with Firebase.RTDB.beginBatch before use.
+     * The writes that were rejected by the server are removed from the batch while the writes
+     * that were failed from the connection issue are kept and sent again with the next flush.
+     */
+    bool flush();
+
+    /** Flush the batch when the time window was elapsed, this should call repeatedly in loop().
+     */
+    void run();
+
+    /** Get the number of the batched writes.
+     *
+     * @return The number of the batched writes.
+     */
+    size_t size() { return _paths.size(); }
+
+    /** Remove all batched writes without sending.
+     */
+    void clear();
+
+private:
+    FB_RTDB *_rtdb = nullptr;
+    FirebaseData *_fbdo = nullptr;
+    RTDB_BatchResultCallback _resultCallback = NULL;
+    MB_VECTOR<MB_String> _paths;
+    MB_VECTOR<MB_String> _values;
+    uint8_t _maxSize = FIREBASE_RTDB_BATCH_DEFAULT_SIZE;
+    uint32_t _window = FIREBASE_RTDB_BATCH_DEFAULT_WINDOW;
+    unsigned long _firstMs = 0;
+
+    bool mSet(MB_StringPtr path, MB_StringPtr value, bool isString);
+    bool mUpdate(MB_StringPtr path, const char *raw);
+    bool addValue(MB_String &path, const MB_String &value);
+    bool mergeValue(MB_String &dest, const char *relPath, const MB_String &value);
+    bool isParentPath(const MB_String &parent, const MB_String &child);
+    bool windowElapsed();
+    void makePath(MB_String &path);
+    void getPayload(MB_String &payload);
+    void removeAt(size_t index);
+
+    int getPrec(bool dbl)
+    {
+        if (Core.getCfg())
+            return dbl ? Core.internal.fb_double_digits : Core.internal.fb_float_digits;
+        return dbl ? 9 : 5;
+    }
+};
+
+#endif
+
+#endif // ENABLE
@@ -1,6 +1,6 @@
 
 /**
- * Google's Firebase MultiPathStream class, FB_MP_Stream.cpp version 1.1.7
+ * Google's Firebase MultiPathStream class, FB_MP_Stream.cpp version 1.1.8
  *
  * Created September 9, 2023
  *
@@ -50,6 +50,18 @@ void FIREBASE_MP_STREAM_CLASS::begin(struct firebase_stream_info_t *s)
 
 bool FIREBASE_MP_STREAM_CLASS::get(const String &path /* child path */)
 {
+    // the child value was dispatched from the subscription trie, no need to probe the data
+    if (dispatched)
+    {
+        const char *p = path.c_str();
+        const char *c = childPath.c_str();
+        if (p[0] == '/')
+            p++;
+        if (c[0] == '/')
+            c++;
+        return strcmp(p, c) == 0;
+    }
+
     value.remove(1, value.length());
     type.remove(1, type.length());
     dataPath.remove(1, dataPath.length());
@@ -128,6 +140,8 @@ void FIREBASE_MP_STREAM_CLASS::empty()
     type.remove(1, type.length());
     dataPath.remove(1, dataPath.length());
     sif->m_json = nullptr;
+    dispatched = false;
+    childPath.clear();
 }
 
 int FIREBASE_MP_STREAM_CLASS::payloadLength()
@@ -1,6 +1,6 @@
 
 /**
- * Google's Firebase MultiPathStream class, FB_MP_Stream.h version 1.1.7
+ * Google's Firebase MultiPathStream class, FB_MP_Stream.h version 1.1.8
  *
  * Created September 9, 2023
  *
@@ -56,6 +56,9 @@ public:
 
 private:
     struct firebase_stream_info_t *sif = nullptr;
+    // set when the value was already extracted for the subscribed child path
+    bool dispatched = false;
+    MB_String childPath;
     void begin(struct firebase_stream_info_t *s);
     void empty();
     bool checkPath(MB_String &root, MB_String &branch);
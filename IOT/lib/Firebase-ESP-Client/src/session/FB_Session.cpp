@@ -120,6 +120,23 @@ int FirebaseData::tcpSend(const char *s)
     return r;
 }
 
+int FirebaseData::tcpSend(FirebaseJson *json, size_t chunkSize)
+{
+    // serialize straight to socket, no intermediate copy of the JSON string
+    size_t len = json->serializedBufferLength();
+    int r = json->printTo(tcpClient, false, chunkSize) == len ? (int)len : -1;
+    setSession(false, r > 0);
+    return r;
+}
+
+int FirebaseData::tcpSend(FirebaseJsonArray *arr, size_t chunkSize)
+{
+    size_t len = arr->serializedBufferLength();
+    int r = arr->printTo(tcpClient, false, chunkSize) == len ? (int)len : -1;
+    setSession(false, r > 0);
+    return r;
+}
+
 int FirebaseData::tcpWrite(const uint8_t *data, size_t size)
 {
     int r = tcpClient.write(data, size);
@@ -571,6 +588,22 @@ void FirebaseData::setBSSLBufferSize(uint16_t rx, uint16_t tx)
         session.bssl_tx_size = tx;
 }
 
+#if defined(ESP_SSLCLIENT_HAS_CIPHER_PROFILES)
+void FirebaseData::setCipherProfile(esp_ssl_cipher_profile profile)
+{
+    if (session.cipher_profile != profile)
+        closeSession();
+    session.cipher_profile = profile;
+}
+#endif
+
+void FirebaseData::setAutoMFLN(uint16_t len)
+{
+    if (session.mfln_size != len)
+        closeSession();
+    session.mfln_size = len;
+}
+
 void FirebaseData::setResponseSize(uint16_t len)
 {
     if (len >= 1024)
@@ -826,6 +859,10 @@ void FirebaseData::setSecure()
     }
 
     tcpClient.setBufferSizes(session.bssl_rx_size, session.bssl_tx_size);
+    tcpClient.setMFLN(session.mfln_size, &Core.internal.mfln_hosts, &Core.internal.mfln_hosts_mutex);
+#if defined(ESP_SSLCLIENT_HAS_CIPHER_PROFILES)
+    tcpClient.setCipherProfile((esp_ssl_cipher_profile)session.cipher_profile);
+#endif
 
     if (tcpClient.certType == firebase_cert_type_undefined || session.cert_updated)
     {
@@ -836,7 +873,7 @@ void FirebaseData::setSecure()
             return;
         }
 
-        if (!Core.internal.fb_clock_rdy && (Core.config->cert.file.length() > 0 ||
+        if (!Core.internal.fb_clock_rdy && (Core.config->cert.file.length() > 0 || Core.config->cert.store ||
                                             Core.config->cert.data != NULL || session.cert_ptr > 0))
         {
             Core.timeBegin();
@@ -844,6 +881,16 @@ void FirebaseData::setSecure()
             tcpClient.clockReady = Core.internal.fb_clock_rdy;
         }
 
+#if defined(ESP_SSL_FS_SUPPORTED)
+        // the issuers are looked up from the store without parsing the PEM certificates
+        if (Core.config->cert.store)
+        {
+            tcpClient.setCertStore(Core.config->cert.store);
+            session.cert_updated = false;
+            return;
+        }
+#endif
+
         if (Core.config->cert.file.length() == 0)
         {
             if (session.cert_ptr > 0)
@@ -872,7 +919,7 @@ void FirebaseData::setCert(const char *ca)
     }
 }
 
-bool FirebaseData::tokenReady()
+bool FirebaseData::tokenReady(bool request)
 {
     if (Core.config)
     {
@@ -882,13 +929,17 @@ bool FirebaseData::tokenReady()
             return true;
     }
 
+    Core.swapRenewedToken();
+
     if (Core.isExpired())
     {
+        if (request)
+            Core.countRefreshStall();
         closeSession();
         return false;
     }
 
-    if (!Core.tokenReady())
+    if (!Core.tokenReady(request))
     {
         session.response.code = FIREBASE_ERROR_TOKEN_NOT_READY;
         closeSession();
@@ -958,8 +1009,6 @@ bool FirebaseData::readPayload(MB_String *chunkOut, struct firebase_tcp_response
 
             char *pChunk = reinterpret_cast<char *>(Core.mbfs.newP(tcpHandler.chunkBufSize + 1));
 
-            if (response.isChunkedEnc)
-                delay(1);
             // read the avilable data
             // chunk transfer encoding?
             if (response.isChunkedEnc)
@@ -1048,6 +1097,8 @@ bool FirebaseData::readResponse(MB_String *payload, struct firebase_tcp_response
 
                     if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK ||
                         response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT ||
+                        response.httpCode == FIREBASE_ERROR_HTTP_CODE_PARTIAL_CONTENT ||
+                        response.httpCode == FIREBASE_ERROR_HTTP_CODE_NOT_MODIFIED ||
                         response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT)
                         tcpHandler.error.code = 0;
 
@@ -1084,7 +1135,8 @@ bool FirebaseData::readResponse(MB_String *payload, struct firebase_tcp_response
     return true;
 }
 
-bool FirebaseData::prepareDownload(const MB_String &filename, firebase_mem_storage_type type, bool openFileInWrireMode)
+bool FirebaseData::prepareDownload(const MB_String &filename, firebase_mem_storage_type type, bool openFileInWrireMode,
+                                   bool append)
 {
     if (!Core.config)
         return false;
@@ -1092,14 +1144,15 @@ bool FirebaseData::prepareDownload(const MB_String &filename, firebase_mem_stora
 #if defined(ESP32_GT_2_0_1_FS_MEMORY_FIX)
     // Fix issue in ESP32 core v2.0.x filesystems
     // We can't open file (flash or sd) to write here because of truncated result, only append is ok.
-    // We have to remove existing file
-    Core.mbfs.remove(filename, mbfs_type type);
+    // We have to remove existing file unless the download continues from its end.
+    if (!append)
+        Core.mbfs.remove(filename, mbfs_type type);
 #else
     // File need to be opened in case non-RTDB class.
     // In RTDB class, it handles file opening differently.
     if (openFileInWrireMode)
     {
-        int ret = Core.mbfs.open(filename, mbfs_type type, mb_fs_open_mode_write);
+        int ret = Core.mbfs.open(filename, mbfs_type type, append ? mb_fs_open_mode_append : mb_fs_open_mode_write);
         if (ret < 0)
         {
             tcpClient.flush();
@@ -1111,10 +1164,13 @@ bool FirebaseData::prepareDownload(const MB_String &filename, firebase_mem_stora
     return true;
 }
 
-void FirebaseData::prepareDownloadOTA(struct firebase_tcp_response_handler_t &tcpHandler, struct server_response_data_t &response)
+void FirebaseData::prepareDownloadOTA(struct firebase_tcp_response_handler_t &tcpHandler, struct server_response_data_t &response,
+                                      size_t size)
 {
 #if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
-    int size = tcpHandler.decodedPayloadLen > 0 ? tcpHandler.decodedPayloadLen : response.contentLen;
+    // the size of the whole firmware when it is downloaded in ranges
+    if (size == 0)
+        size = tcpHandler.decodedPayloadLen > 0 ? tcpHandler.decodedPayloadLen : response.contentLen;
 #if defined(ESP32) || defined(MB_ARDUINO_PICO)
     tcpHandler.error.code = 0;
     if (!Update.begin(size))
@@ -1137,6 +1193,22 @@ void FirebaseData::endDownloadOTA(struct firebase_tcp_response_handler_t &tcpHan
 #endif
 }
 
+int FirebaseData::commitDownloadOTA(bool verified)
+{
+#if defined(OTA_UPDATE_ENABLED) && (defined(ESP32) || defined(ESP8266) || defined(MB_ARDUINO_PICO))
+
+    if (verified)
+        return Update.end() ? 0 : FIREBASE_ERROR_FW_UPDATE_END_FAILED;
+
+    // the unverified firmware is never committed
+#if defined(ESP32) || defined(MB_ARDUINO_PICO)
+    Update.abort();
+#endif
+
+#endif
+    return verified ? 0 : FIREBASE_ERROR_DOWNLOAD_CHECKSUM_MISMATCH;
+}
+
 bool FirebaseData::processDownload(const MB_String &filename, firebase_mem_storage_type type,
                                    uint8_t *buf, int bufLen, struct firebase_tcp_response_handler_t &tcpHandler,
                                    struct server_response_data_t &response, int &stage, bool isOTA)
@@ -181,6 +181,34 @@ public:
    */
   void setBSSLBufferSize(uint16_t rx, uint16_t tx);
 
+  /** Set the cipher suite order, ECDHE curves and buffer sizes of the BearSSL client together.
+   *
+   * @param profile The esp_ssl_cipher_profile enum value.
+   * esp_ssl_cipher_profile_throughput - ChaCha20-Poly1305 first, X25519/P-256 and the 16k receive buffer.
+   * esp_ssl_cipher_profile_low_ram - a few AEAD suites, X25519/P-256 and the 1k receive buffer.
+   * esp_ssl_cipher_profile_compat - all suites and curves and the 16k receive buffer.
+   * esp_ssl_cipher_profile_default - the default suites and curves with the setBSSLBufferSize sizes.
+   *
+   * @note The buffer sizes of the profile take precedence over setBSSLBufferSize.
+   * The profile is applied at the next connection.
+   */
+#if defined(ESP_SSLCLIENT_HAS_CIPHER_PROFILES)
+  void setCipherProfile(esp_ssl_cipher_profile profile);
+#endif
+
+  /** Negotiate the Max Fragment Length with the server to use the small BearSSL buffers.
+   *
+   * @param len The fragment length (512, 1024, 2048 or 4096), 0 to disable.
+   *
+   * @note Each host is probed once and the result is shared by all FirebaseData objects,
+   * the probe that fails before the server answered is repeated at the next connection.
+   * The token requests use config.signer.mflnSize.
+   * The receive buffer is sized to the fragment length when the host supports the negotiation,
+   * otherwise the full 16k receive buffer is used.
+   * This takes precedence over the buffer sizes of setBSSLBufferSize and setCipherProfile.
+   */
+  void setAutoMFLN(uint16_t len = 4096);
+
   /** Set the HTTP response size limit.
    *
    * @param len The server response buffer size limit.
@@ -768,6 +796,10 @@ private:
 #if defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB)
   StreamEventCallback _dataAvailableCallback = NULL;
   MultiPathStreamEventCallback _multiPathDataCallback = NULL;
+  MB_VECTOR<firebase_stream_path_node_t> _multiPathNodes;
+  MB_VECTOR<MultiPathStreamEventCallback> _multiPathChildCallbacks;
+  // changed when the child subscriptions changed, the dispatching stops when changed from the callback
+  uint16_t _multiPathVersion = 0;
   StreamTimeoutCallback _timeoutCallback = NULL;
   QueueInfoCallback _queueInfoCallback = NULL;
 #endif
@@ -833,9 +865,12 @@ private:
                    struct server_response_data_t &response);
   bool readResponse(MB_String *payload, struct firebase_tcp_response_handler_t &tcpHandler,
                     struct server_response_data_t &response);
-  bool prepareDownload(const MB_String &filename, firebase_mem_storage_type type, bool openFileInWrireMode = false);
-  void prepareDownloadOTA(struct firebase_tcp_response_handler_t &tcpHandler, struct server_response_data_t &response);
+  bool prepareDownload(const MB_String &filename, firebase_mem_storage_type type, bool openFileInWrireMode = false,
+                       bool append = false);
+  void prepareDownloadOTA(struct firebase_tcp_response_handler_t &tcpHandler, struct server_response_data_t &response,
+                          size_t size = 0);
   void endDownloadOTA(struct firebase_tcp_response_handler_t &tcpHandler);
+  int commitDownloadOTA(bool verified);
   bool processDownload(const MB_String &filename, firebase_mem_storage_type type, uint8_t *buf,
                        int bufLen, struct firebase_tcp_response_handler_t &tcpHandler, struct server_response_data_t &response,
                        int &stage, bool isOTA);
@@ -855,7 +890,7 @@ private:
   bool reconnect(unsigned long dataTime = 0);
   MB_String getDataType(uint8_t type);
   MB_String getMethod(uint8_t method);
-  bool tokenReady();
+  bool tokenReady(bool request = false);
   void setTimeout();
   void setSecure();
 #if defined(ENABLE_ERROR_QUEUE) || defined(FIREBASE_ENABLE_ERROR_QUEUE) && (defined(ENABLE_RTDB) || defined(FIREBASE_ENABLE_RTDB))
@@ -887,6 +922,8 @@ private:
   void addSession(firebase_con_mode mode);
   void setSession(bool remove, bool status);
   int tcpSend(const char *s);
+  int tcpSend(FirebaseJson *json, size_t chunkSize);
+  int tcpSend(FirebaseJsonArray *arr, size_t chunkSize);
   int tcpWrite(const uint8_t *data, size_t size);
   void addQueueSession();
   void removeQueueSession();
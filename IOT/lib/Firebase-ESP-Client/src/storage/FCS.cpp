@@ -64,7 +64,7 @@ bool FB_Storage::sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *req)
     if (!fbdo->reconnect())
         return false;
 
-    if (!Core.tokenReady())
+    if (!Core.tokenReady(true))
         return false;
 
     if (fbdo->session.long_running_task > 0)
@@ -105,7 +105,12 @@ bool FB_Storage::sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *req)
 
     Core.internal.fb_processing = true;
 
-    bool ret = fcs_sendRequest(fbdo, req);
+    bool ret = false;
+    if (req->requestType == firebase_fcs_request_type_download ||
+        req->requestType == firebase_fcs_request_type_download_ota)
+        ret = fcs_download(fbdo, req);
+    else
+        ret = fcs_sendRequest(fbdo, req);
 
     Core.internal.fb_processing = false;
 
@@ -349,6 +354,103 @@ void FB_Storage::reportDownloadProgress(FirebaseData *fbdo, struct firebase_fcs_
     }
 }
 
+bool FB_Storage::fcs_download(FirebaseData *fbdo, struct firebase_fcs_req_t *req)
+{
+    bool isOTA = req->requestType == firebase_fcs_request_type_download_ota;
+    bool ret = false;
+    uint8_t resume = 0;
+
+    // continue the interrupted file download from the local file
+    if (!isOTA)
+        Core.ut.loadDownloadRange(&Core.mbfs, req->localFileName, req->storageType, req->range);
+
+    ret = req->range.total > 0 && req->range.offset >= req->range.total;
+
+    while (!ret)
+    {
+        req->range.changed = false;
+
+        if (fcs_sendRequest(fbdo, req))
+        {
+            resume = 0;
+            // request the next range
+            ret = req->range.offset >= req->range.total;
+            if (!ret)
+                fcs_connect(fbdo);
+            continue;
+        }
+
+        // the object was changed, download it from the beginning unless the firmware was partly written
+        if (!(req->range.changed && !req->range.started) &&
+            !(Core.ut.isDownloadResumable(fbdo->session.response.code) && req->range.offset > 0))
+            break;
+
+        if (resume++ >= Core.config->fcs.download_max_resume)
+            break;
+
+        if (!isOTA)
+            Core.ut.saveDownloadRange(&Core.mbfs, req->localFileName, req->storageType, req->range);
+
+        delay(resume * 500);
+
+        if (!fbdo->reconnect())
+            break;
+
+        fcs_connect(fbdo);
+    }
+
+    if (ret && req->range.crc32c.length() == 0)
+    {
+        // the response has no x-goog-hash header, get the CRC32C from the object metadata
+        struct firebase_fcs_req_t meta;
+        meta.requestType = firebase_fcs_request_type_get_meta;
+        meta.bucketID = req->bucketID;
+        meta.remoteFileName = req->remoteFileName;
+        fcs_connect(fbdo);
+        if (fcs_sendRequest(fbdo, &meta))
+            req->range.crc32c = fbdo->session.fcs.meta.crc32;
+        fbdo->session.fcs.requestType = req->requestType;
+    }
+
+    if (ret && !Core.ut.checkDownloadRange(&Core.bh, &Core.mbfs, req->range, isOTA))
+    {
+        fbdo->session.response.code = FIREBASE_ERROR_DOWNLOAD_CHECKSUM_MISMATCH;
+        ret = false;
+    }
+
+    if (isOTA)
+    {
+        // the firmware is committed only when its CRC32C was verified
+        if (req->range.started)
+        {
+            int code = fbdo->commitDownloadOTA(ret);
+            if (code != 0)
+            {
+                fbdo->session.response.code = code;
+                ret = false;
+            }
+        }
+    }
+    else if (ret || fbdo->session.response.code == FIREBASE_ERROR_DOWNLOAD_CHECKSUM_MISMATCH)
+    {
+        if (!ret)
+            Core.mbfs.remove(req->localFileName, mbfs_type req->storageType);
+        Core.ut.removeDownloadRange(&Core.mbfs, req->localFileName, req->storageType);
+    }
+    else if (req->range.offset > 0)
+        Core.ut.saveDownloadRange(&Core.mbfs, req->localFileName, req->storageType, req->range);
+
+    if (ret)
+    {
+        FCS_DownloadStatusInfo in;
+        makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_fcs_download_status_complete,
+                           100, req->fileSize, 0, "");
+        sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
+    }
+
+    return ret;
+}
+
 bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *req)
 {
 
@@ -421,6 +523,10 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *
 
     Core.hh.addGAPIsHostHeader(header, firebase_storage_ss_pgm_str_1 /* "firebasestorage." */);
 
+    if ((req->requestType == firebase_fcs_request_type_download || req->requestType == firebase_fcs_request_type_download_ota) &&
+        (req->range.offset > 0 || Core.config->fcs.download_range_size > 0))
+        Core.hh.addRangeHeader(header, req->range.offset, Core.config->fcs.download_range_size);
+
     if (!Core.config->signer.test_mode)
     {
         Core.hh.addAuthHeaderFirst(header, Core.getTokenType());
@@ -537,17 +643,11 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *
             if (req->requestType == firebase_fcs_request_type_download)
                 Core.mbfs.close(mbfs_type req->storageType);
 
+            // the download complete status is sent after the object was verified
             if (res)
             {
-                if (req->requestType == firebase_fcs_request_type_download || req->requestType == firebase_fcs_request_type_download_ota)
-                {
-                    FCS_DownloadStatusInfo in;
-                    makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_fcs_download_status_complete,
-                                       100, req->fileSize, 0, "");
-                    sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
-                }
-                else if (req->requestType == firebase_fcs_request_type_upload ||
-                         req->requestType == firebase_fcs_request_type_upload_pgm_data)
+                if (req->requestType == firebase_fcs_request_type_upload ||
+                    req->requestType == firebase_fcs_request_type_upload_pgm_data)
                 {
                     FCS_UploadStatusInfo in;
                     makeUploadStatus(in, req->localFileName, req->remoteFileName, firebase_fcs_upload_status_complete,
@@ -607,7 +707,8 @@ bool FB_Storage::handleResponse(FirebaseData *fbdo, struct firebase_fcs_req_t *r
     fbdo->session.cfn.payload.clear();
 #endif
 
-    if (req->requestType == firebase_fcs_request_type_download && !fbdo->prepareDownload(req->localFileName, req->storageType, true))
+    if (req->requestType == firebase_fcs_request_type_download &&
+        !fbdo->prepareDownload(req->localFileName, req->storageType, true, req->range.offset > 0))
         return false;
 
     bool complete = false;
@@ -622,20 +723,40 @@ bool FB_Storage::handleResponse(FirebaseData *fbdo, struct firebase_fcs_req_t *r
         if (tcpHandler.pChunkIdx > 0)
         {
 
-            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.contentLen > 0 &&
+            if ((response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK || response.httpCode == FIREBASE_ERROR_HTTP_CODE_PARTIAL_CONTENT) &&
+                response.contentLen > 0 &&
                 (fbdo->session.fcs.requestType == firebase_fcs_request_type_download ||
                  fbdo->session.fcs.requestType == firebase_fcs_request_type_download_ota))
             {
 
                 tcpHandler.dataTime = millis();
-
-                req->fileSize = response.contentLen;
                 tcpHandler.error.code = 0;
 
-                FCS_DownloadStatusInfo in;
-                makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_fcs_download_status_init,
-                                   0, req->fileSize, 0, "");
-                sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
+                size_t offset = req->range.offset;
+                int range = Core.ut.setDownloadRange(req->range, response);
+
+                // the object was changed since the previous range or the partly written firmware can't be continued
+                if (range < 0 || (range == 0 && offset > 0 && isOTA))
+                {
+                    req->range.changed = true;
+                    tcpHandler.error.code = FIREBASE_ERROR_HTTP_CODE_PRECONDITION_FAILED;
+                    fbdo->session.response.code = tcpHandler.error.code;
+                    break;
+                }
+
+                // the server sent the whole object, write the file from the beginning
+                if (range == 0 && offset > 0 && !fbdo->prepareDownload(req->localFileName, req->storageType, true))
+                    break;
+
+                req->fileSize = req->range.total;
+
+                if (req->range.offset == 0)
+                {
+                    FCS_DownloadStatusInfo in;
+                    makeDownloadStatus(in, req->localFileName, req->remoteFileName, firebase_fcs_download_status_init,
+                                       0, req->fileSize, 0, "");
+                    sendDownloadCallback(fbdo, in, req->downloadCallback, req->downloadStatusInfo);
+                }
 
                 int bufLen = Core.config->fcs.download_buffer_size;
                 if (bufLen < 512)
@@ -646,28 +767,34 @@ bool FB_Storage::handleResponse(FirebaseData *fbdo, struct firebase_fcs_req_t *r
                 uint8_t *buf = reinterpret_cast<uint8_t *>(Core.mbfs.newP(bufLen, false));
 
                 int stage = 0;
+                size_t received = 0;
 
-                if (isOTA)
-                    fbdo->prepareDownloadOTA(tcpHandler, response);
+                if (isOTA && !req->range.started)
+                {
+                    fbdo->prepareDownloadOTA(tcpHandler, response, req->range.total);
+                    req->range.started = tcpHandler.error.code == 0;
+                }
 
                 while (fbdo->processDownload(req->localFileName, req->storageType, buf, bufLen, tcpHandler, response, stage, isOTA))
                 {
+                    // the buffer is written in the next call
                     if (stage)
-                        reportDownloadProgress(fbdo, req, tcpHandler.payloadRead);
+                    {
+                        req->range.crc = Core.ut.crc32c(req->range.crc, buf, tcpHandler.bufferAvailable);
+                        received += tcpHandler.bufferAvailable;
+                        reportDownloadProgress(fbdo, req, req->range.offset + received);
+                    }
                 }
 
                 Core.mbfs.delP(&buf);
 
-                if (!isOTA)
-                {
-                    if ((int)req->fileSize == tcpHandler.payloadRead)
-                        reportDownloadProgress(fbdo, req, tcpHandler.payloadRead);
-                    else
-                        tcpHandler.error.code = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
-                }
+                if (tcpHandler.error.code == 0)
+                    req->range.offset += received;
 
-                if (isOTA)
-                    fbdo->endDownloadOTA(tcpHandler);
+                if (response.contentLen == (int)received)
+                    reportDownloadProgress(fbdo, req, req->range.offset);
+                else if (tcpHandler.error.code == 0)
+                    tcpHandler.error.code = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
 
                 if (tcpHandler.error.code != 0)
                     fbdo->session.response.code = tcpHandler.error.code;
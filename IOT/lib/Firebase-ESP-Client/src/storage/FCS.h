@@ -193,6 +193,7 @@ private:
     void rescon(FirebaseData *fbdo, const char *host);
     bool fcs_connect(FirebaseData *fbdo);
     bool fcs_sendRequest(FirebaseData *fbdo, struct firebase_fcs_req_t *req);
+    bool fcs_download(FirebaseData *fbdo, struct firebase_fcs_req_t *req);
     void reportUploadProgress(FirebaseData *fbdo, struct firebase_fcs_req_t *req, size_t readBytes);
     void reportDownloadProgress(FirebaseData *fbdo, struct firebase_fcs_req_t *req, size_t readBytes);
     bool handleResponse(FirebaseData *fbdo, struct firebase_fcs_req_t *req);